@@ -53,6 +53,9 @@ int main(int argc, char* argv[])
     filename = argv[1];
     querytype = *argv[2];
 
+#ifdef USE_HP
+    mm::register_for_hp();
+#endif
     CSA_TYPE csa;
     fprintf(stderr, "# File = %s\n",(string(filename) + "." + string(SUF)).c_str());
     fprintf(stderr, "# program = %s\n",string(SUF).c_str());
@@ -53,6 +53,9 @@ int main(int argc, char* argv[])
     filename = argv[1];
     querytype = *argv[2];
 
+#ifdef USE_HP
+    mm::register_for_hp();
+#endif
     CSA_TYPE csa;
     fprintf(stderr, "Load from file %s\n",(string(filename) + "." + string(SDSL_XSTR(SUF))).c_str());
     Load_time = getTime();
@@ -28,6 +28,7 @@ int main(int argc, char** argv)
         cout << " (2) Runs a benchmark with enabled/disabled 1GB=hugepages." << endl;
         return 1;
     }
+    mm::register_for_hp(); // map_hp only moves vectors created from now on
     csa_wt<> csa;
     construct(csa, argv[1], 1);
     do_something(csa); // before it is mapped
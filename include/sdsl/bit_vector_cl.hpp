@@ -0,0 +1,431 @@
+/*!\file bit_vector_cl.hpp
+   \brief bit_vector_cl.hpp contains the sdsl::bit_vector_cl class, and
+          classes which support rank and select for bit_vector_cl.
+*/
+#ifndef SDSL_BIT_VECTOR_CL
+#define SDSL_BIT_VECTOR_CL
+
+#include "int_vector.hpp"
+#include "util.hpp"
+#include "iterators.hpp"
+
+//! Namespace for the succinct data structure library
+namespace sdsl
+{
+
+template<uint8_t t_b=1, uint32_t t_sample=512>// forward declaration needed for friend declaration
+class rank_support_cl;  // in bit_vector_cl
+
+template<uint8_t t_b=1, uint32_t t_sample=512>// forward declaration needed for friend declaration
+class select_support_cl;  // in bit_vector_cl
+
+//! A bit vector which stores bits and rank counts in the same cache line.
+/*!
+ * This class is a uncompressed bit vector representation in the spirit of
+ * rank9 and poppy. The bits are partitioned into lines of 448 bits. Each
+ * line is stored in one 64-byte aligned cache line: A header word followed
+ * by the seven data words. The header contains
+ *  - bits [0..44):  the number of set bits before the line,
+ *  - bits [44..53): the number of set bits in the first two data words,
+ *  - bits [53..62): the number of set bits in the first four data words.
+ * A rank query therefore touches exactly one cache line. For select, the line of every t_sample-th one and zero is
+ * sampled. A select query binary searches the headers between two
+ * consecutive samples and finishes inside one line.
+ *
+ * \tparam t_sample Sample rate for select. Every t_sample-th one and zero
+ *                  is sampled.
+ *
+ * \par Reference
+ *   Sebastiano Vigna: Broadword Implementation of Rank/Select Queries. WEA 2008
+ *
+ *   Dong Zhou, David G. Andersen, Michael Kaminsky: Space-Efficient,
+ *   High-Performance Rank & Select Structures on Uncompressed Bit Sequences.
+ *   SEA 2013
+ */
+template<uint32_t t_sample=512>
+class bit_vector_cl
+{
+        static_assert(t_sample > 0 , "bit_vector_cl: sample rate must be positive.");
+    public:
+        typedef bit_vector::size_type                       size_type;
+        typedef size_type                                   value_type;
+        typedef bit_vector::difference_type                 difference_type;
+        typedef random_access_const_iterator<bit_vector_cl> iterator;
+        typedef bv_tag                                      index_category;
+
+        friend class rank_support_cl<1,t_sample>;
+        friend class rank_support_cl<0,t_sample>;
+        friend class select_support_cl<1,t_sample>;
+        friend class select_support_cl<0,t_sample>;
+
+        typedef rank_support_cl<1,t_sample>     rank_1_type;
+        typedef rank_support_cl<0,t_sample>     rank_0_type;
+        typedef select_support_cl<1,t_sample> select_1_type;
+        typedef select_support_cl<0,t_sample> select_0_type;
+
+        static const size_type line_words = 8;   //!< 64-bit words per line
+        static const size_type line_bits  = 448; //!< Data bits per line
+    private:
+        static const uint64_t  rank_mask  = (1ULL<<44)-1;
+
+        size_type      m_size   = 0; //!< Size of the original bit vector
+        size_type      m_lines  = 0; //!< Number of lines
+        size_type      m_offset = 0; //!< Word offset of the first line in m_data
+        int_vector<64> m_data;       //!< Lines plus slack for the alignment
+        int_vector<>   m_select1_samples; //!< Line of every t_sample-th one
+        int_vector<>   m_select0_samples; //!< Line of every t_sample-th zero
+
+        const uint64_t* lines()const {
+            return m_data.data() + m_offset;
+        }
+
+        //! Moves the lines in m_data such that the first line starts at a 64-byte boundary.
+        void align_lines() {
+            size_type offset = ((-(uintptr_t)m_data.data()) & 63) >> 3;
+            if (offset == m_offset or m_data.size() == 0)
+                return;
+            // Moving the lines inside a private file mapping (see mm::map)
+            // would copy its pages one by one on write, so the lines are
+            // copied to the heap at once. serialize stores the lines at the
+            // alignment of the mapping, so mapped lines usually stay shared.
+            m_data.resize(m_data.size());
+            offset = ((-(uintptr_t)m_data.data()) & 63) >> 3;
+            if (offset == m_offset)
+                return;
+            size_type n = m_lines*line_words;
+            if (offset < m_offset) {
+                for (size_type i=0; i < n; ++i)
+                    m_data[offset+i] = m_data[m_offset+i];
+            } else {
+                for (size_type i=n; i > 0; --i)
+                    m_data[offset+i-1] = m_data[m_offset+i-1];
+            }
+            m_offset = offset;
+        }
+
+        void copy(const bit_vector_cl& bv) {
+            m_size   = bv.m_size;
+            m_lines  = bv.m_lines;
+            m_offset = bv.m_offset;
+            m_data   = bv.m_data;
+            m_select1_samples = bv.m_select1_samples;
+            m_select0_samples = bv.m_select0_samples;
+            align_lines();
+        }
+
+    public:
+        bit_vector_cl() {}
+        bit_vector_cl(const bit_vector_cl& bv) {
+            copy(bv);
+        }
+        bit_vector_cl(bit_vector_cl&& bv) {
+            swap(bv);
+        }
+
+        bit_vector_cl(const bit_vector& bv) {
+            m_size  = bv.size();
+            assert(m_size < (1ULL<<44));
+            // one additional line, so that rank(size()) always finds its line
+            m_lines = m_size/line_bits + 1;
+            m_data  = int_vector<64>(m_lines*line_words + line_words - 1, 0);
+            m_offset = ((-(uintptr_t)m_data.data()) & 63) >> 3;
+
+            const uint64_t* bvp = bv.data();
+            size_type words = (m_size+63)>>6;
+            size_type ones = 0;
+            for (size_type l=0, j=0; l < m_lines; ++l) {
+                size_type header = m_offset + l*line_words;
+                uint64_t cnt2 = 0, cnt4 = 0, cnt_line = 0;
+                for (size_type k=0; k < 7; ++k, ++j) {
+                    uint64_t w = 0;
+                    if (j < words) {
+                        w = bvp[j];
+                        if (j+1 == words and (m_size&63))
+                            w &= bits::lo_set[m_size&63];
+                    }
+                    m_data[header+1+k] = w;
+                    cnt_line += bits::cnt(w);
+                    if (k == 1) cnt2 = cnt_line;
+                    if (k == 3) cnt4 = cnt_line;
+                }
+                m_data[header] = ones | (cnt2 << 44) | (cnt4 << 53);
+                ones += cnt_line;
+            }
+            size_type zeros = m_size - ones;
+
+            // sample the line of every t_sample-th one and zero;
+            // the last sample is a sentinel which points to the last line
+            uint8_t width = bits::hi(m_lines)+1;
+            m_select1_samples = int_vector<>((ones+t_sample-1)/t_sample+1, 0, width);
+            m_select0_samples = int_vector<>((zeros+t_sample-1)/t_sample+1, 0, width);
+            size_type s1 = 0, s0 = 0;
+            for (size_type l=0; l < m_lines; ++l) {
+                size_type line_ones  = l+1 < m_lines ? (m_data[m_offset+(l+1)*line_words]&rank_mask) : m_select1_samples.size()*t_sample;
+                size_type line_zeros = l+1 < m_lines ? (l+1)*line_bits - line_ones : m_select0_samples.size()*t_sample;
+                // line_ones (line_zeros) is the number of ones (zeros) before line l+1
+                while (s1+1 < m_select1_samples.size() and s1*t_sample < line_ones) {
+                    m_select1_samples[s1++] = l;
+                }
+                while (s0+1 < m_select0_samples.size() and s0*t_sample < line_zeros) {
+                    m_select0_samples[s0++] = l;
+                }
+            }
+            m_select1_samples[m_select1_samples.size()-1] = m_lines-1;
+            m_select0_samples[m_select0_samples.size()-1] = m_lines-1;
+        }
+
+        //! Accessing the i-th element of the original bit_vector
+        /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
+         *  \return The i-th bit of the original bit_vector
+         *  \par Time complexity
+         *     \f$ \Order{1} \f$
+         */
+        value_type operator[](size_type i)const {
+            assert(i < m_size);
+            size_type line = i / line_bits;
+            size_type off  = i - line*line_bits;
+            return (lines()[line*line_words + 1 + (off>>6)] >> (off&63)) & 1ULL;
+        }
+
+        //! Returns the size of the original bit vector.
+        size_type size()const {
+            return m_size;
+        }
+
+        bit_vector_cl& operator=(const bit_vector_cl& bv) {
+            if (this != &bv) {
+                copy(bv);
+            }
+            return *this;
+        }
+
+        bit_vector_cl& operator=(bit_vector_cl&& bv) {
+            swap(bv);
+            return *this;
+        }
+
+        //! Serializes the data structure into the given ostream
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            // The lines are stored at the alignment they get in a mapping
+            // of the file, so that align_lines does not copy them on load.
+            size_type offset = m_offset;
+            std::streamoff pos = out.tellp();
+            if (pos >= 0) {
+                pos += 3*sizeof(size_type);
+                pos += 8 + int_vector<64>::header_padding(pos);
+                offset = ((-(uint64_t)pos) & 63) >> 3;
+            }
+            written_bytes += write_member(m_size, out, child, "size");
+            written_bytes += write_member(m_lines, out, child, "lines");
+            written_bytes += write_member(offset, out, child, "offset");
+            if (offset == m_offset) {
+                written_bytes += m_data.serialize(out, child, "data");
+            } else {
+                int_vector<64> data(m_data.size(), 0);
+                std::copy(lines(), lines()+m_lines*line_words, data.begin()+offset);
+                written_bytes += data.serialize(out, child, "data");
+            }
+            written_bytes += m_select1_samples.serialize(out, child, "select1_samples");
+            written_bytes += m_select0_samples.serialize(out, child, "select0_samples");
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+
+        //! Loads the data structure from the given istream.
+        void load(std::istream& in) {
+            read_member(m_size, in);
+            read_member(m_lines, in);
+            read_member(m_offset, in);
+            m_data.load(in);
+            m_select1_samples.load(in);
+            m_select0_samples.load(in);
+            align_lines();
+        }
+
+        void swap(bit_vector_cl& bv) {
+            if (this != &bv) {
+                std::swap(m_size, bv.m_size);
+                std::swap(m_lines, bv.m_lines);
+                std::swap(m_offset, bv.m_offset);
+                m_data.swap(bv.m_data);
+                m_select1_samples.swap(bv.m_select1_samples);
+                m_select0_samples.swap(bv.m_select0_samples);
+            }
+        }
+
+        iterator begin() const {
+            return iterator(this, 0);
+        }
+
+        iterator end() const {
+            return iterator(this, size());
+        }
+};
+
+template<uint8_t t_b, uint32_t t_sample>
+class rank_support_cl
+{
+    private:
+        static_assert(t_b == 1 or t_b == 0 , "rank_support_cl only supports bitpatterns 0 or 1.");
+    public:
+        typedef bit_vector::size_type    size_type;
+        typedef bit_vector_cl<t_sample>  bit_vector_type;
+    private:
+        const bit_vector_type* m_v;
+
+        inline size_type rank1(size_type i) const {
+            size_type line = i / bit_vector_type::line_bits;
+            size_type off  = i - line*bit_vector_type::line_bits;
+            const uint64_t* w = m_v->lines() + line*bit_vector_type::line_words;
+            uint64_t res = w[0] & bit_vector_type::rank_mask;
+            size_type d = off>>6;
+            ++w;
+            // masked counting of all data words avoids mispredicted branches
+            for (size_type k=0; k < 7; ++k) {
+                uint64_t mask = k < d ? ~0ULL : (k == d ? bits::lo_set[off&63] : 0ULL);
+                res += bits::cnt(w[k] & mask);
+            }
+            return res;
+        }
+
+    public:
+
+        rank_support_cl(const bit_vector_type* v=nullptr) {
+            set_vector(v);
+        }
+
+        //! Returns the number of t_b-bits in the prefix [0..i) of the supported bit vector.
+        size_type rank(size_type i) const {
+            if (t_b) return rank1(i);
+            return i - rank1(i);
+        }
+
+        const size_type operator()(size_type i)const {
+            return rank(i);
+        }
+
+        const size_type size()const {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=nullptr) {
+            m_v = v;
+        }
+
+        rank_support_cl& operator=(const rank_support_cl& rs) {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(rank_support_cl&) { }
+
+        void load(std::istream&, const bit_vector_type* v=nullptr) {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const {
+            return serialize_empty_object(out, v, name, this);
+        }
+};
+
+
+template<uint8_t t_b, uint32_t t_sample>
+class select_support_cl
+{
+    private:
+        static_assert(t_b == 1 or t_b == 0 , "select_support_cl only supports bitpatterns 0 or 1.");
+    public:
+        typedef bit_vector::size_type    size_type;
+        typedef bit_vector_cl<t_sample>  bit_vector_type;
+    private:
+        const bit_vector_type* m_v;
+
+        //! Number of t_b-bits before line l
+        size_type rank_line(const uint64_t* lines, size_type l)const {
+            size_type ones = lines[l*bit_vector_type::line_words] & bit_vector_type::rank_mask;
+            if (t_b) return ones;
+            return l*bit_vector_type::line_bits - ones;
+        }
+
+    public:
+
+        select_support_cl(const bit_vector_type* v=nullptr) {
+            set_vector(v);
+        }
+
+        //! Returns the position of the i-th occurrence in the bit vector.
+        size_type select(size_type i) const {
+            const uint64_t* lines = m_v->lines();
+            const int_vector<>& samples = t_b ? m_v->m_select1_samples : m_v->m_select0_samples;
+            size_type k  = (i-1)/t_sample;
+            // the i-th occurrence lies in a line of [lb..rb]
+            size_type lb = samples[k], rb = samples[k+1];
+            while (lb < rb) {
+                size_type mid = lb + (rb-lb+1)/2;
+                if (rank_line(lines, mid) < i) {
+                    lb = mid;
+                } else {
+                    rb = mid-1;
+                }
+            }
+            const uint64_t* w = lines + lb*bit_vector_type::line_words;
+            i -= rank_line(lines, lb);
+            size_type res = lb*bit_vector_type::line_bits;
+            uint64_t header = *w++;
+            uint64_t cnt4 = (header>>53) & 0x1FF;
+            uint64_t cnt2 = (header>>44) & 0x1FF;
+            if (!t_b) {
+                cnt4 = 256 - cnt4;
+                cnt2 = 128 - cnt2;
+            }
+            if (cnt4 < i) {
+                i -= cnt4; w += 4; res += 256;
+            } else if (cnt2 < i) {
+                i -= cnt2; w += 2; res += 128;
+            }
+            uint64_t x = t_b ? *w : ~*w;
+            size_type cnt;
+            while ((cnt = bits::cnt(x)) < i) {
+                i -= cnt; res += 64;
+                ++w;
+                x = t_b ? *w : ~*w;
+            }
+            return res + bits::sel(x, i);
+        }
+
+        const size_type operator()(size_type i)const {
+            return select(i);
+        }
+
+        const size_type size()const {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=nullptr) {
+            m_v = v;
+        }
+
+        select_support_cl& operator=(const select_support_cl& ss) {
+            if (this != &ss) {
+                set_vector(ss.m_v);
+            }
+            return *this;
+        }
+
+        void swap(select_support_cl&) { }
+
+        void load(std::istream&, const bit_vector_type* v=nullptr) {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const {
+            return serialize_empty_object(out, v, name, this);
+        }
+};
+
+} // end namespace sdsl
+#endif
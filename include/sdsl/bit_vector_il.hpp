@@ -237,11 +237,9 @@ class rank_support_il
             uint64_t resp = m_v->m_data[SBlockPos];
             const uint64_t* B = (m_v->m_data.data() + (SBlockPos+1));
             uint64_t rem = i&63;
-            uint64_t bits = (i&m_block_mask) - rem;
-            while (bits) {
-                resp += bits::cnt(*B++);
-                bits -= 64;
-            }
+            uint64_t words = (i&m_block_mask)>>6;
+            resp += bits::cnt(B, words);
+            B += words;
             resp += bits::cnt(*B & bits::lo_set[rem]);
             return resp;
         }
@@ -253,11 +251,9 @@ class rank_support_il
             uint64_t resp = (SBlockNum << m_block_shift) - m_v->m_data[SBlockPos];
             const uint64_t* B = (m_v->m_data.data() + (SBlockPos+1));
             uint64_t rem = i&63;
-            uint64_t bits = (i&m_block_mask) - rem;
-            while (bits) {
-                resp += bits::cnt(~(*B)); B++;
-                bits -= 64;
-            }
+            uint64_t words = (i&m_block_mask)>>6;
+            resp += (words<<6) - bits::cnt(B, words);
+            B += words;
             resp += bits::cnt((~(*B)) & bits::lo_set[rem]);
             return resp;
         }
@@ -7,6 +7,8 @@
 
 #include "int_vector.hpp"
 #include "bit_vector_il.hpp"
+#include "bit_vector_cl.hpp"
+#include "hyb_vector.hpp"
 #include "rrr_vector.hpp"
 #include "sd_vector.hpp"
 
@@ -22,11 +22,22 @@
 #define INCLUDED_SDSL_BITS
 
 #include <stdint.h> // for uint64_t uint32_t declaration
+#include <atomic>
 #include <iostream>// for cerr
 #include <cassert>
 #ifdef __SSE4_2__
 #include <xmmintrin.h>
 #endif
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+// On x86 the best popcount and select kernels are chosen at program start
+// by inspecting the CPU (see lib/bits.cpp). Define SDSL_NO_CPU_DISPATCH to
+// always use the portable kernels.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(SDSL_NO_CPU_DISPATCH)
+#define SDSL_CPU_DISPATCH
+#endif
 
 //! Namespace for the succinct data structure library.
 namespace sdsl
@@ -96,12 +107,88 @@ struct bits {
     //! Use to help to decide if a prefix sum stored in a byte overflows.
     static const uint64_t ps_overflow[65];
 
+    //! Instruction set extensions of the executing CPU.
+    /*! The flags are determined once at program start. Before that all
+     *  flags are false and the portable kernels are used.
+     */
+    struct cpu_features {
+        bool popcnt        = false; //!< Hardware popcount instruction.
+        bool bmi2          = false; //!< BMI2 instruction set with a fast `pdep`.
+        bool avx2          = false; //!< AVX2 instruction set.
+        bool avx512f       = false; //!< AVX-512 foundation instructions.
+        bool avx512_popcnt = false; //!< AVX-512 VPOPCNTDQ instructions.
+    };
+    static const cpu_features cpu;
+
+    //! Kernel type for counting set bits in a sequence of 64-bit words.
+    typedef uint64_t (*cnt_kernel_type)(const uint64_t*, uint64_t);
+
+    //! Kernel which is used by cnt(const uint64_t*, uint64_t).
+    /*! The kernels start as the portable ones and are replaced once by the
+     *  best ones for the CPU during the static initialization of the library.
+     */
+    static std::atomic<cnt_kernel_type> cnt_kernel;
+
+    //! Bitwise operations supported by combine.
+    enum bit_op {
+        op_and,    //!< a & b
+        op_or,     //!< a | b
+        op_xor,    //!< a ^ b
+        op_andnot  //!< a & ~b
+    };
+
+    //! Kernel type for combining two sequences of 64-bit words.
+    typedef uint64_t (*combine_kernel_type)(bit_op, uint64_t*, const uint64_t*, uint64_t, uint64_t*);
+
+    //! Kernel which is used by combine.
+    static std::atomic<combine_kernel_type> combine_kernel;
+
+    //! Kernel type for reading a sequence of fixed-width integers.
+    typedef void (*read_ints_kernel_type)(const uint64_t*, uint8_t, uint8_t, uint64_t, uint64_t*);
+
+    //! Kernel which is used by read_ints.
+    static std::atomic<read_ints_kernel_type> read_ints_kernel;
+
+    //! Kernel type for sel(uint64_t, uint32_t).
+    typedef uint32_t (*sel_kernel_type)(uint64_t, uint32_t);
+
+    //! Kernel which is used by sel if BMI2 is not enabled at compile time.
+    static std::atomic<sel_kernel_type> sel_kernel;
+
     //! Counts the number of set bits in x.
     /*! \param  x 64-bit word
         \return Number of set bits.
      */
     static uint64_t cnt(uint64_t x);
 
+    //! Counts the number of set bits in the n 64-bit words starting at word.
+    /*! \param word Pointer to the first word.
+        \param n    Number of words.
+        \return Number of set bits.
+        \par Uses the fastest kernel supported by the CPU (AVX-512, popcnt
+             or the portable cnt(uint64_t)).
+     */
+    static uint64_t cnt(const uint64_t* word, uint64_t n);
+
+    //! Applies a bitwise operation to the n words starting at a and b.
+    /*! \param op     The operation.
+        \param a      Pointer to the first word of the first operand, which
+                      is overwritten by the result.
+        \param b      Pointer to the first word of the second operand.
+        \param n      Number of words.
+        \param counts If not nullptr, the counts of the result are written
+                      in the layout of rank_support_v, i.e. for each block k
+                      of 512 bits counts[2k] is the number of set bits before
+                      the block and counts[2k+1] contains the 9-bit prefix
+                      counts of the words 1..7 of the block. The array must
+                      have room for 2((n>>3)+1) words.
+        \return Number of set bits in the result.
+        \par Uses the fastest kernel supported by the CPU (AVX-512, AVX2
+             or portable), so that the result and its counts are calculated
+             in one pass.
+     */
+    static uint64_t combine(bit_op op, uint64_t* a, const uint64_t* b, uint64_t n, uint64_t* counts=nullptr);
+
     //! Position of the most significant set bit the 64-bit word x
     /*! \param x 64-bit word
         \return The position (in 0..63) of the least significant set bit
@@ -169,6 +256,10 @@ struct bits {
      */
     static uint32_t sel(uint64_t x, uint32_t i);
     static uint32_t _sel(uint64_t x, uint32_t i);
+    //! sel(x, i) without `pdep`.
+    static uint32_t sel_portable(uint64_t x, uint32_t i);
+    //! sel(x, i) implemented by `pdep` and `tzcnt`; only call if cpu.bmi2 is set.
+    static uint32_t sel_bmi2(uint64_t x, uint32_t i);
 
     //! Calculates the position of the i-th rightmost 11-bit-pattern which terminates a Fibonacci coded integer in x.
     /*!	\param x 64 bit integer.
@@ -202,6 +293,29 @@ struct bits {
     //! Reads a value from a bit position in an array and moved the bit-pointer.
     static uint64_t read_int_and_move(const uint64_t*& word, uint8_t& offset, const uint8_t len=64);
 
+    //! Reads n values of len bits each, starting at a bit position in an array.
+    /*! \param word   64-bit word part of the bit pointer.
+        \param offset Offset part of the bit pointer.
+        \param len    Width of the values. \f$ len \in [1..64] \f$
+        \param n      Number of values.
+        \param out    Array of size n; out[k] is set to the k-th value.
+        \par Only the words which contain the n values are accessed. Uses
+             AVX-512 or AVX2 gathers if supported by the CPU and a
+             width-specialised loop otherwise.
+     */
+    static void read_ints(const uint64_t* word, uint8_t offset, uint8_t len, uint64_t n, uint64_t* out);
+
+    //! Writes n values of len bits each, starting at a bit position in an array.
+    /*! \param word   64-bit word part of the bit pointer.
+        \param offset Offset part of the bit pointer.
+        \param len    Width of the values. \f$ len \in [1..64] \f$
+        \param n      Number of values.
+        \param in     Array of size n; only the len lowest bits of each
+                      value are written.
+        \par Bits outside the n values are not changed.
+     */
+    static void write_ints(uint64_t* word, uint8_t offset, uint8_t len, uint64_t n, const uint64_t* in);
+
     //! Reads an unary decoded value from a bit position in an array.
     static uint64_t read_unary(const uint64_t* word, uint8_t offset=0);
 
@@ -254,6 +368,31 @@ inline uint64_t bits::cnt(uint64_t x)
 #endif
 }
 
+inline uint64_t bits::cnt(const uint64_t* word, uint64_t n)
+{
+#ifdef __SSE4_2__
+    // short sequences are faster counted inline than by a kernel call
+    if (n < 8) {
+        uint64_t res = 0;
+        for (uint64_t i=0; i < n; ++i) {
+            res += __builtin_popcountll(word[i]);
+        }
+        return res;
+    }
+#endif
+    return cnt_kernel.load(std::memory_order_relaxed)(word, n);
+}
+
+inline uint64_t bits::combine(bit_op op, uint64_t* a, const uint64_t* b, uint64_t n, uint64_t* counts)
+{
+    return combine_kernel.load(std::memory_order_relaxed)(op, a, b, n, counts);
+}
+
+inline void bits::read_ints(const uint64_t* word, uint8_t offset, uint8_t len, uint64_t n, uint64_t* out)
+{
+    read_ints_kernel.load(std::memory_order_relaxed)(word, offset, len, n, out);
+}
+
 inline uint32_t bits::cnt32(uint32_t x)
 {
     x = x-((x>>1) & 0x55555555);
@@ -316,6 +455,17 @@ inline uint64_t bits::map01(uint64_t x, uint64_t c)
 
 inline uint32_t bits::sel(uint64_t x, uint32_t i)
 {
+#ifdef __BMI2__
+    return __builtin_ctzll(_pdep_u64(1ULL<<(i-1), x));
+#elif defined(SDSL_CPU_DISPATCH)
+    return sel_kernel.load(std::memory_order_relaxed)(x, i);
+#else
+    return sel_portable(x, i);
+#endif
+}
+
+inline uint32_t bits::sel_portable(uint64_t x, uint32_t i)
+{
 #ifdef __SSE4_2__
     uint64_t s = x, b;
     s = s-((s>>1) & 0x5555555555555555ULL);
@@ -0,0 +1,87 @@
+/*!\file block_compression.hpp
+   \brief block_compression.hpp contains the block compressed file format of int_vector_buffer.
+*/
+#ifndef INCLUDED_SDSL_BLOCK_COMPRESSION
+#define INCLUDED_SDSL_BLOCK_COMPRESSION
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include <utility>
+
+namespace sdsl
+{
+
+//! Block compressed file format for int_vectors.
+/*! A file consists of
+ *    - a header of 5 words: magic, width, number of elements, number of
+ *      elements per block and the byte offset of the block index,
+ *    - the compressed blocks in the order in which they were written,
+ *    - the block index, which contains the byte offset and byte length of
+ *      each block. A block of length 0 contains only zeros.
+ *  The magic word takes the place of the bit size in the header of a plain
+ *  int_vector file, and is larger than any possible bit size.
+ *
+ *  Each block is encoded by the smallest of three codecs:
+ *    - frame of reference: the minimum and the differences to it,
+ *    - delta: the first value and the zigzag encoded differences of
+ *      consecutive values, suitable for SA and ISA like data,
+ *    - runs: pairs of value and run length, suitable for BWTs.
+ *  The variable parts are bit-packed with the maximal width of the block.
+ */
+namespace block_compression
+{
+
+const uint64_t MAGIC = 0xD5D5C0B10C000001ULL;
+const uint64_t HEADER_SIZE = 40; // bytes
+
+struct header {
+    uint64_t width        = 0;
+    uint64_t size         = 0; // in elements
+    uint64_t block_size   = 0; // in elements
+    uint64_t index_offset = 0; // in bytes, relative to the start of the header
+};
+
+typedef std::vector<std::pair<uint64_t, uint64_t>> index_type; // (offset, length) in bytes
+
+//! Writes the header at the current position of out.
+void write_header(std::ostream& out, const header& h);
+
+//! Reads the header from the current position of in.
+/*! \return False if in does not start with the magic word. The position
+ *          of in is undefined in this case.
+ */
+bool read_header(std::istream& in, header& h);
+
+//! Number of blocks of a file described by h.
+inline uint64_t blocks(const header& h)
+{
+    return h.block_size ? (h.size+h.block_size-1)/h.block_size : 0;
+}
+
+//! Reads the block index of the file starting at position begin of in.
+void read_index(std::istream& in, std::streampos begin, const header& h, index_type& index);
+
+//! Writes the block index at the current position of out.
+void write_index(std::ostream& out, const index_type& index);
+
+//! Encodes n integers.
+/*! \param in  Array of n integers.
+ *  \param n   Number of integers, \f$ n < 2^{48} \f$.
+ *  \param out Receives the encoded block; it is resized to the number of
+ *             words used.
+ */
+void encode(const uint64_t* in, uint64_t n, std::vector<uint64_t>& out);
+
+//! Decodes a block produced by encode.
+/*! \param in  Encoded block.
+ *  \param out Receives the integers; it has to provide space for
+ *             all integers of the block.
+ *  \return The number of integers in the block.
+ */
+uint64_t decode(const uint64_t* in, uint64_t* out);
+
+} // end namespace block_compression
+} // end namespace sdsl
+
+#endif
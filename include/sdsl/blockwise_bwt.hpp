@@ -0,0 +1,239 @@
+/*!\file blockwise_bwt.hpp
+   \brief blockwise_bwt.hpp contains a construction of the BWT which does not construct the suffix array.
+*/
+#ifndef INCLUDED_SDSL_BLOCKWISE_BWT
+#define INCLUDED_SDSL_BLOCKWISE_BWT
+
+#include "config.hpp"
+#include "construct_budget.hpp"
+#include "int_vector_buffer.hpp"
+#include "io.hpp"
+#include "sais.hpp"
+#include "wt_huff.hpp"
+#include "wt_int.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sdsl
+{
+
+//! BWT construction by blockwise suffix sorting
+/*! The text is split into blocks which are processed from the last to the
+ *  first one. The BWT of the tail, i.e. the suffix of the text which starts
+ *  with the current block, is built by inserting the suffixes of the block
+ *  into the BWT of the previous tail:
+ *    (1) The suffixes of the block are searched backwards in a wavelet tree
+ *        of the BWT of the previous tail. This counts for each of them the
+ *        suffixes of the tail which are smaller.
+ *    (2) The suffixes of the block are sorted among themselves.
+ *    (3) The BWT of the previous tail is streamed and the symbols which
+ *        precede the suffixes of the block are inserted at their rows.
+ *  Only the block and the wavelet tree are kept in memory and the SA is
+ *  never constructed.
+ *
+ *  \par Reference
+ *    Paolo Ferragina, Travis Gagie, Giovanni Manzini:
+ *    Lightweight Data Indexing and Compression in External Memory.
+ *    Algorithmica 63(3) (2012)
+ */
+namespace blockwise_bwt
+{
+
+//! Counts for each suffix of a block the suffixes of the tail which are smaller
+/*! \param block     The block, which is followed by the tail.
+ *  \param tail_rank Number of suffixes of the tail which are smaller than the tail.
+ *  \param tail_size Length of the tail.
+ *  \param lf        lf(r, c) returns the number of suffixes of the tail which
+ *                   are smaller than cX, where r suffixes are smaller than X.
+ *  \param smaller   Receives for each position i of the block the number of
+ *                   suffixes of the tail which are smaller than block[i..]+tail.
+ */
+template<class t_block, class t_lf>
+void count_smaller(const t_block& block, uint64_t tail_rank, uint64_t tail_size, t_lf lf, int_vector<>& smaller)
+{
+    smaller = int_vector<>(block.size(), 0, bits::hi(tail_size)+1);
+    for (uint64_t i=block.size(), r=tail_rank; i > 0; --i) {
+        r = lf(r, (uint64_t)block[i-1]);
+        smaller[i-1] = r;
+    }
+}
+
+//! Sorts the suffixes of a block which is followed by a tail
+/*! Two suffixes of the block are compared with the tail if one of them
+ *  reaches the end of the block first, and block[i..]+tail > tail decides.
+ *  So symbol c at position i is mapped to 3c+2 if block[i..]+tail > tail
+ *  and to 3c otherwise, and the end of the block to 3*tail_first+1. The
+ *  suffixes of the mapped block are sorted by SA-IS.
+ *  \param block      The block.
+ *  \param smaller    The result of count_smaller for the block.
+ *  \param tail_rank  Number of suffixes of the tail which are smaller than the tail.
+ *  \param tail_first First symbol of the tail.
+ *  \param sa         Receives the start positions of the suffixes of the block in sorted order.
+ */
+template<class t_block>
+void sort_block(const t_block& block, const int_vector<>& smaller, uint64_t tail_rank, uint64_t tail_first, int_vector<>& sa)
+{
+    const uint64_t m = block.size();
+    uint64_t max_symbol = tail_first;
+    for (uint64_t i=0; i < m; ++i) {
+        max_symbol = std::max(max_symbol, (uint64_t)block[i]);
+    }
+    if (max_symbol > (bits::lo_set[64]-2)/3) {
+        throw std::logic_error("blockwise_bwt: the symbols of the text are too large");
+    }
+    {
+        int_vector<> codes(m+2, 0, bits::hi(3*max_symbol+2)+1);
+        for (uint64_t i=0; i < m; ++i) {
+            codes[i] = 3*block[i] + 2*(smaller[i] > tail_rank);
+        }
+        codes[m] = 3*tail_first+1;
+        sais::construct_sa(sa, codes);
+    }
+    uint64_t k = 0;
+    for (uint64_t j=0; j < m+2; ++j) {
+        if (sa[j] < m) { // skip the end of the block and the 0
+            sa[k++] = sa[j];
+        }
+    }
+    sa.resize(m);
+}
+
+//! Constructs the BWT from the text without the SA
+/*! \tparam t_width  Width of the text. 0==integer alphabet, 8=byte alphabet.
+ *  \param config    Reference to cache configuration. config.threads
+ *                   threads construct the wavelet trees.
+ *  \param block_size Number of symbols of a block. If it is 0, the largest
+ *                   block size which fits into config.memory_limit is used,
+ *                   see blockwise_bwt_block_size.
+ *  \par Time complexity
+ *       \f$ \Order{n \cdot (n/b + t_{rank})} \f$ for blocks of \f$b\f$ symbols,
+ *       since the wavelet tree of the tail is rebuilt for each of the
+ *       \f$n/b\f$ blocks.
+ *  \par Space complexity
+ *       A wavelet tree of the BWT plus about \f$ 11b \f$ bytes for a byte
+ *       text, see blockwise_bwt_peak_memory.
+ *  \pre Text exist in the cache. Keys:
+ *         * constants::KEY_TEXT for t_width=8 or constants::KEY_TEXT_INT for t_width=0
+ *  \post BWT exist in the cache. Key
+ *         * constants::KEY_BWT for t_width=8 or constants::KEY_BWT_INT for t_width=0
+ */
+template<uint8_t t_width>
+void construct_bwt(cache_config& config, uint64_t block_size=0)
+{
+    static_assert(t_width == 0 or t_width == 8 , "blockwise_bwt::construct_bwt: width must be `0` for integer alphabet and `8` for byte alphabet");
+    typedef typename std::conditional<t_width == 8, wt_huff<>, wt_int<>>::type wt_type;
+    const char* KEY_TEXT = key_text_trait<t_width>::KEY_TEXT;
+    const char* KEY_BWT  = key_bwt_trait<t_width>::KEY_BWT;
+    const std::string text_file = cache_file_name(KEY_TEXT, config);
+    uint64_t n = 0;
+    uint8_t width = 8;
+    {
+        int_vector_buffer<t_width> text_buf(text_file, std::ios::in, 8);
+        n = text_buf.size();
+        width = text_buf.width();
+    }
+    if (block_size == 0) {
+        block_size = blockwise_bwt_block_size(config, n, width);
+    }
+    const uint64_t buffer_size = construct_buffer_size(config, 1000000, blockwise_bwt_peak_memory(n, width, block_size), 3);
+    int_vector_buffer<t_width> text(text_file, std::ios::in, buffer_size);
+
+    std::vector<uint64_t> symbols, counts; // the sorted symbols of the tail and their counts
+    std::vector<uint64_t> C;                // C[j] = number of symbols of the tail smaller than symbols[j]
+    std::string bwt_file;
+    uint64_t tail_rank = 0, tail_first = 0;
+    for (uint64_t end=n; end > 0;) {
+        const uint64_t begin = end - std::min(end, block_size);
+        const uint64_t m = end-begin;
+        int_vector<t_width> block(m, 0, width);
+        for (uint64_t i=0; i < m; ++i) {
+            block[i] = text[begin+i];
+        }
+        std::string next_file = tmp_file(config, "_bwt_tail");
+        int_vector_buffer<t_width> next_bwt(next_file, std::ios::out, buffer_size, width, false, config.compress_files);
+        next_bwt.access(forward_access);
+        int_vector<> sa;
+        uint64_t next_rank = 0;
+        if (end == n) {
+            // the last block ends with the 0, so it is sorted directly
+            sais::construct_sa(sa, block);
+            for (uint64_t j=0; j < m; ++j) {
+                if (sa[j] == 0) {
+                    next_rank = j;
+                }
+                next_bwt[j] = block[sa[j] > 0 ? sa[j]-1 : m-1];
+            }
+        } else {
+            int_vector<> smaller;
+            {
+                wt_type wt;
+                {
+                    int_vector_buffer<t_width> bwt_buf(bwt_file, std::ios::in, buffer_size);
+                    construct_wt(wt, bwt_buf, bwt_buf.size(), config.threads);
+                }
+                count_smaller(block, tail_rank, n-end, [&](uint64_t r, uint64_t c) -> uint64_t {
+                    uint64_t j = std::lower_bound(symbols.begin(), symbols.end(), c) - symbols.begin();
+                    bool occurs = j < symbols.size() and symbols[j] == c;
+                    return C[j] + (occurs ? wt.rank(r, c) : 0);
+                }, smaller);
+            }
+            sort_block(block, smaller, tail_rank, tail_first, sa);
+            int_vector_buffer<t_width> bwt(bwt_file, std::ios::in, buffer_size);
+            bwt.access(forward_access);
+            uint64_t r_old = 0, k = 0;
+            auto copy_old_rows = [&](uint64_t end_row) {
+                for (; r_old < end_row; ++r_old, ++k) {
+                    // the 0 precedes the previous tail, which is now preceded by the block
+                    next_bwt[k] = r_old == tail_rank ? (uint64_t)block[m-1] : (uint64_t)bwt[r_old];
+                }
+            };
+            for (uint64_t j=0; j < m; ++j) {
+                uint64_t i = sa[j];
+                copy_old_rows(smaller[i]);
+                if (i == 0) {
+                    next_rank = k;
+                }
+                next_bwt[k++] = i > 0 ? (uint64_t)block[i-1] : 0;
+            }
+            copy_old_rows(n-end);
+            bwt.close(true);
+        }
+        next_bwt.close();
+        bwt_file = next_file;
+        tail_rank = next_rank;
+        tail_first = block[0];
+        end = begin;
+
+        // add the symbols of the block to the tail, block[sa[j]] is sorted
+        std::vector<uint64_t> merged_symbols, merged_counts;
+        for (uint64_t j=0, l=0; j < symbols.size() or l < m;) {
+            uint64_t c = (l == m or (j < symbols.size() and symbols[j] < block[sa[l]])) ? symbols[j] : (uint64_t)block[sa[l]];
+            uint64_t cnt = 0;
+            if (j < symbols.size() and symbols[j] == c) {
+                cnt += counts[j++];
+            }
+            for (; l < m and block[sa[l]] == c; ++l) {
+                ++cnt;
+            }
+            merged_symbols.push_back(c);
+            merged_counts.push_back(cnt);
+        }
+        symbols.swap(merged_symbols);
+        counts.swap(merged_counts);
+        C.assign(symbols.size()+1, 0);
+        for (uint64_t j=0; j < symbols.size(); ++j) {
+            C[j+1] = C[j] + counts[j];
+        }
+    }
+    text.close();
+    sdsl::rename(bwt_file, cache_file_name(KEY_BWT, config));
+    register_cache_file(KEY_BWT, config);
+}
+
+} // end namespace blockwise_bwt
+} // end namespace sdsl
+
+#endif
@@ -11,6 +11,8 @@ namespace constants  // namespace for library constant
 {
 // size of the buffer for reading and writing data in elements (not in bytes)
 const uint64_t SDSL_BLOCK_SIZE = (uint64_t)1<<22;
+// number of queries which are prefetched ahead in batched rank and select queries
+const uint64_t SDSL_PREFETCH_DIST = 16;
 
 const char KEY_BWT[] 		= "bwt";
 const char KEY_BWT_INT[]	= "bwt_int";
@@ -36,7 +38,27 @@ struct cache_config {
     // a concatenation of PID and a unique ID inside the
     // current process.
     tMSS 		file_map;		// Files stored during the construction process.
-    cache_config(bool f_delete_files=true, std::string f_dir="./", std::string f_id="", tMSS f_file_map=tMSS());
+    bool		compress_files;	// Flag which indicates if int_vectors stored during
+    // construction are written in the block compressed
+    // format of int_vector_buffer.
+    uint64_t	memory_limit;	// Memory budget of the construction in bytes. If
+    // it is not 0, construct() selects the fastest algorithm
+    // whose estimated peak memory fits into the budget for
+    // the SA (in memory or external_sufsort), the BWT of
+    // CSAs without SA (blockwise_bwt) and the LCP array of
+    // byte texts (select_lcp_algorithm), and sizes the
+    // buffers of int_vector_buffers accordingly. The other
+    // steps, e.g. the BWT from the SA or the LCP array of
+    // integer texts, have one algorithm and only report
+    // if their estimate exceeds the budget.
+    uint32_t	threads;		// Number of threads of the construction. Steps
+    // with a parallel algorithm use it if threads > 1.
+    bool		parallel_sa;	// Flag which indicates if the suffix array is
+    // sorted by the parallel SA-IS of
+    // parallel_sufsort instead of divsufsort/SA-IS.
+    // It needs about as much memory as SA-IS and
+    // some more work, so it pays off with several threads.
+    cache_config(bool f_delete_files=true, std::string f_dir="./", std::string f_id="", tMSS f_file_map=tMSS(), bool f_compress_files=false, uint64_t f_memory_limit=0, uint32_t f_threads=1, bool f_parallel_sa=false);
 };
 
 //! Helper classes to transform width=0 and width=8 to corresponding text key
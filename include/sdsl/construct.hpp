@@ -27,6 +27,12 @@
 #include "construct_lcp.hpp"
 #include "construct_bwt.hpp"
 #include "construct_sa.hpp"
+#include "construct_profile.hpp"
+#include "construct_budget.hpp"
+#include "construct_graph.hpp"
+#include "blockwise_bwt.hpp"
+#include "construct_text.hpp"
+#include <istream>
 #include <string>
 
 namespace sdsl
@@ -85,16 +91,83 @@ void construct_im(t_index& idx, t_data data, uint8_t num_bytes=0)
 template<class t_index>
 void construct(t_index& idx, const std::string& file, cache_config& config, uint8_t num_bytes=0)
 {
+    construct_profile* profile = construct_profile::current();
+    if (profile != nullptr and profile->name().empty()) {
+        profile->name(util::class_name(idx));
+    }
     // delegate to CSA or CST construction
     typename t_index::index_category 		index_tag;
     construct(idx, file, config, num_bytes, index_tag);
 }
 
+//! Constructs an index object of type t_index for a text which is read from a source.
+/*!
+ * The text is written to the cache in one pass by a text_ingestor, so it
+ * does not have to be stored in a file first, e.g. if it is decompressed
+ * on the fly.
+ * \param idx       t_index object.  Any sdsl suffix array, suffix tree or wavelet tree.
+ * \param source    Returns the text in chunks, see text_source_type.
+ * \param config    Cache configuration.
+ * \param num_bytes The format of the chunks as for files, see text_ingestor.
+ */
+template<class t_index>
+void construct(t_index& idx, const text_source_type& source, cache_config& config, uint8_t num_bytes=1)
+{
+    construct_profile* profile = construct_profile::current();
+    if (profile != nullptr and profile->name().empty()) {
+        profile->name(util::class_name(idx));
+    }
+    typename t_index::index_category index_tag;
+    construct(idx, source, config, num_bytes, index_tag);
+}
+
+//! Constructs an index object of type t_index for a text which is read from a stream, e.g. std::cin.
+template<class t_index>
+void construct(t_index& idx, std::istream& in, cache_config& config, uint8_t num_bytes=1)
+{
+    construct(idx, istream_source(in), config, num_bytes);
+}
+
+// Specialization for CSAs and CSTs which read their text from a source
+template<class t_index, class t_index_tag>
+void construct(t_index& idx, const text_source_type& source, cache_config& config, uint8_t num_bytes, t_index_tag)
+{
+    {
+        construct_profile::phase phase("ingest");
+        text_ingestor<t_index::alphabet_category::WIDTH>
+        ingestor(key_text_trait<t_index::alphabet_category::WIDTH>::KEY_TEXT, config, num_bytes);
+        ingestor.append(source);
+        ingestor.finish();
+    }
+    // the text is cached, so there is no file to read
+    construct(idx, "", config, num_bytes);
+}
+
+// Specialization for WTs which read their text from a source
+template<class t_index>
+void construct(t_index& idx, const text_source_type& source, cache_config& config, uint8_t num_bytes, wt_tag)
+{
+    construct_profile::phase phase("wt");
+    std::string tmp_key = util::to_string(util::pid())+"_"+util::to_string(util::id());
+    {
+        text_ingestor<t_index::alphabet_category::WIDTH> ingestor(tmp_key, config, num_bytes, "stream", false);
+        ingestor.append(source);
+        ingestor.finish();
+    }
+    {
+        int_vector_buffer<t_index::alphabet_category::WIDTH> text_buf(cache_file_name(tmp_key, config));
+        t_index tmp(text_buf, text_buf.size());
+        idx.swap(tmp);
+    }
+    sdsl::remove(cache_file_name(tmp_key, config));
+    config.file_map.erase(tmp_key);
+}
+
 // Specialization for WTs
 template<class t_index>
 void construct(t_index& idx, const std::string& file, cache_config& config, uint8_t num_bytes, wt_tag)
 {
-    mm::log("wt-begin");
+    construct_profile::phase phase("wt");
     int_vector<t_index::alphabet_category::WIDTH> text;
     load_vector_from_file(text, file, num_bytes);
     std::string tmp_key = util::to_string(util::pid())+"_"+util::to_string(util::id());
@@ -107,100 +180,196 @@ void construct(t_index& idx, const std::string& file, cache_config& config, uint
         idx.swap(tmp);
     }
     sdsl::remove(tmp_file_name);
-    mm::log("wt-end");
+}
+
+//! Length and width of the cached text
+template<uint8_t t_width>
+void cached_text_size(const cache_config& config, uint64_t& n, uint8_t& width)
+{
+    int_vector_buffer<t_width> text_buf(cache_file_name(key_text_trait<t_width>::KEY_TEXT, config), std::ios::in, 8);
+    n = text_buf.size();
+    width = text_buf.width();
+}
+
+//! Estimated peak memory of a construction step for the cached text
+template<uint8_t t_width>
+uint64_t text_peak_memory(const cache_config& config, uint64_t (*peak)(uint64_t, uint8_t))
+{
+    uint64_t n = 0;
+    uint8_t text_width = 8;
+    cached_text_size<t_width>(config, n, text_width);
+    return peak(n, text_width);
+}
+
+//! Length and width of the text of construct(), which may already be cached
+template<uint8_t t_width>
+void input_text_size(const std::string& file, const cache_config& config, uint8_t num_bytes, uint64_t& n, uint8_t& width)
+{
+    if (cache_file_exists(key_text_trait<t_width>::KEY_TEXT, config)) {
+        cached_text_size<t_width>(config, n, width);
+    } else if (num_bytes == 0) {
+        int_vector_buffer<t_width> text_buf(file, std::ios::in, 8);
+        n = text_buf.size()+1;
+        width = text_buf.width();
+    } else { // an upper bound for decimal numbers (num_bytes='d')
+        n = util::file_size(file)/(num_bytes == 'd' ? 1 : num_bytes) + 1;
+        width = t_width == 8 ? 8 : (num_bytes == 'd' ? 64 : 8*num_bytes);
+    }
+}
+
+//! Checks if the BWT of an index should be constructed without the SA
+/*! This is the case if the SA does not fit into config.memory_limit, but
+ *  blockwise_bwt::construct_bwt with at most 16 blocks does.
+ *  blockwise_bwt rebuilds the wavelet tree of the tail for every block,
+ *  so it takes \f$ \Order{n^2/b} \f$ time for blocks of \f$b\f$ symbols.
+ *  The cutoff bounds this to 16 rebuilds; with a smaller budget the SA
+ *  is sorted in external memory instead, see external_sufsort.
+ */
+template<uint8_t t_width>
+bool use_blockwise_bwt(const std::string& file, const cache_config& config, uint8_t num_bytes)
+{
+    if (config.memory_limit == 0) {
+        return false;
+    }
+    uint64_t n = 0;
+    uint8_t width = 8;
+    input_text_size<t_width>(file, config, num_bytes, n, width);
+    return sa_peak_memory(n, width) > config.memory_limit
+           and blockwise_bwt_peak_memory(n, width, (n+15)/16) <= config.memory_limit;
+}
+
+//! Adds the stages text, sa and bwt to the construct_graph of an index
+/*! If blockwise is true, the bwt stage constructs the BWT without the SA
+ *  and there is no sa stage.
+ */
+template<uint8_t t_width>
+void add_bwt_stages(construct_graph& graph, const std::string& file, uint8_t num_bytes, bool blockwise=false)
+{
+    const char* KEY_TEXT = key_text_trait<t_width>::KEY_TEXT;
+    const char* KEY_BWT  = key_bwt_trait<t_width>::KEY_BWT;
+    graph.add("text", {}, {KEY_TEXT}, construct_graph::memory_type(),
+    [file, num_bytes](cache_config& config) {
+        construct_text<t_width>(file, config, num_bytes);
+    });
+    if (blockwise) {
+        graph.add("bwt", {KEY_TEXT}, {KEY_BWT},
+        [](const cache_config& config) {
+            uint64_t n = 0;
+            uint8_t text_width = 8;
+            cached_text_size<t_width>(config, n, text_width);
+            return blockwise_bwt_peak_memory(n, text_width, blockwise_bwt_block_size(config, n, text_width));
+        },
+        [](cache_config& config) {
+            blockwise_bwt::construct_bwt<t_width>(config);
+        });
+        return;
+    }
+    graph.add("sa", {KEY_TEXT}, {constants::KEY_SA},
+    [](const cache_config& config) {
+        return text_peak_memory<t_width>(config, sa_peak_memory);
+    },
+    [](cache_config& config) {
+        construct_sa<t_width>(config);
+    });
+    graph.add("bwt", {KEY_TEXT, constants::KEY_SA}, {KEY_BWT},
+    [](const cache_config& config) {
+        return text_peak_memory<t_width>(config, bwt_peak_memory);
+    },
+    [](cache_config& config) {
+        if (config.memory_limit) {
+            check_memory_limit(config, text_peak_memory<t_width>(config, bwt_peak_memory), "bwt");
+        }
+        construct_bwt<t_width>(config);
+    });
 }
 
 // Specialization for CSAs
+/* If the SA does not fit into config.memory_limit, a CSA which can be
+ * constructed without the SA gets its BWT from blockwise_bwt and samples
+ * the SA from the BWT.
+ */
 template<class t_index>
 void construct(t_index& idx, const std::string& file, cache_config& config, uint8_t num_bytes, csa_tag)
 {
     const char* KEY_TEXT = key_text_trait<t_index::alphabet_category::WIDTH>::KEY_TEXT;
     const char* KEY_BWT  = key_bwt_trait<t_index::alphabet_category::WIDTH>::KEY_BWT;
-    typedef int_vector<t_index::alphabet_category::WIDTH> text_type;
-    {
-        // (1) check, if the text is cached
-        if (!cache_file_exists(KEY_TEXT, config)) {
-            text_type text;
-            mm::log("text-begin");
-            load_vector_from_file(text, file, num_bytes);
-            if (contains_no_zero_symbol(text, file)) {
-                append_zero_symbol(text);
-                store_to_cache(text, KEY_TEXT, config);
-            }
-            load_from_cache(text, KEY_TEXT, config);
-            mm::log("text-end");
-        }
-        register_cache_file(KEY_TEXT, config);
+    const bool blockwise = construct_without_sa_trait<t_index>::value
+                           and use_blockwise_bwt<t_index::alphabet_category::WIDTH>(file, config, num_bytes);
+    construct_graph graph(config);
+    add_bwt_stages<t_index::alphabet_category::WIDTH>(graph, file, num_bytes, blockwise);
+    std::vector<std::string> inputs = {KEY_TEXT, KEY_BWT};
+    if (!blockwise) {
+        inputs.push_back(constants::KEY_SA);
     }
-    {
-        // (2) check, if the suffix array is cached
-        if (!cache_file_exists(constants::KEY_SA, config)) {
-            mm::log("sa-begin");
-            construct_sa<t_index::alphabet_category::WIDTH>(config);
-            mm::log("sa-end");
-        }
-        register_cache_file(constants::KEY_SA, config);
-        int_vector<> sa;
-        load_from_cache(sa, constants::KEY_SA, config);
-    }
-    {
-        //  (3) construct BWT
-        if (!cache_file_exists(KEY_BWT, config)) {
-            mm::log("bwt-begin");
-            construct_bwt<t_index::alphabet_category::WIDTH>(config);
-            mm::log("bwt-end");
-        }
-        register_cache_file(constants::KEY_BWT, config);
-        int_vector<t_index::alphabet_category::WIDTH> bwt;
-        load_from_cache(bwt, KEY_BWT, config);
-    }
-    {
+    graph.add("index", inputs, {}, construct_graph::memory_type(),
+    [&idx](cache_config& config) {
         t_index tmp(config);
         idx.swap(tmp);
-    }
+    });
+    graph.run();
     if (config.delete_files) {
         util::delete_all_files(config.file_map);
     }
 }
 
 // Specialization for CSTs
+/* The CSA and the LCP array are both constructed from the text, the SA
+ * and the BWT, so they run concurrently if config.threads > 1.
+ */
 template<class t_index>
 void construct(t_index& idx, const std::string& file, cache_config& config, uint8_t num_bytes, cst_tag)
 {
-    const char* KEY_TEXT = key_text_trait<t_index::alphabet_category::WIDTH>::KEY_TEXT;
-    const char* KEY_BWT  = key_bwt_trait<t_index::alphabet_category::WIDTH>::KEY_BWT;
-    csa_tag csa_t;
-    {
-        // (1) check, if the compressed suffix array is cached
-        typename t_index::csa_type csa;
-        if (!cache_file_exists(util::class_to_hash(csa), config)) {
-            cache_config csa_config(false, config.dir, config.id, config.file_map);
-            construct(csa, file, csa_config, num_bytes, csa_t);
-            config.file_map = csa_config.file_map;
-            store_to_cache(csa, util::class_to_hash(csa), config);
+    const uint8_t WIDTH = t_index::alphabet_category::WIDTH;
+    const char* KEY_TEXT = key_text_trait<WIDTH>::KEY_TEXT;
+    const char* KEY_BWT  = key_bwt_trait<WIDTH>::KEY_BWT;
+    typedef typename t_index::csa_type csa_type;
+    const std::string KEY_CSA = util::class_to_hash(csa_type());
+    construct_graph graph(config);
+    add_bwt_stages<WIDTH>(graph, file, num_bytes);
+    graph.add("csa", {KEY_TEXT, constants::KEY_SA, KEY_BWT}, {KEY_CSA},
+    [](const cache_config& config) {
+        return text_peak_memory<WIDTH>(config, csa_peak_memory);
+    },
+    [KEY_CSA](cache_config& config) {
+        csa_type csa(config);
+        store_to_cache(csa, KEY_CSA, config);
+    });
+    graph.add("lcp", {KEY_TEXT, constants::KEY_SA, KEY_BWT}, {constants::KEY_LCP},
+    [](const cache_config& config) {
+        uint64_t n = 0;
+        uint8_t text_width = 8;
+        cached_text_size<WIDTH>(config, n, text_width);
+        if (WIDTH == 8) {
+            return lcp_peak_memory(lcp_peak_memory(LCP_PHI, n) <= config.memory_limit ? LCP_PHI : LCP_SEMI_EXTERN_PHI, n);
         }
-        register_cache_file(util::class_to_hash(csa), config);
-    }
-    {
-        // (2) check, if the longest common prefix array is cached
-        register_cache_file(KEY_TEXT, config);
-        register_cache_file(KEY_BWT, config);
-        register_cache_file(constants::KEY_SA, config);
-        if (!cache_file_exists(constants::KEY_LCP, config)) {
-            mm::log("lcp-begin");
-            if (t_index::alphabet_category::WIDTH==8) {
-                construct_lcp_semi_extern_PHI(config);
-            } else {
-                construct_lcp_PHI<t_index::alphabet_category::WIDTH>(config);
+        return lcp_peak_memory(n, text_width);
+    },
+    [](cache_config& config) {
+        uint64_t n = 0;
+        uint8_t text_width = 8;
+        if (config.memory_limit) {
+            cached_text_size<WIDTH>(config, n, text_width);
+        }
+        if (WIDTH == 8) {
+            switch (select_lcp_algorithm(config, n)) {
+                case LCP_PHI:
+                    construct_lcp_PHI<8>(config);
+                    break;
+                case LCP_SEMI_EXTERN_PHI:
+                    construct_lcp_semi_extern_PHI(config);
+                    break;
             }
-            mm::log("lcp-end");
+        } else {
+            check_memory_limit(config, lcp_peak_memory(n, text_width), "lcp");
+            construct_lcp_PHI<WIDTH>(config);
         }
-        register_cache_file(constants::KEY_LCP, config);
-    }
-    {
+    });
+    graph.add("index", {KEY_CSA, constants::KEY_LCP, KEY_BWT}, {}, construct_graph::memory_type(),
+    [&idx](cache_config& config) {
         t_index tmp(config);
         tmp.swap(idx);
-    }
+    });
+    graph.run();
     if (config.delete_files) {
         util::delete_all_files(config.file_map);
     }
@@ -0,0 +1,81 @@
+/*!\file construct_budget.hpp
+   \brief construct_budget.hpp contains the peak memory estimates which select the construction algorithms for cache_config::memory_limit.
+*/
+#ifndef INCLUDED_SDSL_CONSTRUCT_BUDGET
+#define INCLUDED_SDSL_CONSTRUCT_BUDGET
+
+#include "config.hpp"
+#include <cstdint>
+
+namespace sdsl
+{
+
+//! Algorithms for the LCP array of byte texts, from the fastest to the smallest
+/*! The other byte algorithms (go, goPHI, bwt_based, bwt_based2) need at
+ *  least 1.5n bytes, i.e. more than construct_lcp_semi_extern_PHI.
+ */
+enum lcp_byte_algorithm {
+    LCP_PHI,            //!< construct_lcp_PHI<8>
+    LCP_SEMI_EXTERN_PHI //!< construct_lcp_semi_extern_PHI
+};
+
+//! Size in bytes of the buffer of an int_vector_buffer in a construction step
+/*! \param config       The memory_limit of config is distributed.
+ *  \param default_size Size which is used if there is no memory limit.
+ *  \param resident     Bytes which the step keeps in memory besides the buffers.
+ *  \param buffers      Number of int_vector_buffers of the step.
+ *  Each int_vector_buffer may hold three buffers, one for the current
+ *  block, one read ahead and one written behind. The result lies between
+ *  4 KiB and 64 MiB and is a multiple of 8.
+ */
+uint64_t construct_buffer_size(const cache_config& config, uint64_t default_size,
+                               uint64_t resident=0, uint64_t buffers=1);
+
+//! Estimated peak memory in bytes of construct_sa for a text of length n
+uint64_t sa_peak_memory(uint64_t n, uint8_t text_width);
+
+//! Estimated peak memory in bytes of parallel_sufsort::construct_sa for a text of length n
+uint64_t parallel_sa_peak_memory(uint64_t n, uint8_t text_width);
+
+//! Estimated peak memory in bytes of construct_bwt for a text of length n
+uint64_t bwt_peak_memory(uint64_t n, uint8_t text_width);
+
+//! Estimated peak memory in bytes of blockwise_bwt::construct_bwt for a text of length n
+/*! \param block_size Number of symbols of a block.
+ */
+uint64_t blockwise_bwt_peak_memory(uint64_t n, uint8_t text_width, uint64_t block_size);
+
+//! The largest block size of blockwise_bwt::construct_bwt which fits config.memory_limit
+/*! Without a memory limit the text is sorted as one block. Blocks have
+ *  at least \f$2^{16}\f$ symbols.
+ */
+uint64_t blockwise_bwt_block_size(const cache_config& config, uint64_t n, uint8_t text_width);
+
+//! Estimated peak memory in bytes of the construction of a CSA from the BWT and the SA
+/*! csa_sada keeps \f$\Psi\f$ uncompressed, csa_wt the wavelet tree of the BWT.
+ */
+uint64_t csa_peak_memory(uint64_t n, uint8_t text_width);
+
+//! Estimated peak memory in bytes of an LCP algorithm for a byte text of length n
+uint64_t lcp_peak_memory(lcp_byte_algorithm alg, uint64_t n);
+
+//! Estimated peak memory in bytes of construct_lcp_PHI for an integer text of length n
+uint64_t lcp_peak_memory(uint64_t n, uint8_t text_width);
+
+//! Estimated peak memory in bytes of construct_lcp_PHI_parallel for a text of length n
+uint64_t parallel_lcp_peak_memory(uint64_t n, uint8_t text_width);
+
+//! The fastest LCP algorithm for a byte text of length n which fits config.memory_limit
+/*! Without a memory limit construct_lcp_semi_extern_PHI is selected,
+ *  which was always used before. If no algorithm fits, the one with
+ *  the smallest estimate is selected.
+ */
+lcp_byte_algorithm select_lcp_algorithm(const cache_config& config, uint64_t n);
+
+//! Reports a construction step whose estimated peak exceeds config.memory_limit
+/*! \return False if the step does not fit into the budget.
+ */
+bool check_memory_limit(const cache_config& config, uint64_t peak, const char* step);
+
+} // end namespace sdsl
+#endif
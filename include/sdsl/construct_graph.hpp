@@ -0,0 +1,79 @@
+/*!\file construct_graph.hpp
+   \brief construct_graph.hpp contains a scheduler which runs the stages of construct() as a dependency graph.
+*/
+#ifndef INCLUDED_SDSL_CONSTRUCT_GRAPH
+#define INCLUDED_SDSL_CONSTRUCT_GRAPH
+
+#include "config.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sdsl
+{
+
+//! Runs the stages of an index construction in the order of their dependencies
+/*! Each stage reads the cache files of its input keys and writes the cache
+ *  files of its output keys. A stage is ready as soon as all its input
+ *  keys are registered in config.file_map. A stage whose output files
+ *  already exist in the cache is not run; its outputs are registered
+ *  instead. Stages whose outputs are not needed by a stage which runs are
+ *  skipped, e.g. the text and the SA are not constructed if the CSA and
+ *  the LCP array of a CST are cached.
+ *
+ *  With config.threads > 1 up to config.threads ready stages run
+ *  concurrently, as long as the sum of their memory estimates fits into
+ *  config.memory_limit. The estimate of a stage is only evaluated if there
+ *  is a memory limit, once the inputs of the stage exist. A stage which
+ *  does not fit is only started when no other stage is running. Otherwise
+ *  the stages run one after another in the order in which they were added.
+ *
+ *  Each stage gets its own copy of the config, so it may register files
+ *  without synchronization. The file_map of the copy is merged into
+ *  config.file_map when the stage has finished. Each stage is recorded
+ *  as a phase of the active construct_profile.
+ */
+class construct_graph
+{
+    public:
+        typedef std::function<void(cache_config&)>           function_type;
+        typedef std::function<uint64_t(const cache_config&)> memory_type;
+
+    private:
+        struct stage {
+            std::string              name;
+            std::vector<std::string> inputs;
+            std::vector<std::string> outputs;
+            memory_type              memory;
+            function_type            function;
+        };
+
+        cache_config&      m_config;
+        std::vector<stage> m_stages;
+
+    public:
+        explicit construct_graph(cache_config& config) : m_config(config) {}
+
+        //! Adds a stage
+        /*! \param name     Name of the phase in the construct_profile.
+         *  \param inputs   Keys which have to be registered before the stage runs.
+         *  \param outputs  Keys which the stage writes to the cache. Stages
+         *                  without outputs always run.
+         *  \param memory   Estimated peak memory of the stage in bytes or an
+         *                  empty function if the stage needs little memory.
+         *  \param function The stage.
+         */
+        void add(const std::string& name, const std::vector<std::string>& inputs,
+                 const std::vector<std::string>& outputs, memory_type memory, function_type function);
+
+        //! Runs all stages and returns when they have finished
+        /*! Rethrows the first exception of a stage. Throws std::logic_error
+         *  if an input of a stage is neither registered nor produced by
+         *  another stage.
+         */
+        void run();
+};
+
+} // end namespace sdsl
+#endif
@@ -33,6 +33,7 @@
 #include "construct_bwt.hpp"
 #include "wt_huff.hpp"
 #include "construct_lcp_helper.hpp"
+#include "construct_budget.hpp"
 
 #include <iostream>
 #include <stdexcept>
@@ -116,11 +117,70 @@ void construct_lcp_kasai(cache_config& config)
  *         \f$ \Order{n} \f$
  *  \par Space complexity
  *         \f$ n( \log \sigma + \log \n ) \f$ bits
+ *  If config.threads > 1 and the estimate of parallel_lcp_peak_memory fits
+ *  into config.memory_limit, construct_lcp_PHI_parallel is used.
  *  \par Reference
  *         Juha Kärkkäinen, Giovanni Manzini, Simon J. Puglisi:
  *         Permuted Longest-Common-Prefix Array.
  *         CPM 2009: 181-192
  */
+//! Multithreaded construct_lcp_PHI with an uncompressed PLCP array of t_idx integers
+/*! The PLCP array is calculated in config.threads chunks of the text,
+ *  each chunk starts with an LCP value of 0. The LCP array is written
+ *  out by parallel_lcp_write.
+ */
+template<uint8_t t_width, class t_idx>
+void construct_lcp_PHI_parallel(cache_config& config, int_vector_buffer<>& sa_buf)
+{
+    typedef int_vector<>::size_type size_type;
+    typedef int_vector<t_width> text_type;
+    const char* KEY_TEXT = key_text_trait<t_width>::KEY_TEXT;
+    const uint32_t threads = config.threads;
+    size_type n = sa_buf.size();
+
+//	(1) Calculate PHI (stored in array plcp)
+    std::vector<t_idx> plcp(n, 0);
+    for (size_type i=0, sai_1 = 0; i < n; ++i) {
+        size_type sai = sa_buf[i];
+        plcp[ sai ] = sai_1;
+        sai_1 = sai;
+    }
+
+//  (2) Load text from disk
+    text_type text;
+    load_from_cache(text, KEY_TEXT, config);
+
+//  (3) Calculate permuted LCP array (text order), called PLCP
+    std::vector<size_type> max_l(threads, 0);
+    const size_type chunk = (n-1+threads-1)/threads;
+    util::parallel_for(threads, [&](uint32_t t) {
+        for (size_type i=std::min(n-1, t*chunk), e=std::min(n-1, (t+1)*chunk), l=0; i < e; ++i) {
+            size_type phii = plcp[i];
+            while (text[i+l] == text[phii+l]) {
+                ++l;
+            }
+            plcp[i] = l;
+            if (l) {
+                max_l[t] = std::max(max_l[t], l);
+                --l;
+            }
+        }
+    });
+    util::clear(text);
+    uint8_t lcp_width = bits::hi(*std::max_element(max_l.begin(), max_l.end()))+1;
+
+//	(4) Transform PLCP into LCP
+    std::string lcp_file = cache_file_name(constants::KEY_LCP, config);
+    size_type buffer_size = construct_buffer_size(config, 1000000, n*sizeof(t_idx), 2); // buffer_size is a multiple of 8!
+    int_vector_buffer<> lcp_buf(lcp_file, std::ios::out, buffer_size, lcp_width, false, config.compress_files);   // open buffer for lcp
+    sa_buf.buffersize(buffer_size);
+    parallel_lcp_write(sa_buf, lcp_buf, threads, [&](size_type, size_type sai) {
+        return plcp[sai];
+    });
+    lcp_buf.close();
+    register_cache_file(constants::KEY_LCP, config);
+}
+
 template<uint8_t t_width>
 void construct_lcp_PHI(cache_config& config)
 {
@@ -137,6 +197,20 @@ void construct_lcp_PHI(cache_config& config)
         store_to_cache(lcp, constants::KEY_LCP, config);
         return;
     }
+    if (config.threads > 1) {
+        uint8_t text_width = t_width;
+        if (0 == text_width) {
+            text_width = int_vector_buffer<t_width>(cache_file_name(KEY_TEXT, config), std::ios::in, 8).width();
+        }
+        if (config.memory_limit == 0 or parallel_lcp_peak_memory(n, text_width) <= config.memory_limit) {
+            if (n < 0xFFFFFFFFULL) {
+                construct_lcp_PHI_parallel<t_width, uint32_t>(config, sa_buf);
+            } else {
+                construct_lcp_PHI_parallel<t_width, uint64_t>(config, sa_buf);
+            }
+            return;
+        }
+    }
 
 //	(1) Calculate PHI (stored in array plcp)
     int_vector<> plcp(n, 0, sa_buf.width());
@@ -168,8 +242,8 @@ void construct_lcp_PHI(cache_config& config)
 
 //	(4) Transform PLCP into LCP
     std::string lcp_file = cache_file_name(constants::KEY_LCP, config);
-    size_type buffer_size = 1000000; // buffer_size is a multiple of 8!
-    int_vector_buffer<> lcp_buf(lcp_file, std::ios::out, buffer_size, lcp_width);   // open buffer for lcp
+    size_type buffer_size = construct_buffer_size(config, 1000000, plcp.capacity()/8, 2); // buffer_size is a multiple of 8!
+    int_vector_buffer<> lcp_buf(lcp_file, std::ios::out, buffer_size, lcp_width, false, config.compress_files);   // open buffer for lcp
     lcp_buf[0] = 0;
     sa_buf.buffersize(buffer_size);
     for (size_type i=1; i < n; ++i) {
@@ -194,6 +268,9 @@ void construct_lcp_PHI(cache_config& config)
  *         \f$ \Order{n*q} \f$ implmented with \f$ q=64 \f$
  *  \par Space complexity
  *         \f$ n + \frac{n*\log{n}}{q} \f$ bytes, implmented with \f$ q=64 \f$
+ *  If config.threads > 1, the sparse PLCP array is calculated in
+ *  config.threads chunks and the LCP array is written out by
+ *  parallel_lcp_write.
  *  \par Reference
  *         Juha Kärkkäinen, Giovanni Manzini, Simon J. Puglisi:
  *         Permuted Longest-Common-Prefix Array.
@@ -2,6 +2,8 @@
 #define INCLUDED_SDSL_CONSTRUCT_LCP_HELPER
 
 #include "sdsl/int_vector.hpp"
+#include "sdsl/int_vector_buffer.hpp"
+#include "sdsl/util.hpp"
 #include <queue>
 #include <list>
 #include <vector>
@@ -82,6 +84,37 @@ void push_back_m_index(size_type_class i, uint8_t c, tLI(&m_list)[256], uint8_t
 
 void lcp_info(tMSS& file_map);
 
+//! Writes lcp[0]=0 and lcp[i]=f(sa[i-1], sa[i]) for 0<i<n to lcp_buf using threads threads
+/*! The SA is read sequentially in blocks. The values of a block are
+ *  calculated in parallel and then appended to lcp_buf, i.e. f has to be
+ *  safe to call concurrently.
+ */
+template<class t_f>
+void parallel_lcp_write(int_vector_buffer<>& sa_buf, int_vector_buffer<>& lcp_buf, uint32_t threads, t_f f)
+{
+    const uint64_t n = sa_buf.size();
+    const uint64_t block = (uint64_t)threads << 16;
+    std::vector<uint64_t> sa(block+1), lcp(block);
+    sa[block] = 0;
+    for (uint64_t b=0; b < n; b += block) {
+        const uint64_t len = std::min(n-b, block);
+        sa[0] = sa[block]; // sa[b-1]
+        for (uint64_t j=0; j < len; ++j) {
+            sa[j+1] = sa_buf[b+j];
+        }
+        const uint64_t chunk = (len+threads-1)/threads;
+        util::parallel_for(threads, [&](uint32_t t) {
+            for (uint64_t j=std::min(len, t*chunk), e=std::min(len, (t+1)*chunk); j < e; ++j) {
+                lcp[j] = (b+j == 0) ? 0 : f(sa[j], sa[j+1]);
+            }
+        });
+        for (uint64_t j=0; j < len; ++j) {
+            lcp_buf[b+j] = lcp[j];
+        }
+        sa[block] = sa[len];
+    }
+}
+
 }
 
 #endif
@@ -0,0 +1,152 @@
+/*!\file construct_profile.hpp
+   \brief construct_profile.hpp contains a profiler for the phases of the index construction.
+*/
+#ifndef INCLUDED_SDSL_CONSTRUCT_PROFILE
+#define INCLUDED_SDSL_CONSTRUCT_PROFILE
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace sdsl
+{
+
+//! Records time, memory and I/O of each phase of construct()
+/*! The phases (text, sa, bwt, lcp, wt, samples, ...) form a tree, since
+ *  e.g. the construction of a CST contains the construction of a CSA.
+ *  For each phase the profile records
+ *    - the wall time and the CPU time of the process,
+ *    - the peak resident set size of the process during the phase,
+ *    - the bytes read and written by all int_vector_buffers and by
+ *      load_from_cache and store_to_cache,
+ *    - the number of cache files which were found or missing.
+ *  Phases are only recorded in the thread which activated the profile.
+ *  Phases of other threads are recorded in their own profile and added
+ *  by append(). The peak memory, CPU time and I/O of concurrent phases
+ *  are the ones of the whole process.
+ *  To determine the peak memory of a phase the peak resident set size of
+ *  the process (VmHWM) is reset at the begin of each phase. It is not
+ *  reset while phases run concurrently (see overlap), since each reset
+ *  would erase the peak of the other phases. The peak of such a phase is
+ *  the one of the process since the last reset.
+ *
+ *  Example:
+ *  \code
+ *  construct_profile profile;
+ *  {
+ *      construct_profile::scope scope(&profile);
+ *      construct(cst, file, 1);
+ *  }
+ *  profile.write_json(std::cout);
+ *  \endcode
+ */
+class construct_profile
+{
+    public:
+        struct phase_record {
+            std::string               name;
+            double                    wall_time     = 0; // in seconds
+            double                    cpu_time      = 0; // in seconds
+            uint64_t                  peak_rss      = 0; // in bytes
+            uint64_t                  bytes_read    = 0;
+            uint64_t                  bytes_written = 0;
+            uint64_t                  cache_hits    = 0;
+            uint64_t                  cache_misses  = 0;
+            std::vector<phase_record> phases;            // nested phases
+        };
+
+        //! Records a phase during its lifetime
+        /*! Writes name-begin and name-end to the log of mm. If no profile
+         *  is active in the calling thread, nothing else is done.
+         */
+        class phase
+        {
+            private:
+                construct_profile* m_profile;
+                std::string        m_name;
+                std::chrono::steady_clock::time_point m_wall_begin;
+                double             m_cpu_begin;
+                uint64_t           m_read_begin, m_written_begin;
+                uint64_t           m_hits_begin, m_misses_begin;
+            public:
+                explicit phase(const std::string& name);
+                phase(const phase&) = delete;
+                phase& operator=(const phase&) = delete;
+                ~phase();
+        };
+
+        //! Activates a profile in the calling thread during its lifetime
+        class scope
+        {
+            private:
+                construct_profile* m_prev;
+            public:
+                explicit scope(construct_profile* profile);
+                scope(const scope&) = delete;
+                scope& operator=(const scope&) = delete;
+                ~scope();
+        };
+
+        //! Marks that phases of several threads may run concurrently during its lifetime
+        class overlap
+        {
+            public:
+                overlap();
+                overlap(const overlap&) = delete;
+                overlap& operator=(const overlap&) = delete;
+                ~overlap();
+        };
+
+    private:
+        std::string               m_name;
+        std::vector<phase_record> m_phases; // finished top level phases
+        std::vector<phase_record> m_open;   // stack of the running phases
+
+        static std::atomic<uint64_t> s_bytes_read;
+        static std::atomic<uint64_t> s_bytes_written;
+        static std::atomic<uint64_t> s_cache_hits;
+        static std::atomic<uint64_t> s_cache_misses;
+        static std::atomic<uint32_t> s_overlaps;
+
+    public:
+        //! The profile of the calling thread or nullptr
+        static construct_profile* current();
+
+        //! Name of the constructed index, see util::class_name
+        const std::string& name() const {
+            return m_name;
+        }
+        void name(const std::string& name) {
+            m_name = name;
+        }
+
+        //! The finished top level phases
+        const std::vector<phase_record>& phases() const {
+            return m_phases;
+        }
+
+        //! Appends the finished phases of other to the innermost running phase
+        /*! Used to collect the phases which were recorded by another
+         *  thread, e.g. the concurrent stages of a construct_graph.
+         */
+        void append(const construct_profile& other);
+
+        //! Writes the name and the phase tree as JSON object
+        void write_json(std::ostream& out) const;
+
+        static void count_read(uint64_t bytes) {
+            s_bytes_read.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        static void count_written(uint64_t bytes) {
+            s_bytes_written.fetch_add(bytes, std::memory_order_relaxed);
+        }
+        static void count_cache_lookup(bool hit) {
+            (hit ? s_cache_hits : s_cache_misses).fetch_add(1, std::memory_order_relaxed);
+        }
+};
+
+} // end namespace sdsl
+#endif
@@ -29,6 +29,10 @@
 #include "divsufsort64.h"
 
 #include "qsufsort.hpp"
+#include "sais.hpp"
+#include "external_sufsort.hpp"
+#include "parallel_sufsort.hpp"
+#include "construct_budget.hpp"
 
 namespace sdsl
 {
@@ -107,14 +111,20 @@ void calculate_sa(const unsigned char* c, typename int_vector<fixedIntWidth>::si
  *  \par Space complexity
  *      \f$ 5n \f$ byte for t_width=8 and input < 2GB
  *      \f$ 9n \f$ byte for t_width=8 and input > 2GB
- *      \f$ n \log \sigma \f$ bits for t_width=0
+ *      \f$ n \log \sigma \f$ bits plus \f$ 4n+8\sigma \f$ byte for t_width=0 and input < 4G symbols
  *  \pre Text exist in the cache. Keys:
  *         * constants::KEY_TEXT for t_width=8 or constants::KEY_TEXT_INT for t_width=0
  *  \post SA exist in the cache. Key
  *         * constants::KEY_SA
+ *  If config.memory_limit is set and the estimate of sa_peak_memory exceeds
+ *  it, the SA is constructed in external memory by
+ *  external_sufsort::construct_sa.
+ *  If config.parallel_sa is set, config.threads > 1 and the estimate of
+ *  parallel_sa_peak_memory fits into config.memory_limit, the SA is
+ *  constructed by parallel_sufsort::construct_sa with config.threads threads.
  *  \par Reference
  *    For t_width=8: DivSufSort (http://code.google.com/p/libdivsufsort/)
- *    For t_width=0: qsufsort (http://www.larsson.dogma.net/qsufsort.c)
+ *    For t_width=0: SA-IS, see sais.hpp
  */
 template<uint8_t t_width>
 void construct_sa(cache_config& config)
@@ -122,17 +132,35 @@ void construct_sa(cache_config& config)
     static_assert(t_width == 0 or t_width == 8 , "construct_sa: width must be `0` for integer alphabet and `8` for byte alphabet");
     const char* KEY_TEXT = key_text_trait<t_width>::KEY_TEXT;
     typedef int_vector<t_width> text_type;
+    if (config.memory_limit) {
+        uint64_t n = 0;
+        uint8_t text_width = 0;
+        {
+            int_vector_buffer<t_width> text_buf(cache_file_name(KEY_TEXT, config), std::ios::in, 8);
+            n = text_buf.size();
+            text_width = text_buf.width();
+        }
+        if (sa_peak_memory(n, text_width) > config.memory_limit) {
+            external_sufsort::construct_sa<t_width>(config);
+            return;
+        }
+    }
     text_type text;
     load_from_cache(text, KEY_TEXT, config);
-    if (t_width == 8) {
+    if (config.parallel_sa and config.threads > 1 and (config.memory_limit == 0 or
+            parallel_sa_peak_memory(text.size(), text.width()) <= config.memory_limit)) {
+        int_vector<> sa;
+        parallel_sufsort::construct_sa(sa, text, config.threads);
+        store_to_cache(sa, constants::KEY_SA, config);
+    } else if (t_width == 8) {
         // call divsufsort
         int_vector<> sa(text.size(), 0, bits::hi(text.size())+1);
         algorithm::calculate_sa((const unsigned char*)text.data(), text.size(), sa);
         store_to_cache(sa, constants::KEY_SA, config);
     } else if (t_width == 0) {
-        // call qsufsort
+        // call SA-IS
         int_vector<> sa;
-        sdsl::qsufsort::construct_sa(sa, config.file_map[KEY_TEXT].c_str(), 0);
+        sais::construct_sa(sa, text);
         store_to_cache(sa, constants::KEY_SA, config);
     } else {
         std::cerr << "Unknown alphabet type" << std::endl;
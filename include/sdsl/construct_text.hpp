@@ -0,0 +1,287 @@
+/*!\file construct_text.hpp
+   \brief construct_text.hpp contains the streaming ingestion of the text of an index into the cache.
+*/
+#ifndef INCLUDED_SDSL_CONSTRUCT_TEXT
+#define INCLUDED_SDSL_CONSTRUCT_TEXT
+
+#include "config.hpp"
+#include "construct_budget.hpp"
+#include "construct_profile.hpp"
+#include "int_vector.hpp"
+#include "int_vector_buffer.hpp"
+#include "io.hpp"
+#include "sfstream.hpp"
+#include <functional>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sdsl
+{
+
+//! Reads the next chunk of a text into buf and returns the number of bytes read, 0 at the end
+typedef std::function<uint64_t(char* buf, uint64_t size)> text_source_type;
+
+//! A text_source_type which reads a stream, e.g. std::cin
+inline text_source_type istream_source(std::istream& in)
+{
+    return [&in](char* buf, uint64_t size) -> uint64_t {
+        in.read(buf, size);
+        return in.gcount();
+    };
+}
+
+//! Writes a text to the cache in one pass while it arrives in chunks
+/*! The chunks are decoded as the files of construct(), see the parameter
+ *  num_bytes of the constructor. Each symbol is checked to be non-zero and
+ *  the length and the width of the text are tracked, so no pass over the
+ *  whole text is needed after it is written.
+ *  Only the buffer of the cache file is kept in memory. If the ingestor is
+ *  destroyed before finish() completed, the partial cache file is removed.
+ *
+ *  \tparam t_width Width of the text. 0==integer alphabet, 8=byte alphabet.
+ */
+template<uint8_t t_width>
+class text_ingestor
+{
+    private:
+        std::string                 m_key;
+        cache_config&               m_config;
+        uint8_t                     m_num_bytes;
+        std::string                 m_name;
+        bool                        m_zero_terminated;
+        int_vector_buffer<t_width>* m_buf = nullptr;
+        uint64_t                    m_size = 0;
+        uint64_t                    m_max_symbol = 0;
+        // decoder state
+        uint64_t                    m_x = 0;      // the partial symbol
+        uint64_t                    m_cur = 0;    // bytes of the partial symbol or digits of a number
+        uint64_t                    m_header = 0; // bytes of the int_vector header which are read
+        uint64_t                    m_header_size = 0;
+        uint64_t                    m_remaining = 0; // bits of a serialized int_vector which are not read
+        uint8_t                     m_header_width = 0;
+        uint8_t                     m_bits = 0;   // bits of m_x which are read from a serialized int_vector
+
+        void open(uint8_t width) {
+            const std::string file = cache_file_name(m_key, m_config);
+            m_buf = new int_vector_buffer<t_width>(file, std::ios::out, construct_buffer_size(m_config, 1000000),
+                                                   width, false, m_config.compress_files);
+        }
+
+        void decode_serialized(uint8_t byte) {
+            const uint64_t header_bytes = t_width == 0 ? 9 : 8;
+            if (m_header < header_bytes) {
+                if (m_header < 8) {
+                    m_header_size |= ((uint64_t)byte) << (8*m_header);
+                } else {
+                    m_header_width = byte;
+                }
+                if (++m_header == header_bytes) {
+                    if (m_header_size == block_compression::MAGIC) {
+                        throw std::logic_error("text_ingestor: the compressed int_vector \""+m_name+"\" can not be streamed");
+                    }
+                    if (t_width != 0) {
+                        m_header_width = t_width;
+                    } else if (m_header_width == 0 or m_header_width > 64) {
+                        throw std::logic_error("text_ingestor: \""+m_name+"\" is not a serialized int_vector");
+                    }
+                    m_remaining = m_header_size - m_header_size % m_header_width;
+                    open(m_header_width);
+                }
+                return;
+            }
+            // the values are packed into 64-bit words, so each byte extends the current word
+            for (uint8_t b=0; b < 8 and m_remaining > 0; ++b) {
+                m_x |= ((uint64_t)((byte >> b) & 1)) << m_bits;
+                --m_remaining;
+                if (++m_bits == m_header_width) {
+                    push_back(m_x);
+                    m_x = 0;
+                    m_bits = 0;
+                }
+            }
+        }
+
+        void decode(uint8_t byte) {
+            if (m_num_bytes == 0) {
+                decode_serialized(byte);
+            } else if (m_num_bytes == 'd') {
+                if (byte >= '0' and byte <= '9') {
+                    m_x = 10*m_x + (byte-'0');
+                    ++m_cur;
+                } else if (byte == ' ' or byte == '\n' or byte == '\t' or byte == '\r') {
+                    if (m_cur > 0) {
+                        push_back(m_x);
+                    }
+                    m_x = 0;
+                    m_cur = 0;
+                } else {
+                    throw std::logic_error("text_ingestor: \""+m_name+"\" contains a character which is not a digit");
+                }
+            } else {
+                m_x |= ((uint64_t)byte) << (m_cur*8);
+                if (++m_cur == m_num_bytes) {
+                    push_back(m_x);
+                    m_x = 0;
+                    m_cur = 0;
+                }
+            }
+        }
+
+    public:
+        //! Constructor
+        /*! \param key             Cache key of the text, e.g. constants::KEY_TEXT.
+         *  \param config          Cache configuration.
+         *  \param num_bytes       If 0, the chunks form a serialized int_vector.
+         *                         If 'd', they contain decimal numbers separated
+         *                         by white space. Unlike load_vector_from_file,
+         *                         which stops at the first other character, any
+         *                         other character raises a std::logic_error.
+         *                         Otherwise they are a sequence of
+         *                         `num_bytes`-byte integers as in load_vector_from_file.
+         *  \param name            Name of the text in error messages.
+         *  \param zero_terminated If true, the text must not contain a zero
+         *                         symbol and a 0 is appended by finish().
+         */
+        text_ingestor(const std::string& key, cache_config& config, uint8_t num_bytes, const std::string& name="stream",
+                      bool zero_terminated=true) :
+            m_key(key), m_config(config), m_num_bytes(num_bytes), m_name(name), m_zero_terminated(zero_terminated) {
+            if (num_bytes != 0) {
+                // decimal numbers are written with 64 bits and repacked in finish()
+                open(t_width == 8 ? 8 : (num_bytes == 'd' ? 64 : std::min(8*num_bytes, 64)));
+            }
+        }
+
+        text_ingestor(const text_ingestor&) = delete;
+        text_ingestor& operator=(const text_ingestor&) = delete;
+
+        //! Removes the cache file if the text was not finished, e.g. after an error
+        ~text_ingestor() {
+            if (m_buf != nullptr) {
+                delete m_buf;
+                sdsl::remove(cache_file_name(m_key, m_config));
+            }
+        }
+
+        //! Decodes a chunk of the text
+        void append(const char* data, uint64_t size) {
+            for (uint64_t i=0; i < size; ++i) {
+                decode((uint8_t)data[i]);
+            }
+        }
+
+        //! Appends a decoded symbol to the text
+        void push_back(uint64_t x) {
+            if (m_zero_terminated and x == 0) {
+                throw std::logic_error(std::string("Error: File \"")+m_name+"\" contains zero symbol.");
+            }
+            if (m_buf == nullptr) {
+                throw std::logic_error("text_ingestor: symbol before the int_vector header of \""+m_name+"\"");
+            }
+            m_buf->push_back(x);
+            m_max_symbol = std::max(m_max_symbol, x);
+            ++m_size;
+        }
+
+        //! Reads a source until its end
+        void append(const text_source_type& source) {
+            std::vector<char> chunk(construct_buffer_size(m_config, 1000000));
+            for (uint64_t read; (read = source(chunk.data(), chunk.size())) > 0;) {
+                append(chunk.data(), read);
+            }
+        }
+
+        //! Completes the text, closes the cache file and registers it
+        void finish() {
+            if (m_num_bytes == 'd' and m_cur > 0) { // the last number
+                push_back(m_x);
+                m_cur = 0;
+            } else if (m_num_bytes == 0 and m_buf == nullptr) {
+                throw std::logic_error("text_ingestor: \""+m_name+"\" ends in the int_vector header");
+            } else if (m_num_bytes != 0 and m_num_bytes != 'd' and m_cur > 0) {
+                throw std::logic_error("size of \""+m_name+"\" is not a multiple of "+util::to_string(m_num_bytes));
+            }
+            if (m_zero_terminated) {
+                m_buf->push_back(0);
+            }
+            const std::string file = cache_file_name(m_key, m_config);
+            m_buf->close();
+            delete m_buf;
+            m_buf = nullptr;
+            if (t_width == 0 and m_num_bytes == 'd' and width() < 64) {
+                const std::string tmp = tmp_file(m_config, "_text");
+                {
+                    int_vector_buffer<t_width> in(file, std::ios::in, construct_buffer_size(m_config, 1000000, 0, 2));
+                    int_vector_buffer<t_width> out(tmp, std::ios::out, construct_buffer_size(m_config, 1000000, 0, 2),
+                                                   width(), false, m_config.compress_files);
+                    for (uint64_t i=0; i < in.size(); ++i) {
+                        out.push_back(in[i]);
+                    }
+                }
+                sdsl::rename(tmp, file);
+            }
+            register_cache_file(m_key, m_config);
+            construct_profile::count_written(util::file_size(file));
+        }
+
+        //! Number of symbols of the text without the terminating 0
+        uint64_t size()const {
+            return m_size;
+        }
+
+        //! Bits which are needed to represent the largest symbol
+        uint8_t width()const {
+            return t_width == 8 ? 8 : (m_max_symbol == 0 ? 1 : bits::hi(m_max_symbol)+1);
+        }
+};
+
+//! Writes the text of a file to the cache in one pass
+/*! The text is checked for zero symbols and terminated by a 0, as the
+ *  text of construct(). A serialized int_vector (num_bytes=0) is read by an
+ *  int_vector_buffer, so it may also be block compressed. As with
+ *  load_vector_from_file, a file which can not be opened yields the empty text.
+ *  Decimal numbers (num_bytes='d') are decoded by text_ingestor, so a
+ *  character which is neither a digit nor white space is an error.
+ *  If the text is invalid, no cache file is left behind.
+ *  \return The number of symbols without the terminating 0.
+ */
+template<uint8_t t_width>
+uint64_t construct_text(const std::string& file, cache_config& config, uint8_t num_bytes)
+{
+    const char* KEY_TEXT = key_text_trait<t_width>::KEY_TEXT;
+    isfstream in(file);
+    if (num_bytes == 0 and in.is_open()) {
+        in.close();
+        const std::string cache_file = cache_file_name(KEY_TEXT, config);
+        int_vector_buffer<t_width> text_buf(file, std::ios::in, construct_buffer_size(config, 1000000, 0, 2));
+        try {
+            int_vector_buffer<t_width> out(cache_file, std::ios::out, construct_buffer_size(config, 1000000, 0, 2),
+                                           text_buf.width(), false, config.compress_files);
+            for (uint64_t i=0; i < text_buf.size(); ++i) {
+                uint64_t x = text_buf[i];
+                if (x == 0) {
+                    throw std::logic_error(std::string("Error: File \"")+file+"\" contains zero symbol.");
+                }
+                out.push_back(x);
+            }
+            out.push_back(0);
+        } catch (...) {
+            // a partial text would be taken for a cached one
+            sdsl::remove(cache_file);
+            throw;
+        }
+        register_cache_file(KEY_TEXT, config);
+        construct_profile::count_written(util::file_size(cache_file));
+        return text_buf.size();
+    }
+    text_ingestor<t_width> ingestor(KEY_TEXT, config, num_bytes == 0 ? 1 : num_bytes, file);
+    if (in.is_open()) {
+        ingestor.append(istream_source(in));
+    }
+    ingestor.finish();
+    return ingestor.size();
+}
+
+} // end namespace sdsl
+#endif
@@ -28,6 +28,7 @@
 #include "util.hpp"
 #include "csa_sampling_strategy.hpp"
 #include "csa_alphabet_strategy.hpp"
+#include "construct_graph.hpp"
 #include <iostream>
 #include <algorithm>
 #include <cassert>
@@ -360,51 +361,50 @@ csa_sada<t_enc_vec, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_str
     if (!cache_file_exists(key_trait<alphabet_type::int_width>::KEY_BWT, config)) {
         return;
     }
-    int_vector_buffer<alphabet_type::int_width> bwt_buf(cache_file_name(key_trait<alphabet_type::int_width>::KEY_BWT,config));
-    size_type n = bwt_buf.size();
-    mm::log("csa-alphabet-construct-begin");
+    size_type n = 0;
     {
+        construct_profile::phase phase("csa-alphabet-construct");
+        int_vector_buffer<alphabet_type::int_width> bwt_buf(cache_file_name(key_trait<alphabet_type::int_width>::KEY_BWT,config));
+        n = bwt_buf.size();
         alphabet_type tmp_alphabet(bwt_buf, n);
         m_alphabet.swap(tmp_alphabet);
     }
-    mm::log("csa-alphabet-construct-end");
-
-    int_vector<> cnt_chr(sigma, 0, bits::hi(n)+1);
-    for (typename alphabet_type::sigma_type i=0; i < sigma; ++i) {
-        cnt_chr[i] = C[i];
-    }
-    mm::log("csa-psi-begin");
-    // calculate psi
-    {
-        // TODO: move PSI construct into construct_PSI.hpp
-        int_vector<> psi(n, 0, bits::hi(n)+1);
-        for (size_type i=0; i < n; ++i) {
-            psi[ cnt_chr[ char2comp[bwt_buf[i]] ]++ ] = i;
+    // psi and the samples are independent of each other
+    construct_graph graph(config);
+    graph.add("psi", {}, {}, construct_graph::memory_type(), [this, n](cache_config& config) {
+        int_vector_buffer<alphabet_type::int_width> bwt_buf(cache_file_name(key_trait<alphabet_type::int_width>::KEY_BWT,config));
+        int_vector<> cnt_chr(sigma, 0, bits::hi(n)+1);
+        for (typename alphabet_type::sigma_type i=0; i < sigma; ++i) {
+            cnt_chr[i] = C[i];
         }
-        std::string psi_file = cache_file_name(constants::KEY_PSI, config);
-        if (!store_to_cache(psi, constants::KEY_PSI, config)) {
-            return;
+        // calculate psi
+        {
+            construct_profile::phase phase("csa-psi");
+            // TODO: move PSI construct into construct_PSI.hpp
+            int_vector<> psi(n, 0, bits::hi(n)+1);
+            for (size_type i=0; i < n; ++i) {
+                psi[ cnt_chr[ char2comp[bwt_buf[i]] ]++ ] = i;
+            }
+            if (!store_to_cache(psi, constants::KEY_PSI, config)) {
+                return;
+            }
         }
-    }
-    mm::log("csa-psi-end");
-    int_vector_buffer<> psi_buf(cache_file_name(constants::KEY_PSI, config));
-    mm::log("csa-psi-encode-begin");
-    {
-        t_enc_vec tmp_psi(psi_buf);
-        m_psi.swap(tmp_psi);
-    }
-    mm::log("csa-psi-encode-end");
-    int_vector_buffer<>  sa_buf(cache_file_name(constants::KEY_SA, config));
-    mm::log("sa-sample-begin");
-    {
+        int_vector_buffer<> psi_buf(cache_file_name(constants::KEY_PSI, config));
+        {
+            construct_profile::phase phase("csa-psi-encode");
+            t_enc_vec tmp_psi(psi_buf);
+            m_psi.swap(tmp_psi);
+        }
+    });
+    graph.add("sa-sample", {}, {}, construct_graph::memory_type(), [this](cache_config& config) {
         sa_sample_type tmp_sa_sample(config);
         m_sa_sample.swap(tmp_sa_sample);
-    }
-    mm::log("sa-sample-end");
-
-    mm::log("isa-sample-begin");
-    set_isa_samples<csa_sada>(sa_buf, m_isa_sample);
-    mm::log("isa-sample-end");
+    });
+    graph.add("isa-sample", {}, {}, construct_graph::memory_type(), [this](cache_config& config) {
+        int_vector_buffer<>  sa_buf(cache_file_name(constants::KEY_SA, config));
+        set_isa_samples<csa_sada>(sa_buf, m_isa_sample);
+    });
+    graph.run();
 }
 
 template<class t_enc_vec, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
@@ -53,11 +53,23 @@
 
 #include "int_vector.hpp"
 #include "csa_alphabet_strategy.hpp" // for key_trait
+#include <algorithm>
+#include <functional>
 #include <set>
+#include <utility>
+#include <vector>
 
 namespace sdsl
 {
 
+//! Called with (i, SA[i], BWT[i]) for a row i of the suffix array
+typedef std::function<void(uint64_t, uint64_t, uint64_t)> sa_visitor_type;
+//! Calls a sa_visitor_type once for each row of the suffix array, in any order
+/*! This replaces the cached SA if a CSA is constructed without it, see
+ *  blockwise_bwt::construct_bwt.
+ */
+typedef std::function<void(const sa_visitor_type&)>       sa_walk_type;
+
 template<class t_csa, uint8_t t_width=0>
 class _sa_order_sampling : public int_vector<t_width>
 {
@@ -92,6 +104,22 @@ class _sa_order_sampling : public int_vector<t_width>
             }
         }
 
+        //! Constructor which gets the suffix array values from a walk
+        /*
+         * \param cconfig Cache configuration.
+         * \param n       Size of the suffix array.
+         * \param walk    Visits each row of the suffix array once.
+         */
+        _sa_order_sampling(SDSL_UNUSED const cache_config& cconfig, size_type n, const sa_walk_type& walk) {
+            this->width(bits::hi(n)+1);
+            this->resize((n+sample_dens-1)/sample_dens);
+            walk([this](uint64_t i, uint64_t sa, uint64_t) {
+                if (0 == (i % sample_dens)) {
+                    (*this)[i/sample_dens] = sa;
+                }
+            });
+        }
+
         //! Determine if index i is sampled or not
         inline bool is_sampled(size_type i) const {
             return 0 == (i % sample_dens);
@@ -160,6 +188,33 @@ class _text_order_sampling : public int_vector<t_width>
             util::init_support(m_rank_marked, &m_marked);
         }
 
+        //! Constructor which gets the suffix array values from a walk
+        /*
+         * \param cconfig Cache configuration.
+         * \param n       Size of the suffix array.
+         * \param walk    Visits each row of the suffix array once.
+         */
+        _text_order_sampling(SDSL_UNUSED const cache_config& cconfig, size_type n, const sa_walk_type& walk) {
+            // rows[x/sample_dens] = row of the suffix x
+            int_vector<> rows((n+sample_dens-1)/sample_dens, 0, bits::hi(n)+1);
+            walk([&rows](uint64_t i, uint64_t sa, uint64_t) {
+                if (0 == (sa % sample_dens)) {
+                    rows[sa/sample_dens] = i;
+                }
+            });
+            bit_vector marked(n, 0);
+            for (size_type j=0; j < rows.size(); ++j) {
+                marked[rows[j]] = 1;
+            }
+            m_marked = std::move(bit_vector_type(marked));
+            util::init_support(m_rank_marked, &m_marked);
+            this->width(bits::hi(n)+1);
+            this->resize(rows.size());
+            for (size_type j=0; j < rows.size(); ++j) {
+                (*this)[m_rank_marked(rows[j])] = j*sample_dens;
+            }
+        }
+
         //! Copy constructor
         _text_order_sampling(const _text_order_sampling& st) : base_type(st) {
             m_marked = st.m_marked;
@@ -318,6 +373,39 @@ class _bwt_sampling : public int_vector<t_width>
             util::init_support(m_rank_marked, &m_marked);
         }
 
+        //! Constructor which gets the suffix array values from a walk
+        /*
+         * \param cconfig Cache configuration (SAMPLE_CHARS is expected to be cached.).
+         * \param n       Size of the suffix array.
+         * \param walk    Visits each row of the suffix array once.
+         */
+        _bwt_sampling(const cache_config& cconfig, size_type n, const sa_walk_type& walk) {
+            int_vector<> sample_char;
+            typedef typename t_csa::char_type char_type;
+            std::set<char_type> char_map;
+            if (load_from_cache(sample_char, constants::KEY_SAMPLE_CHAR,cconfig)) {
+                for (uint64_t i=0; i<sample_char.size(); ++i) {
+                    char_map.insert((char_type)sample_char[i]);
+                }
+            }
+            std::vector<std::pair<uint64_t, uint64_t>> samples; // (row, suffix)
+            walk([&](uint64_t i, uint64_t sa, uint64_t bwt) {
+                if (0 == (sa % sample_dens) or char_map.find((char_type)bwt) != char_map.end()) {
+                    samples.emplace_back(i, sa);
+                }
+            });
+            std::sort(samples.begin(), samples.end());
+            bit_vector marked(n, 0);
+            this->width(bits::hi(n)+1);
+            this->resize(samples.size());
+            for (size_type j=0; j < samples.size(); ++j) {
+                marked[samples[j].first] = 1;
+                (*this)[j] = samples[j].second;
+            }
+            util::assign(m_marked, marked);
+            util::init_support(m_rank_marked, &m_marked);
+        }
+
         //! Copy constructor
         _bwt_sampling(const _bwt_sampling& st) : base_type(st) {
             m_marked = st.m_marked;
@@ -28,6 +28,7 @@
 #include "fast_cache.hpp"
 #include "csa_sampling_strategy.hpp"
 #include "csa_alphabet_strategy.hpp"
+#include "construct_graph.hpp"
 #include <iostream>
 #include <algorithm> // for std::swap
 #include <cassert>
@@ -38,6 +39,15 @@
 namespace sdsl
 {
 
+template<class t_wt, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
+class csa_wt;
+
+//! A csa_wt gets its samples from its wavelet tree if the SA is not cached
+template<class t_wt, uint32_t t_dens, uint32_t t_inv_dens, class t_sa_sample_strat, class t_isa, class t_alphabet_strat>
+struct construct_without_sa_trait<csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat>> {
+    enum {value = true};
+};
+
 template<class t_csa>
 class psi_of_csa_wt;  // forward declaration of PSI-array class
 
@@ -273,33 +283,53 @@ csa_wt<t_wt, t_dens, t_inv_dens, t_sa_sample_strat, t_isa, t_alphabet_strat>::cs
     if (!cache_file_exists(key_trait<alphabet_type::int_width>::KEY_BWT, config)) {
         return;
     }
-    int_vector_buffer<alphabet_type::int_width> bwt_buf(cache_file_name(key_trait<alphabet_type::int_width>::KEY_BWT,config));
-    int_vector_buffer<>  sa_buf(cache_file_name(constants::KEY_SA, config));
-    size_type n = bwt_buf.size();
-    mm::log("csa-alphabet-construct-begin");
     {
-        alphabet_type tmp_alphabet(bwt_buf, n);
+        construct_profile::phase phase("csa-alphabet-construct");
+        int_vector_buffer<alphabet_type::int_width> bwt_buf(cache_file_name(key_trait<alphabet_type::int_width>::KEY_BWT,config));
+        alphabet_type tmp_alphabet(bwt_buf, bwt_buf.size());
         m_alphabet.swap(tmp_alphabet);
     }
-    mm::log("csa-alphabet-construct-end");
-
-    mm::log("wt-begin");
-    {
-        wavelet_tree_type tmp_wt(bwt_buf, n);
-        m_wavelet_tree.swap(tmp_wt);
+    // the wavelet tree and the samples are independent of each other
+    construct_graph graph(config);
+    graph.add("wt", {}, {}, construct_graph::memory_type(), [this](cache_config& config) {
+        int_vector_buffer<alphabet_type::int_width> bwt_buf(cache_file_name(key_trait<alphabet_type::int_width>::KEY_BWT,config));
+        construct_wt(m_wavelet_tree, bwt_buf, bwt_buf.size(), config.threads);
+    });
+    if (!cache_file_exists(constants::KEY_SA, config)) {
+        // without the SA the samples are taken from a walk with LF over the text
+        graph.run();
+        construct_profile::phase phase("sa-sample");
+        const size_type n = m_wavelet_tree.size();
+        sa_walk_type lf_walk = [this, n](const sa_visitor_type& visit) {
+            for (size_type k=n, i=0; k > 0; --k) { // row i contains suffix k-1
+                typename t_wt::value_type c;
+                size_type r = m_wavelet_tree.inverse_select(i, c);
+                visit(i, k-1, c);
+                i = m_alphabet.C[m_alphabet.char2comp[c]] + r;
+            }
+        };
+        // one walk sets the SA and the ISA samples
+        sa_walk_type walk = [&](const sa_visitor_type& visit) {
+            set_isa_samples<csa_wt>(n, [&](const sa_visitor_type& isa_visit) {
+                lf_walk([&](uint64_t i, uint64_t sa, uint64_t c) {
+                    visit(i, sa, c);
+                    isa_visit(i, sa, c);
+                });
+            }, m_isa_sample);
+        };
+        sa_sample_type tmp_sa_sample(config, n, walk);
+        m_sa_sample.swap(tmp_sa_sample);
+        return;
     }
-    mm::log("wt-end");
-
-    mm::log("sa-sample-begin");
-    {
+    graph.add("sa-sample", {}, {}, construct_graph::memory_type(), [this](cache_config& config) {
         sa_sample_type tmp_sa_sample(config);
         m_sa_sample.swap(tmp_sa_sample);
-    }
-    mm::log("sa-sample-end");
-
-    mm::log("isa-sample-begin");
-    set_isa_samples<csa_wt>(sa_buf, m_isa_sample);
-    mm::log("isa-sample-end");
+    });
+    graph.add("isa-sample", {}, {}, construct_graph::memory_type(), [this](cache_config& config) {
+        int_vector_buffer<>  sa_buf(cache_file_name(constants::KEY_SA, config));
+        set_isa_samples<csa_wt>(sa_buf, m_isa_sample);
+    });
+    graph.run();
 }
 
 
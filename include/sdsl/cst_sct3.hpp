@@ -1076,24 +1076,26 @@ class cst_sct3
 template<class t_csa, class t_lcp, class t_bp_support, class t_rank>
 cst_sct3<t_csa, t_lcp, t_bp_support, t_rank>::cst_sct3(cache_config& config, bool build_only_bps)
 {
-    mm::log("bps-sct-begin");
-    int_vector_buffer<> lcp_buf(cache_file_name(constants::KEY_LCP, config));
-    m_nodes = construct_supercartesian_tree_bp_succinct_and_first_child(lcp_buf, m_bp, m_first_child) + m_bp.size()/2;
-    if (m_bp.size() == 2) {  // handle special case, when the tree consists only of the root node
-        m_nodes = 1;
+    {
+        construct_profile::phase phase("bps-sct");
+        int_vector_buffer<> lcp_buf(cache_file_name(constants::KEY_LCP, config));
+        lcp_buf.access(forward_access);
+        m_nodes = construct_supercartesian_tree_bp_succinct_and_first_child(lcp_buf, m_bp, m_first_child) + m_bp.size()/2;
+        if (m_bp.size() == 2) {  // handle special case, when the tree consists only of the root node
+            m_nodes = 1;
+        }
+    }
+    {
+        construct_profile::phase phase("bpss-sct");
+        util::init_support(m_bp_support, &m_bp);
+        util::init_support(m_first_child_rank, &m_first_child);
     }
-    mm::log("bps-sct-end");
-    mm::log("bpss-sct-begin");
-    util::init_support(m_bp_support, &m_bp);
-    util::init_support(m_first_child_rank, &m_first_child);
-    mm::log("bpss-sct-end");
 
     if (!build_only_bps) {
-        mm::log("clcp-begin");
-        cache_config tmp_config(false, config.dir, config.id, config.file_map);
+        construct_profile::phase phase("clcp");
+        cache_config tmp_config(false, config.dir, config.id, config.file_map, config.compress_files, config.memory_limit, config.threads, config.parallel_sa);
         construct_lcp(m_lcp, *this, tmp_config);
         config.file_map = tmp_config.file_map;
-        mm::log("clcp-end");
     }
     if (!build_only_bps) {
         load_from_cache(m_csa, util::class_to_hash(m_csa), config);
@@ -0,0 +1,302 @@
+/*!\file external_sufsort.hpp
+   \brief external_sufsort.hpp contains a suffix array construction in external memory.
+*/
+#ifndef INCLUDED_SDSL_EXTERNAL_SUFSORT
+#define INCLUDED_SDSL_EXTERNAL_SUFSORT
+
+#include "config.hpp"
+#include "construct_budget.hpp"
+#include "int_vector_buffer.hpp"
+#include "io.hpp"
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+namespace sdsl
+{
+
+//! Suffix sorting in external memory by prefix doubling
+/*! The text, the names of the suffixes and the suffix array are only
+ *  streamed through int_vector_buffers. In each round the suffixes are
+ *  sorted by the names of their prefixes of length h and 2h with an
+ *  external sort, i.e. the memory needed is independent of the text length.
+ *
+ *  \par I/O volume
+ *       \f$ \Order{n \log_k(n/M)} \f$ words in each of the
+ *       \f$ \log(\mbox{max. LCP}) \f$ rounds, where \f$M\f$ is the
+ *       memory and \f$k\f$ the fan-in of the merge, see record_sorter.
+ *  \par Reference
+ *    Roman Dementiev, Juha Kärkkäinen, Jens Mehnert, Peter Sanders:
+ *    Better external memory suffix array construction.
+ *    ACM Journal of Experimental Algorithmics 12 (2008)
+ */
+namespace external_sufsort
+{
+
+//! Sorts records of t_arity integers lexicographically in external memory
+/*! The records are collected in runs which fill half of the memory. Each
+ *  full run is sorted and written to a temporary file. merge() merges the
+ *  runs with the other half of the memory as buffers. At most fan_in()
+ *  runs are open at the same time, so if there are more, groups of
+ *  fan_in() runs are merged into longer runs in additional passes first.
+ */
+template<uint8_t t_arity>
+class record_sorter
+{
+    public:
+        typedef std::array<uint64_t, t_arity> record_type;
+
+    private:
+        const cache_config&      m_config;
+        uint8_t                  m_width;  // bits per integer in the run files
+        uint64_t                 m_memory; // bytes for the runs and the merge buffers
+        std::vector<record_type> m_run;
+        std::vector<std::string> m_files;
+
+        void write_run() {
+            std::sort(m_run.begin(), m_run.end());
+            std::string file = tmp_file(m_config, "_esa_run");
+            int_vector_buffer<> buf(file, std::ios::out, merge_buffer_size(1), m_width);
+            for (const record_type& r : m_run) {
+                for (uint64_t x : r) {
+                    buf.push_back(x);
+                }
+            }
+            buf.close();
+            m_files.push_back(file);
+            m_run.clear();
+        }
+
+        uint64_t run_capacity() const {
+            return std::max(m_memory/(2*sizeof(record_type)), (uint64_t)1024);
+        }
+
+        static const uint64_t MIN_BUFFER_SIZE = 1ULL<<12;
+        static const uint64_t MAX_FAN_IN      = 256; // bounds the open files
+
+        uint64_t merge_buffer_size(uint64_t runs) const {
+            const uint64_t max_size = 1ULL<<23;
+            uint64_t size = m_memory/(2*3*std::max(runs, (uint64_t)1));
+            return std::min(std::max(size, (uint64_t)MIN_BUFFER_SIZE), max_size) & ~7ULL;
+        }
+
+        // k-way merge of the runs files[begin..end), which are removed
+        template<class t_f>
+        void merge_runs(uint64_t begin, uint64_t end, t_f f) {
+            const uint64_t k = end-begin;
+            std::vector<int_vector_buffer<>> runs;
+            std::vector<uint64_t> pos(k, 0);
+            runs.reserve(k);
+            for (uint64_t j=begin; j < end; ++j) {
+                // one more buffer for the output of an intermediate pass
+                runs.emplace_back(m_files[j], std::ios::in, merge_buffer_size(k+1));
+            }
+            typedef std::pair<record_type, uint64_t> entry_type; // (record, run)
+            std::priority_queue<entry_type, std::vector<entry_type>, std::greater<entry_type>> heap;
+            auto next = [&](uint64_t j) {
+                if (pos[j] < runs[j].size()) {
+                    record_type r;
+                    for (uint8_t a=0; a < t_arity; ++a) {
+                        r[a] = runs[j][pos[j]++];
+                    }
+                    heap.emplace(r, j);
+                }
+            };
+            for (uint64_t j=0; j < k; ++j) {
+                next(j);
+            }
+            while (!heap.empty()) {
+                entry_type e = heap.top();
+                heap.pop();
+                f(e.first);
+                next(e.second);
+            }
+            for (auto& run : runs) {
+                run.close(true);
+            }
+        }
+
+    public:
+        //! Constructor
+        /*! \param config Determines the directory of the temporary files.
+         *  \param width  Bits of the largest integer of a record.
+         *  \param memory Bytes which the sorter may use.
+         *  \param size   Expected number of records.
+         */
+        record_sorter(const cache_config& config, uint8_t width, uint64_t memory, uint64_t size) :
+            m_config(config), m_width(width), m_memory(memory) {
+            m_run.reserve(std::min(run_capacity(), size));
+        }
+
+        //! Maximal number of runs which are merged at the same time
+        /*! Each run needs three buffers of at least 4 KiB and one open
+         *  file, so the fan-in is bounded by the memory and by MAX_FAN_IN.
+         */
+        uint64_t fan_in() const {
+            return std::min(std::max(m_memory/(2*3*MIN_BUFFER_SIZE), (uint64_t)2), (uint64_t)MAX_FAN_IN);
+        }
+
+        record_sorter(const record_sorter&) = delete;
+        record_sorter& operator=(const record_sorter&) = delete;
+
+        ~record_sorter() {
+            clear();
+        }
+
+        void push(const record_type& r) {
+            if (m_run.size() == run_capacity()) {
+                write_run();
+            }
+            m_run.push_back(r);
+        }
+
+        //! Removes all records
+        void clear() {
+            m_run.clear();
+            for (const std::string& file : m_files) {
+                sdsl::remove(file);
+            }
+            m_files.clear();
+        }
+
+        //! Calls f for each record in sorted order and removes the records
+        template<class t_f>
+        void merge(t_f f) {
+            if (m_files.empty()) { // all records fit into memory
+                std::sort(m_run.begin(), m_run.end());
+                for (const record_type& r : m_run) {
+                    f(r);
+                }
+                m_run.clear();
+                return;
+            }
+            if (!m_run.empty()) {
+                write_run();
+            }
+            std::vector<record_type>().swap(m_run);
+            // merge groups of fan_in() runs until one pass is left
+            while (m_files.size() > fan_in()) {
+                std::vector<std::string> merged;
+                for (uint64_t begin=0; begin < m_files.size(); begin += fan_in()) {
+                    uint64_t end = std::min(begin+fan_in(), (uint64_t)m_files.size());
+                    if (end-begin == 1) {
+                        merged.push_back(m_files[begin]);
+                        continue;
+                    }
+                    std::string file = tmp_file(m_config, "_esa_run");
+                    {
+                        int_vector_buffer<> buf(file, std::ios::out, merge_buffer_size(end-begin+1), m_width);
+                        merge_runs(begin, end, [&](const record_type& r) {
+                            for (uint64_t x : r) {
+                                buf.push_back(x);
+                            }
+                        });
+                    }
+                    merged.push_back(file);
+                }
+                m_files.swap(merged);
+            }
+            merge_runs(0, m_files.size(), f);
+            m_files.clear();
+            m_run.reserve(run_capacity());
+        }
+};
+
+//! Names the records in sorted order by the rank of their group
+/*! A group consists of the records which are equal except for the last
+ *  integer, which is the text position. The positions are written in
+ *  sorted order to sa and the pairs (position, name) are pushed to by_pos.
+ *  \return The number of groups.
+ */
+template<uint8_t t_arity>
+uint64_t name_groups(record_sorter<t_arity>& sorted, int_vector_buffer<>& sa, record_sorter<2>& by_pos)
+{
+    typedef typename record_sorter<t_arity>::record_type record_type;
+    uint64_t j = 0, groups = 0, name = 0;
+    record_type prev;
+    sorted.merge([&](const record_type& r) {
+        if (j == 0 or !std::equal(r.begin(), r.end()-1, prev.begin())) {
+            ++groups;
+            name = j+1;
+        }
+        prev = r;
+        sa[j++] = r[t_arity-1];
+        by_pos.push({{r[t_arity-1], name}});
+    });
+    return groups;
+}
+
+//! Constructs the suffix array in external memory
+/*! \tparam t_width Width of the text. 0==integer alphabet, 8=byte alphabet.
+ *  \param config   The memory of the construction is config.memory_limit,
+ *                  or 1 GiB if it is not set.
+ *  \pre Text exist in the cache and ends with a unique 0. Keys:
+ *         * constants::KEY_TEXT for t_width=8 or constants::KEY_TEXT_INT for t_width=0
+ *  \post SA exist in the cache. Key
+ *         * constants::KEY_SA
+ */
+template<uint8_t t_width>
+void construct_sa(cache_config& config)
+{
+    const char* KEY_TEXT = key_text_trait<t_width>::KEY_TEXT;
+    const uint64_t memory = config.memory_limit ? config.memory_limit : 1ULL<<30;
+    // two sorters are active at the same time, the rest is used for the streams
+    const uint64_t sorter_memory = memory/4;
+    const uint64_t buffer_size = construct_buffer_size(config, 1ULL<<20, memory/2, 3);
+
+    int_vector_buffer<t_width> text(cache_file_name(KEY_TEXT, config), std::ios::in, buffer_size);
+    const uint64_t n = text.size();
+    const uint8_t w = bits::hi(std::max(n, (uint64_t)1))+1; // width of positions and names
+    int_vector_buffer<> sa(cache_file_name(constants::KEY_SA, config), std::ios::out, buffer_size, w);
+
+    // (1) sort the suffixes by their first k symbols
+    const uint8_t tw = text.width();
+    const uint64_t k = std::max(1, 64/tw);
+    record_sorter<2> by_pos(config, w, sorter_memory, n);
+    uint64_t groups = 0;
+    {
+        record_sorter<2> by_key(config, std::max((uint64_t)w, k*tw), sorter_memory, n);
+        const uint64_t mask = bits::lo_set[k*tw];
+        uint64_t key = 0; // symbols i..i+k-1, the text is read once in order
+        for (uint64_t i=0; i+1 < k+n; ++i) {
+            key = (((key << 1) << (tw-1)) | (i < n ? (uint64_t)text[i] : 0)) & mask;
+            if (i+1 >= k) {
+                by_key.push({{key, i+1-k}});
+            }
+        }
+        text.close();
+        groups = name_groups(by_key, sa, by_pos);
+    }
+
+    // (2) double the sorted prefix length until all names are unique
+    for (uint64_t h=k; groups < n; h*=2) {
+        std::string names_file = tmp_file(config, "_esa_names");
+        {
+            int_vector_buffer<> names(names_file, std::ios::out, buffer_size, w);
+            by_pos.merge([&](const record_sorter<2>::record_type& r) {
+                names.push_back(r[1]);
+            });
+        }
+        record_sorter<3> by_pair(config, w, sorter_memory, n);
+        {
+            int_vector_buffer<> names(names_file, std::ios::in, buffer_size);
+            int_vector_buffer<> ahead(names_file, std::ios::in, buffer_size);
+            for (uint64_t i=0; i < n; ++i) {
+                by_pair.push({{names[i], i+h < n ? (uint64_t)ahead[i+h] : 0, i}});
+            }
+            ahead.close();
+            names.close(true);
+        }
+        groups = name_groups(by_pair, sa, by_pos);
+    }
+    by_pos.clear();
+    sa.close();
+}
+
+} // end namespace external_sufsort
+} // end namespace sdsl
+
+#endif
@@ -0,0 +1,633 @@
+/*!\file hyb_vector.hpp
+   \brief hyb_vector.hpp contains the sdsl::hyb_vector class, and
+          classes which support rank and select for hyb_vector.
+*/
+#ifndef INCLUDED_SDSL_HYB_VECTOR
+#define INCLUDED_SDSL_HYB_VECTOR
+
+#include "int_vector.hpp"
+#include "util.hpp"
+#include "iterators.hpp"
+#include <algorithm>
+
+//! Namespace for the succinct data structure library
+namespace sdsl
+{
+
+template<uint8_t t_b=1, uint32_t t_sblock_rate=16>// forward declaration needed for friend declaration
+class rank_support_hyb;  // in hyb_vector
+
+template<uint8_t t_b=1, uint32_t t_sblock_rate=16>// forward declaration needed for friend declaration
+class select_support_hyb;  // in hyb_vector
+
+//! A hybrid bit vector, which chooses the smallest encoding for each block.
+/*!
+ * The bit vector is partitioned into blocks of 256 bits. Each block is
+ * stored in the smallest of the following encodings:
+ *  - constant: a block consisting only of zeros or only of ones takes no space,
+ *  - raw: the 256 bits,
+ *  - minority: the Elias-Fano coded positions of the less frequent bit,
+ *  - runs: the Elias-Fano coded positions where a new run starts, preceded
+ *          by their number (8 bits) and the first bit of the block.
+ * The encodings are concatenated in one bit_vector. For every block a
+ * 32-bit word stores the type of the encoding, and the number of set bits
+ * and the offset of the encoding relative to the superblock, which consists
+ * of t_sblock_rate blocks. For each superblock the absolute number of set
+ * bits and the absolute offset are stored.
+ *
+ * \tparam t_sblock_rate Number of blocks per superblock.
+ *
+ * \par Reference
+ *   Juha Kärkkäinen, Dominik Kempa, Simon J. Puglisi:
+ *   Hybrid Compression of Bitvectors for the FM-Index.
+ *   DCC 2014
+ */
+template<uint32_t t_sblock_rate=16>
+class hyb_vector
+{
+        static_assert(t_sblock_rate > 0 and t_sblock_rate <= 16 , "hyb_vector: superblock rate must be in [1..16].");
+    public:
+        typedef bit_vector::size_type                    size_type;
+        typedef bit_vector::value_type                   value_type;
+        typedef bit_vector::difference_type              difference_type;
+        typedef random_access_const_iterator<hyb_vector> iterator;
+        typedef bv_tag                                   index_category;
+
+        friend class rank_support_hyb<1,t_sblock_rate>;
+        friend class rank_support_hyb<0,t_sblock_rate>;
+        friend class select_support_hyb<1,t_sblock_rate>;
+        friend class select_support_hyb<0,t_sblock_rate>;
+
+        typedef rank_support_hyb<1,t_sblock_rate>     rank_1_type;
+        typedef rank_support_hyb<0,t_sblock_rate>     rank_0_type;
+        typedef select_support_hyb<1,t_sblock_rate> select_1_type;
+        typedef select_support_hyb<0,t_sblock_rate> select_0_type;
+
+        enum { block_size = 256 };
+    private:
+        enum { CONST = 0, RAW = 1, MINORITY = 2, RUNS = 3 };
+
+        size_type      m_size = 0; // Size of the original bit_vector.
+        bit_vector     m_data;     // Concatenated encodings of the blocks.
+        int_vector<32> m_block;    // Per block: bits [0..2) type, bits [2..14) set bits
+        // before the block in the superblock, bits [14..26) offset in the superblock.
+        int_vector<64> m_sblock;   // Per superblock: set bits before it and offset in m_data.
+
+        void copy(const hyb_vector& v) {
+            m_size   = v.m_size;
+            m_data   = v.m_data;
+            m_block  = v.m_block;
+            m_sblock = v.m_sblock;
+        }
+
+        uint8_t block_type(size_type j)const {
+            return m_block[j] & 0x3;
+        }
+
+        // Number of set bits before block j
+        size_type block_rank(size_type j)const {
+            return m_sblock[2*(j/t_sblock_rate)] + ((m_block[j] >> 2) & 0xFFF);
+        }
+
+        // Offset of the encoding of block j in m_data
+        size_type block_pos(size_type j)const {
+            return m_sblock[2*(j/t_sblock_rate)+1] + (m_block[j] >> 14);
+        }
+
+        // Number of set bits in block j
+        uint16_t block_pop(size_type j)const {
+            return block_rank(j+1) - block_rank(j);
+        }
+
+        //! Width of the low part of an Elias-Fano coded sequence of c>0 elements from [0..256)
+        static uint8_t ef_width(uint16_t c) {
+            return bits::hi(block_size/c);
+        }
+
+        //! Size of an Elias-Fano coded sequence of c>0 elements from [0..256)
+        static uint16_t ef_size(uint16_t c) {
+            uint8_t l = ef_width(c);
+            return c*(l+1) + (block_size>>l);
+        }
+
+        static void ef_encode(bit_vector& bv, size_type pos, const uint16_t* x, uint16_t c) {
+            uint8_t l = ef_width(c);
+            for (uint16_t k=0; k < c; ++k) {
+                if (l)
+                    bv.set_int(pos + k*l, x[k] & bits::lo_set[l], l);
+                bv[pos + c*l + (x[k]>>l) + k] = 1;
+            }
+        }
+
+        // Position of the i-th one (zero for t_b=0) in m_data[p..p+len)
+        template<uint8_t t_b>
+        uint16_t select_bits(size_type p, uint16_t len, uint16_t i)const {
+            for (uint16_t q=0; q < len; q += 64) {
+                uint8_t w_len = std::min(64, len-q);
+                uint64_t w = m_data.get_int(p+q, w_len);
+                if (!t_b)
+                    w = ~w & bits::lo_set[w_len];
+                uint16_t cnt = bits::cnt(w);
+                if (cnt >= i)
+                    return q + bits::sel(w, i);
+                i -= cnt;
+            }
+            return len;
+        }
+
+        uint16_t ef_low(size_type pos, uint8_t l, uint16_t k)const {
+            return l ? m_data.get_int(pos + k*l, l) : 0;
+        }
+
+        // Number of elements smaller than x in the sequence of c elements encoded at pos
+        uint16_t ef_rank(size_type pos, uint16_t c, uint16_t x)const {
+            if (x >= block_size)
+                return c;
+            uint8_t l = ef_width(c);
+            size_type hp = pos + c*l;
+            uint16_t h = x >> l, q = 0, k = 0;
+            if (h) {  // skip the elements with a smaller high part
+                q = select_bits<0>(hp, c + (block_size>>l), h) + 1;
+                k = q - h;
+            }
+            uint16_t xl = x & bits::lo_set[l];
+            while (k < c and m_data[hp+q] and ef_low(pos, l, k) < xl) {
+                ++k; ++q;
+            }
+            return k;
+        }
+
+        // k-th element (0-based) of the sequence of c elements encoded at pos
+        uint16_t ef_select(size_type pos, uint16_t c, uint16_t k)const {
+            uint8_t l = ef_width(c);
+            uint16_t q = select_bits<1>(pos + c*l, c + (block_size>>l), k+1);
+            return ((q - k) << l) | ef_low(pos, l, k);
+        }
+
+        // Decodes the sequence of c elements encoded at pos into x
+        void ef_decode(size_type pos, uint16_t c, uint16_t* x)const {
+            uint8_t l = ef_width(c);
+            size_type hp = pos + c*l;
+            uint16_t len = c + (block_size>>l);
+            for (uint16_t q0=0, k=0; k < c; q0 += 64) {
+                uint64_t w = m_data.get_int(hp+q0, std::min(64, len-q0));
+                while (w) {
+                    uint16_t q = q0 + bits::lo(w);
+                    w &= w-1;
+                    x[k] = ((q - k) << l) | ef_low(pos, l, k);
+                    ++k;
+                }
+            }
+        }
+
+        // Reads the words of block j of bv; bits after the end are zero
+        void read_block(const bit_vector& bv, size_type j, uint64_t* w)const {
+            for (size_type t=0, p=j*block_size; t < 4; ++t, p += 64) {
+                w[t] = p < m_size ? bv.get_int(p, std::min((size_type)64, m_size-p)) : 0;
+            }
+        }
+
+        // Marks the positions p in [1..256) of w with bit p != bit p-1
+        static void run_starts(const uint64_t* w, uint64_t* x) {
+            for (size_type t=0; t < 4; ++t) {
+                x[t] = w[t] ^ ((w[t] << 1) | (t ? w[t-1] >> 63 : w[0] & 1));
+            }
+        }
+
+        // Writes the positions of the set bits of w into p and returns their number
+        static uint16_t positions(const uint64_t* w, uint16_t* p) {
+            uint16_t c = 0;
+            for (size_type t=0; t < 4; ++t) {
+                for (uint64_t x = w[t]; x; x &= x-1) {
+                    p[c++] = 64*t + bits::lo(x);
+                }
+            }
+            return c;
+        }
+
+        // Chooses the smallest encoding of the block w
+        static uint8_t choose_encoding(const uint64_t* w, uint16_t& pop, uint16_t& len) {
+            pop = bits::cnt(w[0]) + bits::cnt(w[1]) + bits::cnt(w[2]) + bits::cnt(w[3]);
+            len = 0;
+            if (pop == 0 or pop == block_size)
+                return CONST;
+            uint8_t type = RAW;
+            len = block_size;
+            uint16_t c = std::min(pop, (uint16_t)(block_size-pop));
+            if (ef_size(c) < len) {
+                type = MINORITY;
+                len = ef_size(c);
+            }
+            uint64_t x[4];
+            run_starts(w, x);
+            uint16_t r = bits::cnt(x[0]) + bits::cnt(x[1]) + bits::cnt(x[2]) + bits::cnt(x[3]);
+            if (9 + ef_size(r) < len) {
+                type = RUNS;
+                len = 9 + ef_size(r);
+            }
+            return type;
+        }
+
+        // Number of set bits in the first off bits of block j
+        uint16_t block_rank1(size_type j, uint16_t off)const {
+            if (!off)
+                return 0;
+            size_type pos = block_pos(j);
+            switch (block_type(j)) {
+                case CONST:
+                    return block_pop(j) ? off : 0;
+                case RAW: {
+                        uint16_t res = 0;
+                        for (; off >= 64; off -= 64, pos += 64)
+                            res += bits::cnt(m_data.get_int(pos, 64));
+                        return off ? res + bits::cnt(m_data.get_int(pos, off)) : res;
+                    }
+                case MINORITY: {
+                        uint16_t pop = block_pop(j);
+                        if (2*pop <= block_size)
+                            return ef_rank(pos, pop, off);
+                        return off - ef_rank(pos, block_size-pop, off);
+                    }
+                default: {
+                        uint16_t r = m_data.get_int(pos, 8), start = 0, res = 0;
+                        bool cur = m_data[pos+8];
+                        uint16_t x[block_size];
+                        ef_decode(pos+9, r, x);
+                        for (uint16_t k=0; k < r and x[k] < off; ++k) {
+                            if (cur)
+                                res += x[k]-start;
+                            start = x[k];
+                            cur = !cur;
+                        }
+                        return cur ? res + off - start : res;
+                    }
+            }
+        }
+
+        // Position of the i-th bit t_b in block j
+        template<uint8_t t_b>
+        uint16_t block_select(size_type j, uint16_t i)const {
+            size_type pos = block_pos(j);
+            switch (block_type(j)) {
+                case CONST:
+                    return i-1;
+                case RAW:
+                    return select_bits<t_b>(pos, block_size, i);
+                case MINORITY: {
+                        uint16_t pop = block_pop(j);
+                        bool ones = 2*pop <= block_size;
+                        uint16_t c = ones ? pop : block_size-pop;
+                        if (ones == (bool)t_b)
+                            return ef_select(pos, c, i-1);
+                        uint16_t x[block_size/2+1], res = i-1;
+                        ef_decode(pos, c, x);
+                        for (uint16_t k=0; k < c and x[k] <= res; ++k)
+                            ++res;
+                        return res;
+                    }
+                default: {
+                        uint16_t r = m_data.get_int(pos, 8), start = 0;
+                        bool cur = m_data[pos+8];
+                        uint16_t x[block_size];
+                        ef_decode(pos+9, r, x);
+                        for (uint16_t k=0; k <= r; ++k) {
+                            uint16_t end = k < r ? x[k] : (uint16_t)block_size;
+                            if (cur == (bool)t_b) {
+                                if (i <= end-start)
+                                    return start + i - 1;
+                                i -= end-start;
+                            }
+                            start = end;
+                            cur = !cur;
+                        }
+                        return block_size;
+                    }
+            }
+        }
+
+        //! Number of set bits in the prefix [0..i-1]
+        size_type rank1(size_type i)const {
+            size_type j = i/block_size;
+            return block_rank(j) + block_rank1(j, i%block_size);
+        }
+
+        //! Position of the i-th bit t_b
+        template<uint8_t t_b>
+        size_type select(size_type i)const {
+            // number of bits t_b before block j
+            auto cnt = [this](size_type j) {
+                return t_b ? block_rank(j) : j*block_size - block_rank(j);
+            };
+            size_type lo = 0, hi = m_sblock.size()/2;
+            while (hi-lo > 1) {
+                size_type mid = (lo+hi)/2;
+                if (cnt(mid*t_sblock_rate) < i)
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            size_type j = lo*t_sblock_rate;
+            size_type end = std::min(j+t_sblock_rate, m_block.size()-1);
+            while (j+1 < end and cnt(j+1) < i)
+                ++j;
+            return j*block_size + block_select<t_b>(j, i - cnt(j));
+        }
+
+    public:
+        //! Default constructor
+        hyb_vector() {}
+
+        //! Copy constructor
+        hyb_vector(const hyb_vector& v) {
+            copy(v);
+        }
+
+        //! Move constructor
+        hyb_vector(hyb_vector&& v) :
+            m_size(v.m_size), m_data(std::move(v.m_data)),
+            m_block(std::move(v.m_block)), m_sblock(std::move(v.m_sblock)) {}
+
+        //! Constructor
+        /*! \param bv Uncompressed bitvector.
+         */
+        hyb_vector(const bit_vector& bv) {
+            m_size = bv.size();
+            size_type blocks = (m_size+block_size-1)/block_size;
+            m_block  = int_vector<32>(blocks+1, 0);
+            m_sblock = int_vector<64>(2*(blocks/t_sblock_rate+1), 0);
+            uint64_t w[4];
+            uint16_t pop = 0, len = 0;
+            // (1) choose the encodings and calculate ranks and offsets
+            size_type rank = 0, pos = 0;
+            for (size_type j=0; j <= blocks; ++j) {
+                size_type s = j/t_sblock_rate;
+                if (j % t_sblock_rate == 0) {
+                    m_sblock[2*s]   = rank;
+                    m_sblock[2*s+1] = pos;
+                }
+                uint8_t type = CONST;
+                if (j < blocks) {
+                    read_block(bv, j, w);
+                    type = choose_encoding(w, pop, len);
+                }
+                m_block[j] = type | ((rank-m_sblock[2*s]) << 2) | ((pos-m_sblock[2*s+1]) << 14);
+                if (j < blocks) {
+                    rank += pop;
+                    pos  += len;
+                }
+            }
+            // (2) write the encodings
+            m_data = bit_vector(pos+64, 0);
+            uint16_t x[block_size];
+            for (size_type j=0; j < blocks; ++j) {
+                pos = block_pos(j);
+                read_block(bv, j, w);
+                switch (block_type(j)) {
+                    case RAW:
+                        for (size_type t=0; t < 4; ++t)
+                            m_data.set_int(pos+64*t, w[t], 64);
+                        break;
+                    case MINORITY: {
+                            uint16_t c = positions(w, x);
+                            if (2*c > block_size) {
+                                for (size_type t=0; t < 4; ++t)
+                                    w[t] = ~w[t];
+                                c = positions(w, x);
+                            }
+                            ef_encode(m_data, pos, x, c);
+                            break;
+                        }
+                    case RUNS: {
+                            uint64_t starts[4];
+                            run_starts(w, starts);
+                            uint16_t r = positions(starts, x);
+                            m_data.set_int(pos, r, 8);
+                            m_data[pos+8] = w[0] & 1;
+                            ef_encode(m_data, pos+9, x, r);
+                            break;
+                        }
+                }
+            }
+        }
+
+        //! Accessing the i-th element of the original bit_vector
+        /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
+         *  \return The i-th bit of the original bit_vector
+         */
+        value_type operator[](size_type i)const {
+            size_type j = i/block_size;
+            uint16_t off = i%block_size;
+            size_type pos = block_pos(j);
+            switch (block_type(j)) {
+                case CONST:
+                    return block_pop(j) > 0;
+                case RAW:
+                    return m_data[pos+off];
+                case MINORITY: {
+                        uint16_t pop = block_pop(j);
+                        bool ones = 2*pop <= block_size;
+                        uint16_t c = ones ? pop : block_size-pop;
+                        uint16_t k = ef_rank(pos, c, off);
+                        return (k < c and ef_select(pos, c, k) == off) == ones;
+                    }
+                default:
+                    return m_data[pos+8] ^ (ef_rank(pos+9, m_data.get_int(pos, 8), off+1) & 1);
+            }
+        }
+
+        //! Assignment operator
+        hyb_vector& operator=(const hyb_vector& v) {
+            if (this != &v) {
+                copy(v);
+            }
+            return *this;
+        }
+
+        //! Move assignment operator
+        hyb_vector& operator=(hyb_vector&& v) {
+            swap(v);
+            return *this;
+        }
+
+        //! Swap method
+        void swap(hyb_vector& v) {
+            if (this != &v) {
+                std::swap(m_size, v.m_size);
+                m_data.swap(v.m_data);
+                m_block.swap(v.m_block);
+                m_sblock.swap(v.m_sblock);
+            }
+        }
+
+        //! Returns the size of the original bit vector.
+        size_type size()const {
+            return m_size;
+        }
+
+        //! Serializes the data structure into the given ostream
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const {
+            structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
+            size_type written_bytes = 0;
+            written_bytes += write_member(m_size, out, child, "size");
+            written_bytes += m_data.serialize(out, child, "data");
+            written_bytes += m_block.serialize(out, child, "block");
+            written_bytes += m_sblock.serialize(out, child, "superblock");
+            structure_tree::add_size(child, written_bytes);
+            return written_bytes;
+        }
+
+        //! Loads the data structure from the given istream.
+        void load(std::istream& in) {
+            read_member(m_size, in);
+            m_data.load(in);
+            m_block.load(in);
+            m_sblock.load(in);
+        }
+
+        iterator begin() const {
+            return iterator(this, 0);
+        }
+
+        iterator end() const {
+            return iterator(this, size());
+        }
+};
+
+template<uint8_t t_b>
+struct rank_support_hyb_trait {
+    typedef bit_vector::size_type size_type;
+    static size_type adjust_rank(size_type r, SDSL_UNUSED size_type n) {
+        return r;
+    }
+};
+
+template<>
+struct rank_support_hyb_trait<0> {
+    typedef bit_vector::size_type size_type;
+    static size_type adjust_rank(size_type r, size_type n) {
+        return n - r;
+    }
+};
+
+//! Rank data structure for hyb_vector
+/*! \tparam t_b            The bit pattern of size one. (so `0` or `1`)
+ *  \tparam t_sblock_rate  Superblock rate of the supported hyb_vector.
+ */
+template<uint8_t t_b, uint32_t t_sblock_rate>
+class rank_support_hyb
+{
+        static_assert(t_b == 1u or t_b == 0u , "rank_support_hyb: bit pattern must be `0` or `1`");
+    public:
+        typedef hyb_vector<t_sblock_rate>           bit_vector_type;
+        typedef typename bit_vector_type::size_type size_type;
+    private:
+        const bit_vector_type* m_v;
+
+    public:
+        explicit rank_support_hyb(const bit_vector_type* v=nullptr) {
+            set_vector(v);
+        }
+
+        //! Answers rank queries
+        /*! \param i Argument for the length of the prefix v[0..i-1], with \f$0\leq i \leq size()\f$.
+         *  \returns Number of t_b-bits in the prefix [0..i-1] of the original bit_vector.
+         */
+        size_type rank(size_type i)const {
+            assert(m_v != nullptr);
+            assert(i <= m_v->size());
+            return rank_support_hyb_trait<t_b>::adjust_rank(m_v->rank1(i), i);
+        }
+
+        const size_type operator()(size_type i)const {
+            return rank(i);
+        }
+
+        const size_type size()const {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=nullptr) {
+            m_v = v;
+        }
+
+        rank_support_hyb& operator=(const rank_support_hyb& rs) {
+            if (this != &rs) {
+                set_vector(rs.m_v);
+            }
+            return *this;
+        }
+
+        void swap(rank_support_hyb&) { }
+
+        void load(std::istream&, const bit_vector_type* v=nullptr) {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const {
+            return serialize_empty_object(out, v, name, this);
+        }
+};
+
+//! Select data structure for hyb_vector
+/*! \tparam t_b            The bit pattern of size one. (so `0` or `1`)
+ *  \tparam t_sblock_rate  Superblock rate of the supported hyb_vector.
+ *
+ *  The superblock is found by a binary search on the superblock counts,
+ *  the block by a linear scan on the block counts.
+ */
+template<uint8_t t_b, uint32_t t_sblock_rate>
+class select_support_hyb
+{
+        static_assert(t_b == 1u or t_b == 0u , "select_support_hyb: bit pattern must be `0` or `1`");
+    public:
+        typedef hyb_vector<t_sblock_rate>           bit_vector_type;
+        typedef typename bit_vector_type::size_type size_type;
+    private:
+        const bit_vector_type* m_v;
+
+    public:
+        explicit select_support_hyb(const bit_vector_type* v=nullptr) {
+            set_vector(v);
+        }
+
+        //! Returns the position of the i-th occurrence in the bit vector.
+        /*! \param i Argument with \f$1\leq i \leq\f$ number of t_b-bits.
+         */
+        size_type select(size_type i)const {
+            assert(m_v != nullptr);
+            return m_v->template select<t_b>(i);
+        }
+
+        const size_type operator()(size_type i)const {
+            return select(i);
+        }
+
+        const size_type size()const {
+            return m_v->size();
+        }
+
+        void set_vector(const bit_vector_type* v=nullptr) {
+            m_v = v;
+        }
+
+        select_support_hyb& operator=(const select_support_hyb& ss) {
+            if (this != &ss) {
+                set_vector(ss.m_v);
+            }
+            return *this;
+        }
+
+        void swap(select_support_hyb&) { }
+
+        void load(std::istream&, const bit_vector_type* v=nullptr) {
+            set_vector(v);
+        }
+
+        size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const {
+            return serialize_empty_object(out, v, name, this);
+        }
+};
+
+}// end namespace sdsl
+
+#endif
@@ -38,6 +38,7 @@
 #include "memory_management.hpp"
 #include "ram_fs.hpp"
 #include "sfstream.hpp"
+#include "block_compression.hpp"
 
 #include <iosfwd>    // forward declaration of ostream
 #include <stdexcept> // for exceptions
@@ -295,6 +296,11 @@ class int_vector
         size_type      m_size;  //!< Number of bits needed to store int_vector.
         uint64_t*      m_data;  //!< Pointer to the memory for the bits.
         int_width_type m_width; //!< Width of the integers.
+        bool           m_mapped;//!< True if m_data points into a memory mapped file, see mm::map.
+        mm_allocator*  m_alloc; //!< Allocator of m_data, see mm::allocator_scope.
+
+        //! Load from a file in the block compressed format of int_vector_buffer.
+        void load_compressed(std::istream& in);
 
     public:
 
@@ -401,6 +407,23 @@ class int_vector
         */
         void set_int(size_type idx, value_type x, const uint8_t len=64);
 
+        //! Decodes the n elements starting at index i.
+        /*! \param i   Index of the first element.
+            \param n   Number of elements, i+n <= size().
+            \param out Array of size n; out[k] is set to the value of element i+k.
+            \par Much faster than n calls of operator[], see bits::read_ints.
+            \sa set_range
+        */
+        void get_range(size_type i, size_type n, uint64_t* out) const;
+
+        //! Sets the n elements starting at index i.
+        /*! \param i   Index of the first element.
+            \param n   Number of elements, i+n <= size().
+            \param in  Array of size n; element i+k is set to in[k].
+            \sa get_range
+        */
+        void set_range(size_type i, size_type n, const uint64_t* in);
+
         //! Returns the width of the integers which are accessed via the [] operator.
         /*! \returns The width of the integers which are accessed via the [] operator.
             \sa width
@@ -424,6 +447,9 @@ class int_vector
                             std::string name = "", bool write_fixed_as_variable=false) const;
 
         //! Load the int_vector for a stream.
+        /*! Files in the block compressed format of int_vector_buffer are
+         *  detected and decompressed; in this case in has to be seekable.
+         */
         void load(std::istream& in);
 
         //! non const version of [] operator
@@ -512,21 +538,78 @@ class int_vector
             static_assert(1 == t_width, "int_vector: flip() is available only for bit_vector.");
         }
 
+        //! Bitwise and with a bit_vector of the same size
+        int_vector& operator&=(const int_vector&) {
+            static_assert(1 == t_width, "int_vector: operator&= is available only for bit_vector.");
+            return *this;
+        }
+
+        //! Bitwise or with a bit_vector of the same size
+        int_vector& operator|=(const int_vector&) {
+            static_assert(1 == t_width, "int_vector: operator|= is available only for bit_vector.");
+            return *this;
+        }
+
+        //! Bitwise xor with a bit_vector of the same size
+        int_vector& operator^=(const int_vector&) {
+            static_assert(1 == t_width, "int_vector: operator^= is available only for bit_vector.");
+            return *this;
+        }
+
+        //! Clears all bits which are set in a bit_vector of the same size
+        int_vector& andnot(const int_vector&) {
+            static_assert(1 == t_width, "int_vector: andnot() is available only for bit_vector.");
+            return *this;
+        }
+
+        //! Number of set bits of the bit_vector
+        size_type count_ones() const {
+            static_assert(1 == t_width, "int_vector: count_ones() is available only for bit_vector.");
+            return 0;
+        }
+
+        //! Number of set bits in the range [i, j) of the bit_vector
+        size_type count_ones(size_type, size_type) const {
+            static_assert(1 == t_width, "int_vector: count_ones(i,j) is available only for bit_vector.");
+            return 0;
+        }
+
         //! Read the size and int_width of a int_vector
+        /*! The top byte of the size field is the number of zero bytes
+         *  which follow the header, so that the data starts at a multiple
+         *  of 8 bytes in the file and can be mapped (see mm::map). It is
+         *  zero in files without padding.
+         */
         static void read_header(int_vector_size_type& size, int_width_type& int_width, std::istream& in) {
             read_member(size, in);
             if (0 == t_width) {
                 read_member(int_width, in);
             }
+            uint64_t pad = size >> 56;
+            if (pad > 0 and pad < 8) { // the block_compression::MAGIC is larger
+                in.ignore(pad);
+                size &= 0x00FFFFFFFFFFFFFFULL;
+            }
         }
 
-        //! Write the size and int_width of a int_vector
-        static uint64_t write_header(uint64_t size, uint8_t int_width, std::ostream& out) {
-            uint64_t written_bytes = write_member(size, out);
+        //! Write the size and int_width of a int_vector, followed by pad zero bytes
+        static uint64_t write_header(uint64_t size, uint8_t int_width, std::ostream& out, uint8_t pad=0) {
+            uint64_t written_bytes = write_member(size | ((uint64_t)pad << 56), out);
             if (0 == t_width) {
                 written_bytes += write_member(int_width, out);
             }
-            return written_bytes;
+            out.write("\0\0\0\0\0\0\0", pad);
+            return written_bytes + pad;
+        }
+
+        //! Padding of a header written at position pos which aligns the data to 8 bytes
+        /*! Returns 0 if the position is unknown, e.g. pos == -1.
+         */
+        static uint8_t header_padding(std::streamoff pos) {
+            if (pos < 0) {
+                return 0;
+            }
+            return (8 - (pos + (t_width ? 8 : 9)) % 8) % 8;
         }
 };
 
@@ -536,6 +619,24 @@ void int_vector<0>::width(const uint8_t);
 template<>
 void bit_vector::flip();
 
+template<>
+bit_vector& bit_vector::operator&=(const bit_vector& v);
+
+template<>
+bit_vector& bit_vector::operator|=(const bit_vector& v);
+
+template<>
+bit_vector& bit_vector::operator^=(const bit_vector& v);
+
+template<>
+bit_vector& bit_vector::andnot(const bit_vector& v);
+
+template<>
+bit_vector::size_type bit_vector::count_ones() const;
+
+template<>
+bit_vector::size_type bit_vector::count_ones(size_type i, size_type j) const;
+
 //! A proxy class that acts as a reference to an integer of length \p len bits in a int_vector.
 /*! \tparam t_int_vector The specific int_vector class.
  */
@@ -971,6 +1072,15 @@ class int_vector_const_iterator : public int_vector_iterator_base<t_int_vector>
                    ((*(m_word+1) & bits::lo_set[(m_offset+m_len)&0x3F])<<(64-m_offset));
         }
 
+        //! Decodes the n elements starting at the iterator
+        /*! \param n   Number of elements, at most the distance to end().
+            \param out Array of size n; out[k] is set to *(*this + k).
+            \sa int_vector::get_range
+         */
+        void get_range(size_type n, uint64_t* out) const {
+            bits::read_ints(m_word, m_offset, m_len, n, out);
+        }
+
         //! Prefix increment of the Iterator
         const_iterator& operator++() {
             m_offset+=m_len;
@@ -1116,7 +1226,7 @@ operator<<(std::ostream& os, const t_iv& v)
 
 template<uint8_t t_width>
 inline int_vector<t_width>::int_vector(size_type size, value_type default_value, uint8_t intWidth):
-    m_size(0), m_data(nullptr), m_width(t_width)
+    m_size(0), m_data(nullptr), m_width(t_width), m_mapped(false), m_alloc(mm::allocator())
 {
     mm::add(this);
     width(intWidth);
@@ -1126,16 +1236,18 @@ inline int_vector<t_width>::int_vector(size_type size, value_type default_value,
 
 template<uint8_t t_width>
 inline int_vector<t_width>::int_vector(int_vector&& v) :
-    m_size(v.m_size), m_data(v.m_data), m_width(v.m_width)
+    m_size(v.m_size), m_data(v.m_data), m_width(v.m_width), m_mapped(v.m_mapped),
+    m_alloc(v.m_alloc)
 {
     v.m_size = 0;       // has to be set for mm::remove
     v.m_data = nullptr; // ownership of v.m_data now transfered
+    v.m_mapped = false;
     mm::add(this, true);
 }
 
 template<uint8_t t_width>
 inline int_vector<t_width>::int_vector(const int_vector& v):
-    m_size(0), m_data(nullptr), m_width(v.m_width)
+    m_size(0), m_data(nullptr), m_width(v.m_width), m_mapped(false), m_alloc(mm::allocator())
 {
     mm::add(this);
     bit_resize(v.bit_size());
@@ -1174,7 +1286,11 @@ template<uint8_t t_width>
 int_vector<t_width>::~int_vector()
 {
     mm::remove(this);
-    free(m_data);
+    if (m_mapped) {
+        mm::unref_mapping(m_data);
+    } else if (m_data != nullptr) {
+        m_alloc->deallocate(m_data, ((m_size+64)>>6)<<3);
+    }
 }
 
 template<uint8_t t_width>
@@ -1184,11 +1300,17 @@ void int_vector<t_width>::swap(int_vector& v)
         size_type size     = m_size;
         uint64_t* data     = m_data;
         uint8_t  int_width = m_width;
+        bool     mapped    = m_mapped;
+        mm_allocator* alloc = m_alloc;
         m_size   = v.m_size;
         m_data   = v.m_data;
+        m_mapped = v.m_mapped;
+        m_alloc  = v.m_alloc;
         width(v.m_width);
         v.m_size = size;
         v.m_data = data;
+        v.m_mapped = mapped;
+        v.m_alloc  = alloc;
         v.width(int_width);
     }
 }
@@ -1227,6 +1349,30 @@ inline void int_vector<t_width>::set_int(size_type idx, value_type x, const uint
     bits::write_int(m_data+(idx>>6), x, idx&0x3F, len);
 }
 
+template<uint8_t t_width>
+inline void int_vector<t_width>::get_range(size_type i, size_type n, uint64_t* out)const
+{
+#ifdef SDSL_DEBUG
+    if (i+n > size()) {
+        throw std::out_of_range("OUT_OF_RANGE_ERROR: int_vector::get_range(size_type, size_type, uint64_t*); i+n > size()!");
+    }
+#endif
+    size_type idx = i*m_width;
+    bits::read_ints(m_data+(idx>>6), idx&0x3F, m_width, n, out);
+}
+
+template<uint8_t t_width>
+inline void int_vector<t_width>::set_range(size_type i, size_type n, const uint64_t* in)
+{
+#ifdef SDSL_DEBUG
+    if (i+n > size()) {
+        throw std::out_of_range("OUT_OF_RANGE_ERROR: int_vector::set_range(size_type, size_type, const uint64_t*); i+n > size()!");
+    }
+#endif
+    size_type idx = i*m_width;
+    bits::write_ints(m_data+(idx>>6), idx&0x3F, m_width, n, in);
+}
+
 template<uint8_t t_width>
 inline auto int_vector<t_width>::operator[](const size_type& idx) -> reference {
     assert(idx < this->size());
@@ -1392,10 +1538,12 @@ typename int_vector<t_width>::size_type int_vector<t_width>::serialize(std::ostr
 {
     structure_tree_node* child = structure_tree::add_child(v, name, util::class_name(*this));
     size_type written_bytes = 0;
+    // the data is aligned to 8 bytes in the file, so that it can be mapped
+    std::streamoff pos = out.tellp();
     if (t_width > 0 and write_fixed_as_variable) {
-        written_bytes += int_vector<0>::write_header(m_size, t_width, out);
+        written_bytes += int_vector<0>::write_header(m_size, t_width, out, int_vector<0>::header_padding(pos));
     } else {
-        written_bytes += int_vector<t_width>::write_header(m_size, m_width, out);
+        written_bytes += int_vector<t_width>::write_header(m_size, m_width, out, header_padding(pos));
     }
 
     uint64_t* p = m_data;
@@ -1418,6 +1566,14 @@ void int_vector<t_width>::load(std::istream& in)
     size_type size;
     int_vector<t_width>::read_header(size, m_width, in);
 
+    if (size == block_compression::MAGIC) {
+        in.seekg(-(std::streamoff)(t_width ? 8 : 9), std::ios_base::cur);
+        load_compressed(in);
+        return;
+    }
+    if (mm::map(*this, in, size)) { // zero-copy load from a memory mapped file
+        return;
+    }
     bit_resize(size);
     uint64_t* p = m_data;
     size_type idx = 0;
@@ -1429,6 +1585,32 @@ void int_vector<t_width>::load(std::istream& in)
     in.read((char*) p, ((capacity()>>6)-idx)*sizeof(uint64_t));
 }
 
+template<uint8_t t_width>
+void int_vector<t_width>::load_compressed(std::istream& in)
+{
+    std::streampos begin = in.tellg();
+    block_compression::header h;
+    block_compression::read_header(in, h);
+    block_compression::index_type index;
+    block_compression::read_index(in, begin, h, index);
+    width(h.width);
+    resize(h.size);
+    std::vector<uint64_t> encoded, values(h.block_size);
+    for (uint64_t b=0; b < index.size(); ++b) {
+        uint64_t n = std::min(h.block_size, h.size-b*h.block_size);
+        std::fill(values.begin(), values.begin()+n, 0);
+        if (index[b].second) {
+            encoded.resize(index[b].second/8);
+            in.seekg(begin + (std::streamoff)index[b].first);
+            in.read((char*)encoded.data(), index[b].second);
+            block_compression::decode(encoded.data(), values.data());
+        }
+        set_range(b*h.block_size, n, values.data());
+    }
+    // continue after the block index
+    in.seekg(begin + (std::streamoff)(h.index_offset + index.size()*sizeof(index[0])));
+}
+
 //! A wrapper class which allows us to serialize an char array as an int_vector.
 class char_array_serialize_wrapper
 {
@@ -23,15 +23,29 @@
 
 #include "int_vector.hpp"
 #include "iterators.hpp"
+#include "block_compression.hpp"
+#include "construct_profile.hpp"
 #include <cassert>
 #include <fstream>
 #include <iostream>
 #include <stdio.h>
 #include <string>
+#include <future>
 
 namespace sdsl
 {
 
+//! Access patterns which can be announced to an int_vector_buffer
+/*! For forward_access and backward_access the buffer reads the next block
+ *  in the announced direction ahead and writes modified blocks back in the
+ *  background.
+ */
+enum buffer_access {
+    random_access,   //!< No prefetching, all I/O is synchronous (default).
+    forward_access,  //!< Indices are mainly increasing.
+    backward_access  //!< Indices are mainly decreasing.
+};
+
 template<uint8_t t_width=0>
 class int_vector_buffer
 {
@@ -45,45 +59,209 @@ class int_vector_buffer
         std::string         m_filename;
         int_vector<t_width> m_buffer;
         bool                m_need_to_write = false;
-        // length of int_vector header in bytes: 0 for plain, 8 for int_vector<t_width> (0 < t_width), 9 for int_vector<0>
+        // length of int_vector header in bytes including the padding: 0 for plain, 8 for int_vector<t_width> (0 < t_width), 9 or 16 for int_vector<0>
         uint64_t            m_offset     = 0;
         uint64_t            m_buffersize = 0;    // in elements! m_buffersize*width() must be a multiple of 8!
         uint64_t            m_size       = 0;    // size of int_vector_buffer
         uint64_t            m_begin      = 0;    // number in elements
+        buffer_access       m_access     = random_access;
+        // blocks read ahead and written back by background tasks. The tasks
+        // use m_ifile resp. m_ofile exclusively until they are waited for.
+        int_vector<t_width> m_prefetch_buffer;
+        int_vector<t_width> m_writeback_buffer;
+        uint64_t            m_prefetch_begin  = (uint64_t)-1; // -1 if m_prefetch_buffer holds no block
+        uint64_t            m_writeback_begin = 0;
+        std::future<void>   m_prefetch_task;
+        std::future<void>   m_writeback_task;
+        // block compressed files, see block_compression.hpp
+        bool                m_compressed = false;
+        block_compression::index_type m_block_index; // location of each block in the file
+        uint64_t            m_file_end   = 0;         // end of the last block in bytes
+        std::vector<uint64_t> m_encoded;              // last encoded block
+
+        //! Location of the block starting at element begin in a compressed file.
+        std::pair<uint64_t, uint64_t> block_location(const uint64_t begin) const {
+            uint64_t b = begin/m_buffersize;
+            return b < m_block_index.size() ? m_block_index[b] : std::pair<uint64_t, uint64_t>(0, 0);
+        }
 
-        //! Read block containing element at index idx.
-        void read_block(const uint64_t idx) {
-            m_begin = (idx/m_buffersize)*m_buffersize;
-            if (m_begin >= m_size) {
-                util::set_to_value(m_buffer, 0);
+        //! Read the compressed block at location loc into buf.
+        void read_block(int_vector<t_width>& buf, std::pair<uint64_t, uint64_t> loc) {
+            if (0 == loc.second) { // block was never written
+                util::set_to_value(buf, 0);
+                return;
+            }
+            std::vector<uint64_t> encoded(loc.second/8), values(m_buffersize, 0);
+            m_ifile.seekg(loc.first);
+            m_ifile.read((char*)encoded.data(), loc.second);
+            assert(m_ifile.good());
+            construct_profile::count_read(loc.second);
+            block_compression::decode(encoded.data(), values.data());
+            buf.set_range(0, m_buffersize, values.data());
+        }
+
+        //! Compress the block starting at element begin from buf into m_encoded.
+        /*! The block is appended to the file, i.e. its location is updated
+         *  and the byte offset for write_encoded is returned.
+         */
+        uint64_t encode_block(const int_vector<t_width>& buf, const uint64_t begin, const uint64_t size) {
+            std::vector<uint64_t> values(std::min(m_buffersize, size-begin));
+            buf.get_range(0, values.size(), values.data());
+            block_compression::encode(values.data(), values.size(), m_encoded);
+            uint64_t b = begin/m_buffersize, offset = m_file_end;
+            if (m_block_index.size() <= b) {
+                m_block_index.resize(b+1, std::pair<uint64_t, uint64_t>(0, 0));
+            }
+            m_block_index[b] = std::pair<uint64_t, uint64_t>(offset, m_encoded.size()*8);
+            m_file_end += m_encoded.size()*8;
+            return offset;
+        }
+
+        //! Write m_encoded at byte offset to file.
+        void write_encoded(const uint64_t offset) {
+            m_ofile.seekp(offset);
+            assert(m_ofile.good());
+            m_ofile.write((const char*)m_encoded.data(), m_encoded.size()*8);
+            m_ofile.flush();
+            construct_profile::count_written(m_encoded.size()*8);
+            assert(m_ofile.good());
+        }
+
+        //! Read the block starting at element begin into buf.
+        void read_block(int_vector<t_width>& buf, const uint64_t begin, const uint64_t size) {
+            if (begin >= size) {
+                util::set_to_value(buf, 0);
+            } else if (m_compressed) {
+                read_block(buf, block_location(begin));
             } else {
-                m_ifile.seekg(m_offset+(m_begin*width())/8);
+                uint64_t bytes = (m_buffersize*buf.width())/8;
+                m_ifile.seekg(m_offset+(begin*buf.width())/8);
                 assert(m_ifile.good());
-                m_ifile.read((char*) m_buffer.data(), (m_buffersize*width())/8);
-                if ((uint64_t)m_ifile.gcount() < (m_buffersize*width())/8) {
+                m_ifile.read((char*) buf.data(), bytes);
+                construct_profile::count_read(m_ifile.gcount());
+                if ((uint64_t)m_ifile.gcount() < bytes) {
+                    // the end of the file is not written yet
+                    memset((char*)buf.data()+m_ifile.gcount(), 0, bytes-m_ifile.gcount());
                     m_ifile.clear();
                 }
                 assert(m_ifile.good());
-                for (uint64_t i=m_size-m_begin; i<m_buffersize; ++i) {
-                    m_buffer[i] = 0;
+                for (uint64_t i=size-begin; i<m_buffersize; ++i) {
+                    buf[i] = 0;
                 }
             }
         }
 
+        //! Write the block starting at element begin from buf to file.
+        void write_block(const int_vector<t_width>& buf, const uint64_t begin, const uint64_t size) {
+            m_ofile.seekp(m_offset+(begin*buf.width())/8);
+            assert(m_ofile.good());
+            uint64_t wb = (m_buffersize*buf.width())/8;
+            if (begin+m_buffersize >= size) {
+                //last block in file
+                wb = ((size-begin)*buf.width()+7)/8;
+            }
+            m_ofile.write((const char*) buf.data(), wb);
+            construct_profile::count_written(wb);
+            m_ofile.flush();
+            assert(m_ofile.good());
+        }
+
+        //! Wait until the background write of the last modified block is done.
+        void wait_for_writeback() {
+            if (m_writeback_task.valid()) {
+                m_writeback_task.get();
+            }
+        }
+
+        //! Wait for all background tasks and discard the block read ahead.
+        void wait_for_io() {
+            if (m_prefetch_task.valid()) {
+                m_prefetch_task.get();
+            }
+            m_prefetch_begin = (uint64_t)-1;
+            wait_for_writeback();
+        }
+
+        //! Start reading the neighbouring block in the announced direction.
+        void prefetch_block() {
+            uint64_t begin;
+            if (m_access == forward_access and m_begin+m_buffersize < m_size) {
+                begin = m_begin+m_buffersize;
+            } else if (m_access == backward_access and m_begin >= m_buffersize) {
+                begin = m_begin-m_buffersize;
+            } else {
+                return;
+            }
+            if (begin == m_writeback_begin) {
+                wait_for_writeback();
+            }
+            if (m_prefetch_buffer.size() != m_buffersize or m_prefetch_buffer.width() != width()) {
+                m_prefetch_buffer = int_vector<t_width>(m_buffersize, 0, width());
+            }
+            m_prefetch_begin = begin;
+            uint64_t size = m_size;
+            if (m_compressed) { // m_block_index is only accessed by this thread
+                std::pair<uint64_t, uint64_t> loc = block_location(begin);
+                m_prefetch_task = std::async(std::launch::async, [this, loc]() {
+                    read_block(m_prefetch_buffer, loc);
+                });
+            } else {
+                m_prefetch_task = std::async(std::launch::async, [this, begin, size]() {
+                    read_block(m_prefetch_buffer, begin, size);
+                });
+            }
+        }
+
+        //! Read block containing element at index idx.
+        void read_block(const uint64_t idx) {
+            uint64_t begin = (idx/m_buffersize)*m_buffersize;
+            if (m_prefetch_task.valid()) {
+                m_prefetch_task.get();
+            }
+            if (m_prefetch_begin == begin) {
+                m_buffer.swap(m_prefetch_buffer);
+            } else {
+                if (m_writeback_task.valid() and m_writeback_begin == begin) {
+                    wait_for_writeback();
+                }
+                read_block(m_buffer, begin, m_size);
+            }
+            m_prefetch_begin = (uint64_t)-1;
+            m_begin = begin;
+            prefetch_block();
+        }
+
         //! Write current block to file.
+        /*! Except for random_access the block is written in the background
+         *  and the content of m_buffer is undefined afterwards.
+         */
         void write_block() {
             if (m_need_to_write) {
-                m_ofile.seekp(m_offset+(m_begin*width())/8);
-                assert(m_ofile.good());
-                if (m_begin+m_buffersize >= m_size) {
-                    //last block in file
-                    uint64_t wb = ((m_size-m_begin)*width()+7)/8;
-                    m_ofile.write((char*) m_buffer.data(), wb);
+                if (m_access == random_access) {
+                    if (m_compressed) {
+                        write_encoded(encode_block(m_buffer, m_begin, m_size));
+                    } else {
+                        write_block(m_buffer, m_begin, m_size);
+                    }
+                } else if (m_compressed) {
+                    wait_for_writeback();
+                    m_writeback_begin = m_begin;
+                    uint64_t offset = encode_block(m_buffer, m_begin, m_size);
+                    m_writeback_task = std::async(std::launch::async, [this, offset]() {
+                        write_encoded(offset);
+                    });
                 } else {
-                    m_ofile.write((char*) m_buffer.data(), (m_buffersize*width())/8);
+                    wait_for_writeback();
+                    if (m_writeback_buffer.size() != m_buffersize or m_writeback_buffer.width() != width()) {
+                        m_writeback_buffer = int_vector<t_width>(m_buffersize, 0, width());
+                    }
+                    m_buffer.swap(m_writeback_buffer);
+                    m_writeback_begin = m_begin;
+                    uint64_t begin = m_begin, size = m_size;
+                    m_writeback_task = std::async(std::launch::async, [this, begin, size]() {
+                        write_block(m_writeback_buffer, begin, size);
+                    });
                 }
-                m_ofile.flush();
-                assert(m_ofile.good());
                 m_need_to_write = false;
             }
         }
@@ -131,8 +309,11 @@ class int_vector_buffer
          *  \param is_plain   If false (default) the file will be interpreted as int_vector.
          *                    If true the file will be interpreted as plain array with t_width bits per integer.
          *                    In second case (is_plain==true), t_width must be 8, 16, 32 or 64.
+         *  \param compressed If true a new file is written in the block compressed format
+         *                    (see block_compression.hpp). Existing files in this format are
+         *                    detected automatically; their buffersize is the block size of the file.
          */
-        int_vector_buffer(const std::string filename, std::ios::openmode mode=std::ios::in, const uint64_t buffersize=1024*1024, const uint8_t int_width=t_width, const bool is_plain=false) {
+        int_vector_buffer(const std::string filename, std::ios::openmode mode=std::ios::in, const uint64_t buffersize=1024*1024, const uint8_t int_width=t_width, const bool is_plain=false, const bool compressed=false) {
             m_filename = filename;
             assert(!(mode&std::ios::app));
             mode &= ~std::ios::app;
@@ -141,7 +322,9 @@ class int_vector_buffer
                 // is_plain is only allowed with width() in {8, 16, 32, 64}
                 assert(8==width() or 16==width() or 32==width() or 64==width());
             } else {
-                m_offset = t_width ? 8 : 9;
+                // the header of an int_vector<0> is padded to 16 bytes, so
+                // that the data can be mapped (see int_vector::read_header)
+                m_offset = t_width ? 8 : 16;
             }
 
             // Open file for IO
@@ -155,14 +338,34 @@ class int_vector_buffer
                     m_ifile.seekg(0, std::ios_base::end);
                     size = m_ifile.tellg()*8;
                 } else {
-                    uint8_t width = 0;
-                    int_vector<t_width>::read_header(size, width, m_ifile);
-                    m_buffer.width(width);
+                    block_compression::header h;
+                    if (block_compression::read_header(m_ifile, h)) {
+                        m_compressed = true;
+                        m_buffer.width(h.width);
+                        size = h.size*width();
+                        m_buffersize = h.block_size;
+                        block_compression::read_index(m_ifile, 0, h, m_block_index);
+                        m_file_end = h.index_offset; // the index is rewritten on close
+                    } else {
+                        m_ifile.clear();
+                        m_ifile.seekg(0);
+                        uint8_t width = 0;
+                        int_vector<t_width>::read_header(size, width, m_ifile);
+                        m_buffer.width(width);
+                        if (m_ifile.good()) {
+                            m_offset = m_ifile.tellg(); // including the padding
+                        }
+                    }
                 }
                 assert(m_ifile.good());
                 m_size = size/width();
+            } else if (compressed and !is_plain) {
+                m_compressed = true;
+                m_file_end = block_compression::HEADER_SIZE;
             }
-            if (0==(buffersize*8)%width()) {
+            if (m_compressed and m_buffersize) {
+                // block size is given by the file
+            } else if (0==(buffersize*8)%width()) {
                 m_buffersize = buffersize*8/width(); // m_buffersize might not be multiple of 8, but m_buffersize*width is.
             } else {
                 uint64_t element_buffersize = (buffersize*8)/width()+1; // one more element than fits into given buffersize in byte
@@ -174,14 +377,19 @@ class int_vector_buffer
         }
 
         //! Move constructor.
-        int_vector_buffer(int_vector_buffer&& ivb) :
-            m_filename((std::string&&)ivb.m_filename),
-            m_buffer((int_vector<t_width>&&)ivb.m_buffer),
-            m_need_to_write(ivb.m_need_to_write),
-            m_offset(ivb.m_offset),
-            m_buffersize(ivb.m_buffersize),
-            m_size(ivb.m_size),
-            m_begin(ivb.m_begin) {
+        int_vector_buffer(int_vector_buffer&& ivb) {
+            ivb.wait_for_io();
+            m_filename = (std::string&&)ivb.m_filename;
+            m_buffer = (int_vector<t_width>&&)ivb.m_buffer;
+            m_need_to_write = ivb.m_need_to_write;
+            m_offset = ivb.m_offset;
+            m_buffersize = ivb.m_buffersize;
+            m_size = ivb.m_size;
+            m_begin = ivb.m_begin;
+            m_access = ivb.m_access;
+            m_compressed = ivb.m_compressed;
+            m_block_index = std::move(ivb.m_block_index);
+            m_file_end = ivb.m_file_end;
             ivb.m_ifile.close();
             ivb.m_ofile.close();
             m_ifile.open(m_filename, std::ios::in|std::ios::binary);
@@ -196,6 +404,10 @@ class int_vector_buffer
             ivb.m_buffersize = 0;
             ivb.m_size = 0;
             ivb.m_begin = 0;
+            ivb.m_access = random_access;
+            ivb.m_compressed = false;
+            ivb.m_block_index.clear();
+            ivb.m_file_end = 0;
         }
 
         //! Destructor.
@@ -206,6 +418,7 @@ class int_vector_buffer
         //! Move assignment operator.
         int_vector_buffer<t_width>& operator=(int_vector_buffer&& ivb) {
             close();
+            ivb.wait_for_io();
             ivb.m_ifile.close();
             ivb.m_ofile.close();
             m_filename = ivb.m_filename;
@@ -220,6 +433,10 @@ class int_vector_buffer
             m_buffersize = ivb.m_buffersize;
             m_size = ivb.m_size;
             m_begin = ivb.m_begin;
+            m_access = ivb.m_access;
+            m_compressed = ivb.m_compressed;
+            m_block_index = std::move(ivb.m_block_index);
+            m_file_end = ivb.m_file_end;
             // set ivb to default-constructor state
             ivb.m_filename = "";
             ivb.m_buffer = int_vector<t_width>();
@@ -228,6 +445,10 @@ class int_vector_buffer
             ivb.m_buffersize = 0;
             ivb.m_size = 0;
             ivb.m_begin = 0;
+            ivb.m_access = random_access;
+            ivb.m_compressed = false;
+            ivb.m_block_index.clear();
+            ivb.m_file_end = 0;
             return *this;
         }
 
@@ -253,8 +474,14 @@ class int_vector_buffer
         }
 
         //! Set the buffersize in bytes
+        /*! The buffersize of a compressed file is its block size and is not changed.
+         */
         void buffersize(uint64_t buffersize) {
+            if (m_compressed) {
+                return;
+            }
             write_block();
+            wait_for_io();
             if (0==(buffersize*8)%width()) {
                 m_buffersize = buffersize*8/width(); // m_buffersize might not be multiple of 8, but m_buffersize*width() is.
             } else {
@@ -265,6 +492,28 @@ class int_vector_buffer
             if (0!=m_buffersize) read_block(0);
         }
 
+        //! Returns the announced access pattern
+        buffer_access access() const {
+            return m_access;
+        }
+
+        //! Announce the access pattern of the following operations
+        /*! \param access For forward_access and backward_access the next
+         *                block is read ahead and modified blocks are written
+         *                by a background thread; random_access (the default)
+         *                performs all I/O synchronously.
+         */
+        void access(buffer_access access) {
+            if (access == m_access) {
+                return;
+            }
+            wait_for_io();
+            m_access = access;
+            if (is_open() and 0!=m_buffersize) {
+                prefetch_block();
+            }
+        }
+
         //! Returns whether state of underlying streams are good
         bool good() {
             return m_ifile.good() and m_ofile.good();
@@ -277,6 +526,7 @@ class int_vector_buffer
 
         //! Delete all content and set size to 0
         void reset() {
+            wait_for_io();
             // reset file
             assert(m_ifile.good());
             assert(m_ofile.good());
@@ -290,6 +540,8 @@ class int_vector_buffer
             // reset member variables
             m_need_to_write = false;
             m_size = 0;
+            m_block_index.clear();
+            m_file_end = m_compressed ? block_compression::HEADER_SIZE : 0;
             // reset buffer
             read_block(0);
         }
@@ -318,10 +570,25 @@ class int_vector_buffer
             if (is_open()) {
                 if (!remove_file) {
                     write_block();
-                    if (0 < m_offset) { // in case of int_vector, write header and trailing zeros
+                }
+                wait_for_io();
+                if (!remove_file) {
+                    if (m_compressed) { // write block index and header
+                        block_compression::header h;
+                        h.width        = width();
+                        h.size         = m_size;
+                        h.block_size   = m_buffersize;
+                        h.index_offset = m_file_end;
+                        m_block_index.resize(block_compression::blocks(h), std::pair<uint64_t, uint64_t>(0, 0));
+                        m_ofile.seekp(m_file_end);
+                        block_compression::write_index(m_ofile, m_block_index);
+                        m_ofile.seekp(0, std::ios::beg);
+                        block_compression::write_header(m_ofile, h);
+                        assert(m_ofile.good());
+                    } else if (0 < m_offset) { // in case of int_vector, write header and trailing zeros
                         uint64_t size = m_size*width();
                         m_ofile.seekp(0, std::ios::beg);
-                        int_vector<t_width>::write_header(size, width(), m_ofile);
+                        int_vector<t_width>::write_header(size, width(), m_ofile, m_offset-(t_width ? 8 : 9));
                         assert(m_ofile.good());
                         uint64_t wb = (size+7)/8;
                         if (wb%8) {
@@ -353,6 +620,8 @@ class int_vector_buffer
         //! Swap method for int_vector_buffer.
         void swap(int_vector_buffer<t_width>& ivb) {
             if (this != &ivb) {
+                wait_for_io();
+                ivb.wait_for_io();
                 m_ifile.close();
                 ivb.m_ifile.close();
                 m_ofile.close();
@@ -372,6 +641,10 @@ class int_vector_buffer
                 std::swap(m_buffersize, ivb.m_buffersize);
                 std::swap(m_size, ivb.m_size);
                 std::swap(m_begin, ivb.m_begin);
+                std::swap(m_access, ivb.m_access);
+                std::swap(m_compressed, ivb.m_compressed);
+                std::swap(m_block_index, ivb.m_block_index);
+                std::swap(m_file_end, ivb.m_file_end);
             }
         }
 
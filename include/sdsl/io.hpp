@@ -24,6 +24,8 @@
 #include "util.hpp"
 #include "sdsl_concepts.hpp"
 #include "structure_tree.hpp"
+#include "block_compression.hpp"
+#include "construct_profile.hpp"
 #include <algorithm>
 #include <string>
 #include <vector>
@@ -41,6 +43,20 @@ namespace sdsl
 template<class T>
 bool load_from_file(T& v, const std::string& file);
 
+//! Load sdsl-object v from a file without copying the data of its int_vectors.
+/*!
+ * \param v    sdsl object to load.
+ * \param file Name of the serialized file.
+ * \par The file is memory mapped and the int_vectors of v point into the
+ *      mapping, so the pages are read on demand and shared by all processes
+ *      which load the same file. The mapping lives as long as one of the
+ *      int_vectors; it is replaced by a heap copy if the vector is resized.
+ *      Falls back to load_from_file for files in the ram file system.
+ * \sa mmap_ifstream
+ */
+template<class T>
+bool load_from_mapped_file(T& v, const std::string& file);
+
 //! Load an int_vector from a plain array of `num_bytes`-byte integers with X in \{0, 1,2,4,8\} from disk.
 // TODO: Remove ENDIAN dependency.
 template<class t_int_vec>
@@ -132,6 +148,13 @@ bool store_to_file(const char* v, const std::string& file);
 template<uint8_t t_width>
 bool store_to_file(const int_vector<t_width>& v, const std::string& file, bool write_fixed_as_variable=false);
 
+//! Store an int_vector in the block compressed format of int_vector_buffer
+/*! The file can be loaded by load_from_file and read by int_vector_buffer.
+ *  \sa block_compression.hpp
+ */
+template<uint8_t t_width>
+bool store_to_compressed_file(const int_vector<t_width>& v, const std::string& file);
+
 
 //! Store an int_vector as plain int_type array to disk
 template<class int_type, class t_int_vec>
@@ -176,12 +199,21 @@ double size_in_mega_bytes(const T& t);
 
 struct nullstream : std::ostream {
     struct nullbuf: std::streambuf {
+        std::streamoff m_pos = 0; // number of written bytes, see tellp
         int overflow(int c) {
+            if (!traits_type::eq_int_type(c, traits_type::eof()))
+                ++m_pos;
             return traits_type::not_eof(c);
         }
         int xputc(int) { return 0; }
-        std::streamsize xsputn(char const*, std::streamsize n) { return n; }
+        std::streamsize xsputn(char const*, std::streamsize n) { m_pos += n; return n; }
         int sync() { return 0; }
+        // int_vector::serialize pads its header depending on tellp
+        pos_type seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode) {
+            if (0 == off and std::ios_base::cur == way)
+                return pos_type(m_pos);
+            return pos_type(off_type(-1));
+        }
     } m_sbuf;
     nullstream(): std::ios(&m_sbuf), std::ostream(&m_sbuf), m_sbuf() {}
 };
@@ -442,6 +474,7 @@ bool load_from_cache(T& v, const std::string& key, const cache_config& config)
         if (util::verbose) {
             std::cerr << "Load `" << file << std::endl;
         }
+        construct_profile::count_read(util::file_size(file));
         return true;
     } else {
         std::cerr << "WARNING: Could not load file '";
@@ -460,6 +493,25 @@ bool store_to_cache(const T& v, const std::string& key, cache_config& config)
     std::string file = cache_file_name(key, config);
     if (store_to_file(v, file)) {
         config.file_map[std::string(key)] = file;
+        construct_profile::count_written(util::file_size(file));
+        return true;
+    } else {
+        std::cerr<<"WARNING: store_to_cache: could not store file `"<< file <<"`" << std::endl;
+        return false;
+    }
+}
+
+//! Stores the int_vector v as a resource in the cache.
+/*! The file is block compressed if config.compress_files is set.
+ */
+template<uint8_t t_width>
+bool store_to_cache(const int_vector<t_width>& v, const std::string& key, cache_config& config)
+{
+    std::string file = cache_file_name(key, config);
+    bool stored = config.compress_files ? store_to_compressed_file(v, file) : store_to_file(v, file);
+    if (stored) {
+        config.file_map[std::string(key)] = file;
+        construct_profile::count_written(util::file_size(file));
         return true;
     } else {
         std::cerr<<"WARNING: store_to_cache: could not store file `"<< file <<"`" << std::endl;
@@ -521,6 +573,42 @@ bool store_to_file(const int_vector<t_width>& v, const std::string& file, bool w
     return true;
 }
 
+template<uint8_t t_width>
+bool store_to_compressed_file(const int_vector<t_width>& v, const std::string& file)
+{
+    osfstream out(file, std::ios::binary | std::ios::trunc | std::ios::out);
+    if (!out) {
+        std::cerr<<"ERROR: util::store_to_compressed_file:: Could not open file `"<<file<<"`"<<std::endl;
+        return false;
+    } else {
+        if (util::verbose) {
+            std::cerr<<"INFO: store_to_compressed_file: `"<<file<<"`"<<std::endl;
+        }
+    }
+    block_compression::header h;
+    h.width      = v.width();
+    h.size       = v.size();
+    h.block_size = 1ULL<<20;
+    block_compression::index_type index(block_compression::blocks(h));
+    block_compression::write_header(out, h);
+    uint64_t offset = block_compression::HEADER_SIZE;
+    std::vector<uint64_t> values, encoded;
+    for (uint64_t b=0; b < index.size(); ++b) {
+        values.resize(std::min(h.block_size, h.size-b*h.block_size));
+        v.get_range(b*h.block_size, values.size(), values.data());
+        block_compression::encode(values.data(), values.size(), encoded);
+        out.write((const char*)encoded.data(), encoded.size()*8);
+        index[b] = std::pair<uint64_t, uint64_t>(offset, encoded.size()*8);
+        offset += encoded.size()*8;
+    }
+    h.index_offset = offset;
+    block_compression::write_index(out, index);
+    out.seekp(0);
+    block_compression::write_header(out, h);
+    out.close();
+    return true;
+}
+
 template<class T>
 bool load_from_file(T& v, const std::string& file)
 {
@@ -539,5 +627,26 @@ bool load_from_file(T& v, const std::string& file)
     return true;
 }
 
+template<class T>
+bool load_from_mapped_file(T& v, const std::string& file)
+{
+    if (is_ram_file(file)) {
+        return load_from_file(v, file);
+    }
+    mmap_ifstream in(file);
+    if (!in) {
+        if (util::verbose) {
+            std::cerr << "Could not map file `" << file << "`" << std::endl;
+        }
+        return false;
+    }
+    v.load(in);
+    in.close();
+    if (util::verbose) {
+        std::cerr << "Map file `" << file << "`" << std::endl;
+    }
+    return true;
+}
+
 }
 #endif
@@ -7,15 +7,170 @@
 
 #include "uintx_t.hpp"
 #include "util.hpp"
+#include "mmap_filebuf.hpp"
 #include <map>
 #include <iostream>
 #include <cstdlib>
 #include <mutex>
+#include <atomic>
 #include <chrono>
 
 namespace sdsl
 {
 
+//! Interface of the allocators which provide the memory of int_vectors
+/*! An int_vector uses the allocator which is active in its thread when
+ *  it is constructed (see mm::allocator_scope) for its whole lifetime.
+ */
+class mm_allocator
+{
+    public:
+        virtual ~mm_allocator() {}
+        //! Resizes the block p of old_size bytes to size bytes
+        /*! Behaves like realloc, i.e. p equal to nullptr allocates
+         *  a new block and the content is kept.
+         */
+        virtual void* reallocate(void* p, uint64_t old_size, uint64_t size) = 0;
+        //! Releases the block p of size bytes
+        virtual void deallocate(void* p, uint64_t size) = 0;
+};
+
+//! The default allocator, which uses realloc and free
+class malloc_allocator : public mm_allocator
+{
+    public:
+        void* reallocate(void* p, uint64_t, uint64_t size) override {
+            return ::realloc(p, size);
+        }
+        void deallocate(void* p, uint64_t) override {
+            free(p);
+        }
+};
+
+//! Allocator which places the blocks consecutively in one reserved region
+/*! Allocating a whole index from an arena avoids the fragmentation of the
+ *  heap by the many small support structures and keeps the index on few
+ *  (huge) pages. Blocks are aligned to cache lines. The space of a freed
+ *  block is only reused if it is the last block of the arena. If the
+ *  arena is full, the blocks are allocated by malloc.
+ *  The arena has to outlive all int_vectors which use it.
+ */
+class arena_allocator : public mm_allocator
+{
+    private:
+        char*           m_begin    = nullptr; // start of the region
+        uint64_t        m_capacity = 0;       // size of the region in bytes
+        uint64_t        m_used     = 0;       // bytes in use
+        uint64_t        m_last     = 0;       // offset of the last block
+        bool            m_hugepages= false;   // region backed by hugepages
+        util::spin_lock m_lock;
+
+        void* allocate(uint64_t size);
+
+    public:
+        //! Constructor
+        /*! \param capacity  Size of the region in bytes. The memory is only
+         *                   committed when it is used.
+         *  \param hugepages Back the region by hugepages. Uses hugetlbfs
+         *                   pages if available and transparent hugepages
+         *                   otherwise.
+         *  \param numa_node Bind the region to this NUMA node, -1 for the
+         *                   default policy of the process.
+         */
+        explicit arena_allocator(uint64_t capacity, bool hugepages=false, int numa_node=-1);
+        arena_allocator(const arena_allocator&) = delete;
+        arena_allocator& operator=(const arena_allocator&) = delete;
+        ~arena_allocator();
+
+        void* reallocate(void* p, uint64_t old_size, uint64_t size) override;
+        void deallocate(void* p, uint64_t size) override;
+
+        //! True if p lies inside the region of the arena
+        bool contains(const void* p) const {
+            return (const char*)p >= m_begin and (const char*)p < m_begin+m_capacity;
+        }
+        //! Size of the region in bytes
+        uint64_t capacity() const {
+            return m_capacity;
+        }
+        //! Number of bytes in use
+        uint64_t used() const {
+            return m_used;
+        }
+        //! True if the region is backed by hugetlbfs pages
+        bool hugepages() const {
+            return m_hugepages;
+        }
+};
+
+//! Allocator which places large blocks on hugepages from the start
+/*! Each block of at least threshold() bytes gets its own mapping which is
+ *  aligned to and rounded up to 2 MiB. Contrary to mm::map_hp no copy of
+ *  the int_vectors is made and no memory for a second copy is needed.
+ *  Every allocation falls back on its own: a block for which no hugetlbfs
+ *  page is left uses transparent hugepages, and a block which can not be
+ *  mapped at all, as well as every small block, is allocated by malloc.
+ *
+ *  Example:
+ *  \code
+ *  hugepage_allocator hp(hugepage_allocator::transparent);
+ *  mm::default_allocator(&hp); // all int_vectors of all threads
+ *  \endcode
+ */
+class hugepage_allocator : public mm_allocator
+{
+    public:
+        enum mode_type {
+            transparent, //!< Anonymous mappings advised by MADV_HUGEPAGE
+            hugetlb      //!< Pages of the hugetlbfs pool, transparent if it is empty
+        };
+        static const uint64_t HUGEPAGE_SIZE = 1ULL<<21;
+
+    private:
+        mode_type                    m_mode;
+        uint64_t                     m_threshold;
+        struct block {
+            uint64_t len;     // length of the mapping in bytes
+            bool     hugetlb; // mapping lies on hugetlbfs pages
+        };
+        std::map<uint64_t, block>    m_blocks;
+        uint64_t                     m_hugetlb_bytes = 0;
+        uint64_t                     m_mapped_bytes  = 0;
+        util::spin_lock              m_lock;
+
+        void* map(uint64_t size);
+        void unmap(void* p, uint64_t len, bool on_hugetlb);
+
+    public:
+        //! Constructor
+        /*! \param mode      Source of the hugepages.
+         *  \param threshold Blocks smaller than this are allocated by malloc.
+         */
+        explicit hugepage_allocator(mode_type mode=transparent, uint64_t threshold=HUGEPAGE_SIZE);
+        hugepage_allocator(const hugepage_allocator&) = delete;
+        hugepage_allocator& operator=(const hugepage_allocator&) = delete;
+        //! The blocks which are still allocated are released
+        ~hugepage_allocator();
+
+        void* reallocate(void* p, uint64_t old_size, uint64_t size) override;
+        void deallocate(void* p, uint64_t size) override;
+
+        mode_type mode() const {
+            return m_mode;
+        }
+        uint64_t threshold() const {
+            return m_threshold;
+        }
+        //! Bytes of the blocks which are mapped by the allocator
+        uint64_t mapped_bytes() const {
+            return m_mapped_bytes;
+        }
+        //! Bytes of the blocks which lie on hugetlbfs pages
+        uint64_t hugetlb_bytes() const {
+            return m_hugetlb_bytes;
+        }
+};
+
 class mm_item_base
 {
     public:
@@ -52,7 +207,8 @@ class mm_item : public mm_item_base
          */
         bool map_hp(uint64_t*& addr) {
             uint64_t len = size();
-            if (m_v->m_data != nullptr) {
+            if (m_v->m_data != nullptr and !m_v->m_mapped and
+                dynamic_cast<malloc_allocator*>(m_v->m_alloc) != nullptr) {
                 memcpy((char*)addr, m_v->m_data, len); // copy old data
                 free(m_v->m_data);
                 m_v->m_data = addr;
@@ -63,6 +219,9 @@ class mm_item : public mm_item_base
 
         //!
         bool unmap_hp() {
+            if (m_v->m_mapped or dynamic_cast<malloc_allocator*>(m_v->m_alloc) == nullptr) {
+                return true;
+            }
             uint64_t len = size();
             if (util::verbose) {
                 std::cerr<<"unmap int_vector of size "<< len <<std::endl;
@@ -74,7 +233,11 @@ class mm_item : public mm_item_base
             return true;
         }
 
+        //! Heap memory of the int_vector in bytes
         uint64_t size() {
+            if (m_v->m_mapped) {
+                return 0;
+            }
             return (((m_v->bit_size()+63)>>6)<<3);
         }
 };
@@ -102,42 +265,76 @@ class mm
 {
         friend class mm_initializer;
         typedef std::map<uint64_t, mm_item_base*> tMVecItem;
-        static tMVecItem m_items;
-        static uint64_t m_total_memory;
+        // Only while register_for_hp is enabled, vectors are registered
+        // for map_hp. They are distributed over shards by their address,
+        // so that threads which create and destroy vectors rarely wait
+        // for the same lock. Each shard is guarded by a spin lock, i.e.
+        // registering is striped locking, not lock-free.
+        struct alignas(64) item_shard {
+            util::spin_lock lock;
+            tMVecItem       items;
+        };
+        static const uint64_t SHARDS = 64;
+        static item_shard* shards();
+        static item_shard& shard(const void* v) {
+            return shards()[(((uint64_t)v>>4)*0x9E3779B97F4A7C15ULL)>>58];
+        }
         static uint64_t* m_data;
         static std::ostream* m_out;
         static std::chrono::microseconds m_granularity;
         static uint64_t m_pre_max_mem;
         static timer::time_point m_pre_rtime;
         static util::spin_lock m_spinlock;
+        static std::atomic<bool> m_register_hp;
+        static std::atomic<uint64_t> m_registered; // number of registered vectors
+
+        //! Heap memory of v in bytes
+        template<class int_vec_t>
+        static uint64_t heap_size(const int_vec_t* v) {
+            return v->m_mapped ? 0 : ((v->m_size+63)>>6)<<3;
+        }
 
     public:
         mm();
 
+        //! Adds delta bytes to the counter of the calling thread
+        /*! Only the calling thread writes its counter, so no lock or
+         *  atomic read-modify-write is necessary. The counters of all
+         *  threads are summed up by memory_usage.
+         */
+        static void add_memory(int64_t delta);
+
+        //! Accounts the memory of a new int_vector
+        /*! The heap memory of v is added to the counter of the calling
+         *  thread, unless v took it over from a moved vector. If
+         *  register_for_hp is enabled, v is also registered for map_hp.
+         */
         template<class int_vec_t>
         static void add(int_vec_t* v, bool moved=false) {
-            std::lock_guard<util::spin_lock> lock(m_spinlock);
-            if (mm::m_items.find((uint64_t)v) == mm::m_items.end()) {
-                mm_item_base* item = new mm_item<int_vec_t>(v);
-                if (false and util::verbose) {
-                    std::cout << "mm::add: add vector " << v << std::endl;
-                    std::cout.flush();
+            if (m_register_hp.load(std::memory_order_relaxed)) {
+                item_shard& s = shard(v);
+                std::lock_guard<util::spin_lock> lock(s.lock);
+                if (s.items.find((uint64_t)v) == s.items.end()) {
+                    s.items[(uint64_t)v] = new mm_item<int_vec_t>(v);
+                    m_registered.fetch_add(1, std::memory_order_relaxed);
                 }
-                mm::m_items[(uint64_t)v] = item;
-                if (!moved and item->size()) {
-                    log("");
-                    m_total_memory += item->size(); // add space
-                    log("");
-                }
-            } else {
-                if (false and util::verbose) std::cout << "mm::add: mm_item is already in the set" << std::endl;
+            }
+            uint64_t size = moved ? 0 : heap_size(v);
+            if (size) {
+                log("");
+                add_memory(size); // add space
+                log("");
             }
         }
 
         template<class int_vec_t>
         static void realloc(int_vec_t& v, const typename int_vec_t::size_type size) {
+            if (v.m_mapped) {
+                copy_from_mapping(v);
+            }
             bool do_realloc = ((size+63)>>6) != ((v.m_size+63)>>6);
             uint64_t old_size = ((v.m_size+63)>>6)<<3;
+            uint64_t old_alloc_size = v.m_data == nullptr ? 0 : ((v.m_size+64)>>6)<<3;
             v.m_size = size;                         // set new size
             // special case: bitvector of size 0
             if (do_realloc or v.m_data==nullptr) { // or (t_width==1 and m_size==0) ) {
@@ -146,7 +343,7 @@ class mm
                 // We need this padding since rank data structures do a memory
                 // access to this padding to answer rank(size()) if size()%64 ==0.
                 // Note that this padding is not counted in the serialize method!
-                data = (uint64_t*)::realloc(v.m_data, (((v.m_size+64)>>6)<<3)); // if m_data == nullptr realloc
+                data = (uint64_t*)v.m_alloc->reallocate(v.m_data, old_alloc_size, (((v.m_size+64)>>6)<<3)); // if m_data == nullptr realloc
                 // Method realloc is equivalent to malloc if m_data == nullptr.
                 // If size is zero and ptr is not nullptr, a new, minimum sized object is allocated and the original object is freed.
                 // The allocated memory is aligned such that it can be used for any data type, including AltiVec- and SSE-related types.
@@ -161,43 +358,169 @@ class mm
             }
             if (old_size != ((v.m_size+63)>>6)<<3) {
                 log("");
+                add_memory((int64_t)(((v.m_size+63)>>6)<<3) - (int64_t)old_size); // replace old space by new space
+                log("");
+            }
+        }
+
+        //! Accounts the release of an int_vector and unregisters it
+        /*! Takes a lock only if vectors are registered for map_hp.
+         *  A vector is destroyed after its construction has completed,
+         *  so it sees its own registration in m_registered.
+         */
+        template<class int_vec_t>
+        static void remove(int_vec_t* v) {
+            if (m_registered.load(std::memory_order_relaxed) > 0) {
+                mm_item_base* item = nullptr;
                 {
-                    std::lock_guard<util::spin_lock> lock(m_spinlock);
-                    m_total_memory -= old_size; // subtract old space
-                    m_total_memory += ((v.m_size+63)>>6)<<3; // add new space
+                    item_shard& s = shard(v);
+                    std::lock_guard<util::spin_lock> lock(s.lock);
+                    auto it = s.items.find((uint64_t)v);
+                    if (it != s.items.end()) {
+                        item = it->second;
+                        s.items.erase(it);
+                        m_registered.fetch_sub(1, std::memory_order_relaxed);
+                    }
                 }
+                delete item;
+            }
+            uint64_t size = heap_size(v);
+            if (size) {
+                log("");
+                add_memory(-(int64_t)size); // delete space
                 log("");
             }
         }
 
+        //! Lets v point to its serialized data inside a memory mapped stream
+        /*! \param v    An int_vector whose header was just read from in.
+         *  \param in   The stream.
+         *  \param size The bit size of v read from the header.
+         *  \return True, if in reads from a mmap_filebuf and the read
+         *          position is 8-byte aligned. Then the data of v is the
+         *          part of the mapping at the read position, which is
+         *          skipped in the stream. Otherwise nothing is done.
+         *  The mapping is copied to the heap as soon as v is resized.
+         */
         template<class int_vec_t>
-        static void remove(int_vec_t* v) {
-            std::lock_guard<util::spin_lock> lock(m_spinlock);
-            if (mm::m_items.find((uint64_t)v) != mm::m_items.end()) {
-                if (false and util::verbose) {
-                    std::cout << "mm:remove: remove vector " << v << std::endl;
-                };
-                mm_item_base* item = m_items[(uint64_t)v];
-                if (item->size()) {
+        static bool map(int_vec_t& v, std::istream& in, const typename int_vec_t::size_type size) {
+            mmap_filebuf* buf = dynamic_cast<mmap_filebuf*>(in.rdbuf());
+            uint64_t len = ((size+63)>>6)<<3;
+            if (buf == nullptr or !in.good() or buf->remaining() < len) {
+                return false;
+            }
+            const char* data = buf->position();
+            // m_data is accessed as uint64_t, so unaligned data is copied
+            // by the caller. int_vector::serialize pads the header to align
+            // the data, so this only happens for files without padding.
+            if (reinterpret_cast<uintptr_t>(data) % sizeof(uint64_t)) {
+                return false;
+            }
+            ref_mapping(data);
+            if (v.m_mapped) {
+                unref_mapping(v.m_data);
+            } else {
+                uint64_t old_size = ((v.m_size+63)>>6)<<3;
+                v.m_alloc->deallocate(v.m_data, ((v.m_size+64)>>6)<<3);
+                if (old_size) {
                     log("");
-                    m_total_memory -= item->size(); // delete space
+                    add_memory(-(int64_t)old_size);
                     log("");
                 }
-                mm::m_items.erase((uint64_t)v);
-                delete item;
-            } else {
-                if (false and util::verbose) {
-                    std::cout << "mm:remove: mm_item is not in the set" << std::endl;
-                };
             }
+            v.m_data   = (uint64_t*)data;
+            v.m_size   = size;
+            v.m_mapped = true;
+            in.seekg(len, std::ios_base::cur);
+            return true;
         }
 
+        //! Replaces the mapped data of v by a copy on the heap
+        template<class int_vec_t>
+        static void copy_from_mapping(int_vec_t& v) {
+            uint64_t len = ((v.m_size+63)>>6)<<3;
+            // one additional word as padding, see realloc
+            uint64_t* data = (uint64_t*)v.m_alloc->reallocate(nullptr, 0, len+8);
+            if (data == nullptr) {
+                throw std::bad_alloc();
+            }
+            memcpy(data, v.m_data, len);
+            data[len>>3] = 0;
+            unref_mapping(v.m_data);
+            v.m_data   = data;
+            v.m_mapped = false;
+            if (len) {
+                log("");
+                add_memory(len);
+                log("");
+            }
+        }
+
+        //! Maps a file privately into memory, followed by at least one zero page
+        /*! \param file Name of the file.
+         *  \param size Is set to the size of the file in bytes.
+         *  \return Start of the mapping or nullptr if it failed. The caller
+         *          holds one reference, see unref_mapping.
+         */
+        static const char* map_file(const std::string& file, uint64_t& size);
+
+        //! Adds a reference to the mapping which contains address p
+        static void ref_mapping(const void* p);
+
+        //! Removes a reference to the mapping which contains address p
+        /*! The mapping is removed if there is no reference left.
+         */
+        static void unref_mapping(const void* p);
+
+        //! Allocator of the int_vectors which are constructed by the calling thread
+        static mm_allocator* allocator();
+
+        //! The allocator which is used outside of an allocator_scope
+        static mm_allocator* default_allocator();
+
+        //! Replaces the allocator which is used outside of an allocator_scope
+        /*! \param alloc The new default allocator; nullptr restores the
+         *               malloc_allocator. It has to outlive all
+         *               int_vectors which use it.
+         */
+        static void default_allocator(mm_allocator* alloc);
+
+        //! Sets the allocator of the calling thread during its lifetime
+        /*! Example:
+         *  \code
+         *  arena_allocator arena(1ULL<<30, true);
+         *  {
+         *      mm::allocator_scope scope(&arena);
+         *      csa_wt<> csa;
+         *      load_from_file(csa, file); // whole index lies in the arena
+         *  }
+         *  \endcode
+         */
+        class allocator_scope
+        {
+            private:
+                mm_allocator* m_prev;
+            public:
+                explicit allocator_scope(mm_allocator* alloc);
+                allocator_scope(const allocator_scope&) = delete;
+                allocator_scope& operator=(const allocator_scope&) = delete;
+                ~allocator_scope();
+        };
+
         static void log_stream(std::ostream* out);
 
         static void log_granularity(std::chrono::microseconds granularity);
 
+        //! Number of bytes used by all int_vectors
+        /*! Sums up the counters of all threads. The result is exact if
+         *  no other thread changes an int_vector at the same time.
+         */
+        static uint64_t memory_usage();
+
         static void log(const std::string& msg) {
             if (m_out != nullptr) {
+                std::lock_guard<util::spin_lock> lock(m_spinlock);
+                uint64_t total_memory = memory_usage();
                 auto cur = timer::now();
                 auto log_time = cur-m_pre_rtime;
                 if (log_time >= m_granularity
@@ -207,18 +530,33 @@ class mm
                              << "" << std::endl;
                     if (msg.size() > 0) {  // output if msg is set
                         (*m_out) << duration_cast<std::chrono::microseconds>(log_time).count() << ";"
-                                 << m_total_memory << ";"
+                                 << total_memory << ";"
                                  << msg << std::endl;
                     }
 
-                    m_pre_max_mem = m_total_memory; // reset memory
+                    m_pre_max_mem = total_memory; // reset memory
                     m_pre_rtime = cur;
                 } else {
-                    m_pre_max_mem = std::max(m_pre_max_mem, m_total_memory);
+                    m_pre_max_mem = std::max(m_pre_max_mem, total_memory);
                 }
             }
         }
 
+        //! Enables or disables the registration of int_vectors for map_hp
+        /*! Registration costs a heap allocation and a lock per int_vector,
+         *  so it is disabled by default. Enable it before the structures
+         *  which should be mapped by map_hp are constructed or loaded.
+         *  Vectors stay registered until they are destroyed.
+         */
+        static void register_for_hp(bool enable=true) {
+            m_register_hp.store(enable);
+        }
+
+        //! Copies all registered int_vectors into one hugetlbfs mapping
+        /*! Needs twice the memory of the int_vectors during the copy.
+         *  Only vectors created while register_for_hp was enabled are
+         *  copied. Use hugepage_allocator to get hugepages from the start.
+         */
         static bool map_hp();
         static bool unmap_hp();
 };
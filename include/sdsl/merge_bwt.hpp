@@ -0,0 +1,184 @@
+/*!\file merge_bwt.hpp
+   \brief merge_bwt.hpp contains methods to add a text to an index by merging BWTs instead of a full construction.
+*/
+#ifndef INCLUDED_SDSL_MERGE_BWT
+#define INCLUDED_SDSL_MERGE_BWT
+
+#include "construct.hpp"
+#include "blockwise_bwt.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace sdsl
+{
+
+//! Number of symbols in the text of a CSA which are smaller than c
+/*! \param csa    The CSA.
+ *  \param c      A symbol, which does not have to occur in the text.
+ *  \param occurs Set to true if c occurs in the text.
+ */
+template<class t_csa>
+typename t_csa::size_type csa_smaller_count(const t_csa& csa, uint64_t c, bool& occurs)
+{
+    typedef typename t_csa::size_type size_type;
+    // comp2char is sorted, find the first symbol >= c
+    size_type lb = 0, rb = csa.sigma;
+    while (lb < rb) {
+        size_type mid = lb + (rb-lb)/2;
+        if ((uint64_t)csa.comp2char[mid] < c) {
+            lb = mid+1;
+        } else {
+            rb = mid;
+        }
+    }
+    occurs = lb < csa.sigma and (uint64_t)csa.comp2char[lb] == c;
+    return csa.C[lb];
+}
+
+//! Merges the cached text, SA and BWT of an index with a new text
+/*! The merged text consists of the new text without its terminating 0
+ *  followed by the old text. So the suffixes of the old text keep their
+ *  order and only the suffixes of the new text have to be sorted:
+ *    (1) Each suffix of the new text is searched backwards in the old
+ *        index, which yields the number of old suffixes which are smaller.
+ *    (2) The new suffixes are sorted among themselves by
+ *        blockwise_bwt::sort_block.
+ *    (3) The old SA and BWT are streamed and the new suffixes are
+ *        inserted between their rows.
+ *
+ *  \tparam t_width Width of the text. 0==integer alphabet, 8=byte alphabet.
+ *  \param csa        Index of the old text. Any CSA, e.g. a csa_wt.
+ *  \param old_config Cache of the old text, e.g. the cache of the construct()
+ *                    call of csa with config.delete_files=false.
+ *  \param new_config Cache of the new text.
+ *  \param config     Cache of the merged text.
+ *  \par Time complexity
+ *       \f$ \Order{m \cdot t_{rank\_bwt} + n} \f$, where \f$m\f$ is the
+ *       length of the new and \f$n\f$ the length of the old text. The
+ *       old text is not suffix sorted again.
+ *  \par Space complexity
+ *       \f$ m \log n + 3m \log m \f$ bits plus the stream buffers.
+ *  \pre Keys in old_config:
+ *         * constants::KEY_TEXT for t_width=8 or constants::KEY_TEXT_INT for t_width=0
+ *         * constants::KEY_SA
+ *         * constants::KEY_BWT for t_width=8 or constants::KEY_BWT_INT for t_width=0
+ *       Key in new_config:
+ *         * constants::KEY_TEXT for t_width=8 or constants::KEY_TEXT_INT for t_width=0
+ *  \post Text, SA and BWT of the merged text exist in the cache of config.
+ *  \par Reference
+ *    Juha Kärkkäinen, Dominik Kempa:
+ *    Engineering a Lightweight External Memory Suffix Array Construction Algorithm.
+ *    ICABD 2014
+ */
+template<uint8_t t_width, class t_csa>
+void merge_bwt(const t_csa& csa, const cache_config& old_config, const cache_config& new_config, cache_config& config)
+{
+    static_assert(t_width == 0 or t_width == 8 , "merge_bwt: width must be `0` for integer alphabet and `8` for byte alphabet");
+    typedef int_vector<>::size_type size_type;
+    const char* KEY_TEXT = key_text_trait<t_width>::KEY_TEXT;
+    const char* KEY_BWT  = key_bwt_trait<t_width>::KEY_BWT;
+
+    int_vector<t_width> text;
+    if (!load_from_cache(text, KEY_TEXT, new_config)) {
+        throw std::logic_error("merge_bwt: the new text is not cached");
+    }
+    text.resize(text.size()-1); // remove the terminating 0
+    const size_type m = text.size();
+    const size_type buffer_size = construct_buffer_size(config, 1000000, size_in_bytes(text)+7*m*8, 7);
+    int_vector_buffer<t_width> old_text(cache_file_name(KEY_TEXT, old_config), std::ios::in, buffer_size);
+    const size_type n_old = old_text.size();
+    const size_type n = m + n_old;
+    if (csa.size() != n_old) {
+        throw std::logic_error("merge_bwt: the CSA does not belong to the cached text");
+    }
+
+    //  (1) smaller[i] = number of old suffixes smaller than text[i..]+old text
+    const size_type old_rank = csa(0);
+    int_vector<> smaller;
+    blockwise_bwt::count_smaller(text, old_rank, n_old, [&csa](uint64_t r, uint64_t c) -> uint64_t {
+        bool occurs = false;
+        size_type c_begin = csa_smaller_count(csa, c, occurs);
+        return c_begin + (occurs ? csa.rank_bwt(r, c) : 0);
+    }, smaller);
+
+    //  (2) sort the new suffixes
+    int_vector<> sa;
+    blockwise_bwt::sort_block(text, smaller, old_rank, old_text[0], sa);
+
+    //  (3) insert the new suffixes between the rows of the old SA and BWT
+    int_vector_buffer<> old_sa(cache_file_name(constants::KEY_SA, old_config), std::ios::in, buffer_size);
+    int_vector_buffer<t_width> old_bwt(cache_file_name(KEY_BWT, old_config), std::ios::in, buffer_size);
+    const uint8_t width = std::max(text.width(), old_text.width());
+    int_vector_buffer<> sa_buf(cache_file_name(constants::KEY_SA, config), std::ios::out, buffer_size, bits::hi(n)+1);
+    int_vector_buffer<t_width> bwt_buf(cache_file_name(KEY_BWT, config), std::ios::out, buffer_size, width, false, config.compress_files);
+    old_sa.access(forward_access);
+    old_bwt.access(forward_access);
+    sa_buf.access(forward_access);
+    bwt_buf.access(forward_access);
+    size_type r_old = 0, k = 0;
+    auto copy_old_rows = [&](size_type end) {
+        for (; r_old < end; ++r_old, ++k) {
+            size_type s = old_sa[r_old];
+            sa_buf[k] = s + m;
+            bwt_buf[k] = (s == 0 and m > 0) ? (uint64_t)text[m-1] : (uint64_t)old_bwt[r_old];
+        }
+    };
+    for (size_type j=0; j < m; ++j) {
+        size_type i = sa[j];
+        copy_old_rows(smaller[i]);
+        sa_buf[k] = i;
+        bwt_buf[k] = i > 0 ? (uint64_t)text[i-1] : 0;
+        ++k;
+    }
+    copy_old_rows(n_old);
+    old_sa.close();
+    old_bwt.close();
+    sa_buf.close();
+    bwt_buf.close();
+    util::clear(sa);
+    util::clear(smaller);
+
+    //  (4) the merged text
+    {
+        int_vector_buffer<t_width> text_buf(cache_file_name(KEY_TEXT, config), std::ios::out, buffer_size, width);
+        for (size_type i=0; i < m; ++i) {
+            text_buf.push_back(text[i]);
+        }
+        for (size_type i=0; i < n_old; ++i) {
+            text_buf.push_back(old_text[i]);
+        }
+    }
+    register_cache_file(KEY_TEXT, config);
+    register_cache_file(constants::KEY_SA, config);
+    register_cache_file(KEY_BWT, config);
+}
+
+//! Constructs an index of a new text followed by an old text from their caches
+/*! The text, the SA and the BWT are merged by merge_bwt and the remaining
+ *  parts of the index, e.g. the LCP array of a CST, are constructed by
+ *  construct(). Set config.delete_files=false to keep the merged cache for
+ *  the next merge.
+ *  \param idx        The index, e.g. a csa_wt or a cst_sct3.
+ *  \param csa        Index of the old text.
+ *  \param old_config Cache of the old text, see merge_bwt.
+ *  \param new_config Cache of the new text, see merge_bwt.
+ *  \param config     Cache of the merged text.
+ */
+template<class t_index, class t_csa>
+void construct_merged(t_index& idx, const t_csa& csa, const cache_config& old_config,
+                      const cache_config& new_config, cache_config& config)
+{
+    construct_profile* profile = construct_profile::current();
+    if (profile != nullptr and profile->name().empty()) {
+        profile->name(util::class_name(idx));
+    }
+    {
+        construct_profile::phase phase("merge");
+        merge_bwt<t_index::alphabet_category::WIDTH>(csa, old_config, new_config, config);
+    }
+    // the text, SA and BWT are cached, so the text file is not read
+    construct(idx, "", config, t_index::alphabet_category::WIDTH/8);
+}
+
+} // end namespace sdsl
+#endif
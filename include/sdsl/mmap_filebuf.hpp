@@ -0,0 +1,62 @@
+/*!\file mmap_filebuf.hpp
+   \brief mmap_filebuf.hpp contains a stream buffer which reads from a memory mapped file.
+*/
+#ifndef INCLUDED_SDSL_MMAP_FILEBUF
+#define INCLUDED_SDSL_MMAP_FILEBUF
+
+#include <streambuf>
+#include <string>
+#include <cstdint>
+
+namespace sdsl
+{
+
+//! A read-only stream buffer on top of a memory mapped file.
+/*! The whole file is the get area of the buffer, so reading does not
+ *  need any system call. int_vector::load detects this buffer and lets
+ *  the loaded vector point directly into the mapping instead of copying
+ *  its data (see mm::map). The mapping is private, i.e. the pages are
+ *  shared with all processes which map the same file until they are
+ *  written, and it is kept alive as long as a vector points into it.
+ */
+class mmap_filebuf : public std::streambuf
+{
+    private:
+        char*    m_data = nullptr; // start of the mapping
+        uint64_t m_size = 0;       // size of the mapped file in bytes
+
+    public:
+        mmap_filebuf();
+        mmap_filebuf(const mmap_filebuf&) = delete;
+        mmap_filebuf& operator=(const mmap_filebuf&) = delete;
+        virtual ~mmap_filebuf();
+
+        //! Maps the file; returns nullptr if this fails.
+        mmap_filebuf* open(const std::string& file);
+
+        bool is_open();
+
+        mmap_filebuf* close();
+
+        //! Address of the current read position.
+        const char* position() const {
+            return gptr();
+        }
+
+        //! Number of bytes after the current read position.
+        uint64_t remaining() const {
+            return egptr()-gptr();
+        }
+
+    protected:
+        pos_type
+        seekoff(off_type off, std::ios_base::seekdir way,
+                std::ios_base::openmode which = std::ios_base::in) override;
+
+        pos_type
+        seekpos(pos_type sp, std::ios_base::openmode which = std::ios_base::in) override;
+};
+
+}
+
+#endif
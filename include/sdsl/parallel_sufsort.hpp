@@ -0,0 +1,610 @@
+/*!\file parallel_sufsort.hpp
+   \brief parallel_sufsort.hpp contains a multithreaded suffix array construction by induced sorting.
+*/
+#ifndef INCLUDED_SDSL_PARALLEL_SUFSORT
+#define INCLUDED_SDSL_PARALLEL_SUFSORT
+
+#include "int_vector.hpp"
+#include "sais.hpp"
+#include "util.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace sdsl
+{
+
+//! Multithreaded suffix sorting by induced sorting (parallel SA-IS)
+/*! Performs the same steps as sais::sort. The linear scans, i.e. the
+ *  suffix types, the bucket sizes, the placement and compaction of the LMS
+ *  suffixes and the naming of the LMS substrings, are split into one chunk
+ *  per thread.
+ *
+ *  The induced sorting scans the suffix array in blocks of final entries,
+ *  i.e. entries to which no entry of the block induces a suffix. The
+ *  threads look up the preceding symbols of the block in parallel. Then
+ *  they write the induced suffixes to their buckets, in parallel if the
+ *  alphabet is small. Blocks are short if a bucket is filled by long runs
+ *  of equal symbols; such blocks are processed by one thread.
+ *
+ *  The reduced text is sorted recursively in the same way. Texts shorter
+ *  than MIN_SIZE and a single thread are sorted by sais::sort.
+ *
+ *  \par Time complexity
+ *       \f$ \Order{n+\sigma} \f$ work.
+ *  \par Space complexity
+ *       The text, \f$ 4n \f$ bytes for \f$ n < 2^{32}-1 \f$ and \f$ 8n \f$
+ *       bytes otherwise, \f$ 2n \f$ bits for the suffix types and the
+ *       L-parts of the buckets, two arrays
+ *       of \f$\sigma\f$ integers for the buckets, two blocks of
+ *       BLOCK_SIZE integers and, for small alphabets, \f$\sigma\f$
+ *       counters per thread. That is as much as sais::sort plus a few MiB.
+ *  \par Reference
+ *    Julian Labeit, Julian Shun, Guy E. Blelloch:
+ *    Parallel lightweight wavelet tree, suffix array and FM-index construction.
+ *    J. Discrete Algorithms 43: 2-17 (2017)
+ */
+namespace parallel_sufsort
+{
+
+using util::parallel_for;
+
+//! Texts shorter than this are sorted by sais::sort
+const uint64_t MIN_SIZE = 1ULL<<16;
+//! Maximal number of entries of a block of the induced sorting
+const uint64_t BLOCK_SIZE = 1ULL<<18;
+//! Blocks with fewer entries are processed by one thread
+const uint64_t MIN_BLOCK_SIZE = 1ULL<<12;
+
+//! The range [b, e) of thread t in [0, n); b is a multiple of 64.
+inline void chunk(uint64_t n, uint32_t threads, uint32_t t, uint64_t& b, uint64_t& e)
+{
+    uint64_t size = (((n+threads-1)/threads+63)/64)*64;
+    b = std::min(n, t*size);
+    e = std::min(n, b+size);
+}
+
+//! Sets a[b..e) to x.
+template<class t_idx>
+void fill(t_idx* a, uint64_t b, uint64_t e, t_idx x, uint32_t threads)
+{
+    parallel_for(threads, [&](uint32_t t) {
+        uint64_t cb, ce;
+        chunk(e-b, threads, t, cb, ce);
+        std::fill(a+b+cb, a+b+ce, x);
+    });
+}
+
+//! Moves the entries of a[0..n) which satisfy keep to the front; returns their number.
+template<class t_idx, class t_pred>
+uint64_t compact(t_idx* a, uint64_t n, uint32_t threads, t_pred keep)
+{
+    std::vector<uint64_t> cnt(threads, 0);
+    parallel_for(threads, [&](uint32_t t) {
+        uint64_t b, e;
+        chunk(n, threads, t, b, e);
+        uint64_t m = b;
+        for (uint64_t i=b; i < e; ++i) {
+            if (keep(a[i])) {
+                a[m++] = a[i];
+            }
+        }
+        cnt[t] = m-b;
+    });
+    uint64_t m = 0;
+    for (uint32_t t=0; t < threads; ++t) {
+        uint64_t b, e;
+        chunk(n, threads, t, b, e);
+        memmove(a+m, a+b, cnt[t]*sizeof(t_idx));
+        m += cnt[t];
+    }
+    return m;
+}
+
+//! Moves the entries of a[0..n) which satisfy keep to the back; returns their number.
+template<class t_idx, class t_pred>
+uint64_t compact_back(t_idx* a, uint64_t n, uint32_t threads, t_pred keep)
+{
+    std::vector<uint64_t> cnt(threads, 0);
+    parallel_for(threads, [&](uint32_t t) {
+        uint64_t b, e;
+        chunk(n, threads, t, b, e);
+        uint64_t m = e;
+        for (uint64_t i=e; i > b; --i) {
+            if (keep(a[i-1])) {
+                a[--m] = a[i-1];
+            }
+        }
+        cnt[t] = e-m;
+    });
+    uint64_t m = n;
+    for (uint32_t t=threads; t > 0; --t) {
+        uint64_t b, e;
+        chunk(n, threads, t-1, b, e);
+        m -= cnt[t-1];
+        memmove(a+m, a+e-cnt[t-1], cnt[t-1]*sizeof(t_idx));
+    }
+    return n-m;
+}
+
+//! The suffix types of s[0..n): stype[i] is set if suffix i is smaller than suffix i+1.
+template<class t_text>
+void classify(const t_text& s, uint64_t n, bit_vector& stype, uint32_t threads)
+{
+    // The type of the last run of equal symbols of a chunk may depend on
+    // the next chunk. It is first set to L and corrected afterwards.
+    std::vector<uint64_t> open(threads, n);
+    parallel_for(threads, [&](uint32_t t) {
+        uint64_t b, e;
+        chunk(n, threads, t, b, e);
+        if (b >= e) {
+            return;
+        }
+        bool cur = false; // the last suffix is L-type
+        if (e < n) {
+            if (s[e-1] == s[e]) {
+                uint64_t k = e-1;
+                while (k > b and s[k-1] == s[k]) {
+                    --k;
+                }
+                open[t] = k;
+            } else {
+                cur = s[e-1] < s[e];
+            }
+        }
+        stype[e-1] = cur;
+        for (uint64_t i=e-1; i-- > b;) {
+            if (s[i] != s[i+1]) {
+                cur = s[i] < s[i+1];
+            }
+            stype[i] = cur;
+        }
+    });
+    for (uint32_t t=threads; t-- > 0;) {
+        uint64_t b, e;
+        chunk(n, threads, t, b, e);
+        if (open[t] < e and stype[e]) {
+            for (uint64_t i=open[t]; i < e; i += 64) {
+                uint8_t len = std::min(e-i, (uint64_t)64);
+                stype.set_int(i, bits::lo_set[len], len);
+            }
+        }
+    }
+}
+
+//! Sorts the suffixes of s[0..n) with symbols in [0..sigma) into sa[0..n) with the given number of threads.
+template<class t_idx, class t_text>
+void sort(const t_text& s, t_idx* sa, uint64_t n, uint64_t sigma, uint32_t threads)
+{
+    if (threads <= 1 or n < MIN_SIZE) {
+        sais::sort<t_idx>(s, sa, n, sigma);
+        return;
+    }
+    const t_idx EMPTY = std::numeric_limits<t_idx>::max();
+    const uint32_t p = threads;
+    // per thread bucket counters are used if their prefix sums are cheap
+    // compared to the blocks
+    const bool small = sigma*p <= BLOCK_SIZE/4;
+    const uint64_t min_block = std::max(MIN_BLOCK_SIZE, small ? 4*sigma*p : 0);
+
+    bit_vector stype(n, 0);
+    classify(s, n, stype, p);
+    auto is_lms = [&](uint64_t i) {
+        return i > 0 and i < n and stype[i] and !stype[i-1];
+    };
+
+    // cnt holds the bucket sizes and, until the buckets are set up, bkt
+    // the number of L-suffixes per bucket
+    std::vector<t_idx> cnt(sigma, 0), bkt(sigma, 0);
+    std::vector<std::vector<t_idx>> tcnt;
+    if (small) {
+        tcnt.assign(p, std::vector<t_idx>(sigma, 0));
+        parallel_for(p, [&](uint32_t t) {
+            uint64_t b, e;
+            chunk(n, p, t, b, e);
+            for (uint64_t i=b; i < e; ++i) {
+                ++tcnt[t][s[i]];
+            }
+        });
+        for (uint32_t t=0; t < p; ++t) {
+            for (uint64_t c=0; c < sigma; ++c) {
+                cnt[c] += tcnt[t][c];
+            }
+        }
+        parallel_for(p, [&](uint32_t t) {
+            uint64_t b, e;
+            chunk(n, p, t, b, e);
+            std::fill(tcnt[t].begin(), tcnt[t].end(), 0);
+            for (uint64_t i=b; i < e; ++i) {
+                tcnt[t][s[i]] += !stype[i];
+            }
+        });
+        for (uint32_t t=0; t < p; ++t) {
+            for (uint64_t c=0; c < sigma; ++c) {
+                bkt[c] += tcnt[t][c];
+            }
+        }
+    } else {
+        for (uint64_t i=0; i < n; ++i) {
+            ++cnt[s[i]];
+            bkt[s[i]] += !stype[i];
+        }
+    }
+    // lslot[k] is set if sa[k] lies in the L-part of its bucket
+    bit_vector lslot(n, 0);
+    for (uint64_t c=0, b=0; c < sigma; b += cnt[c++]) {
+        for (uint64_t i=b; i < b+bkt[c]; i += 64) {
+            uint8_t len = std::min(b+bkt[c]-i, (uint64_t)64);
+            lslot.set_int(i, bits::lo_set[len], len);
+        }
+    }
+    auto bucket_starts = [&]() {
+        t_idx sum = 0;
+        for (uint64_t c=0; c < sigma; ++c) {
+            bkt[c] = sum;
+            sum += cnt[c];
+        }
+    };
+    auto bucket_ends = [&]() {
+        t_idx sum = 0;
+        for (uint64_t c=0; c < sigma; ++c) {
+            sum += cnt[c];
+            bkt[c] = sum;
+        }
+    };
+
+    // the suffixes induced by a block and their first symbols
+    std::vector<t_idx> induced(BLOCK_SIZE), symbol(BLOCK_SIZE);
+    // induces from the final entries sa[lo..hi) in the direction of the pass
+    auto induce_block = [&](uint64_t lo, uint64_t hi, bool lpass) {
+        if (hi-lo < min_block) {
+            if (lpass) {
+                for (uint64_t k=lo; k < hi; ++k) {
+                    t_idx j = sa[k];
+                    if (j != EMPTY and j > 0 and !stype[j-1]) {
+                        sa[bkt[s[j-1]]++] = j-1;
+                    }
+                }
+            } else {
+                for (uint64_t k=hi; k-- > lo;) {
+                    t_idx j = sa[k];
+                    if (j != EMPTY and j > 0 and stype[j-1]) {
+                        sa[--bkt[s[j-1]]] = j-1;
+                    }
+                }
+            }
+            return;
+        }
+        // (a) look up the induced suffixes and their buckets
+        parallel_for(p, [&](uint32_t t) {
+            uint64_t b, e;
+            chunk(hi-lo, p, t, b, e);
+            if (small) {
+                std::fill(tcnt[t].begin(), tcnt[t].end(), 0);
+            }
+            for (uint64_t k=b; k < e; ++k) {
+                t_idx j = sa[lo+k];
+                if (j != EMPTY and j > 0 and stype[j-1] != lpass) {
+                    induced[k] = j-1;
+                    symbol[k] = s[j-1];
+                    if (small) {
+                        ++tcnt[t][symbol[k]];
+                    }
+                } else {
+                    induced[k] = EMPTY;
+                }
+            }
+        });
+        if (!small) {
+            // (b) replace the symbols by the positions of the sequential scan
+            if (lpass) {
+                for (uint64_t k=0; k < hi-lo; ++k) {
+                    if (induced[k] != EMPTY) {
+                        symbol[k] = bkt[symbol[k]]++;
+                    }
+                }
+            } else {
+                for (uint64_t k=hi-lo; k-- > 0;) {
+                    if (induced[k] != EMPTY) {
+                        symbol[k] = --bkt[symbol[k]];
+                    }
+                }
+            }
+            // (c) write them in parallel
+            parallel_for(p, [&](uint32_t t) {
+                uint64_t b, e;
+                chunk(hi-lo, p, t, b, e);
+                for (uint64_t k=b; k < e; ++k) {
+                    if (induced[k] != EMPTY) {
+                        sa[symbol[k]] = induced[k];
+                    }
+                }
+            });
+            return;
+        }
+        // (b) the range of each thread in each bucket
+        for (uint64_t c=0; c < sigma; ++c) {
+            if (lpass) {
+                for (uint32_t t=0; t < p; ++t) {
+                    t_idx x = tcnt[t][c];
+                    tcnt[t][c] = bkt[c];
+                    bkt[c] += x;
+                }
+            } else {
+                for (uint32_t t=p; t-- > 0;) {
+                    t_idx x = tcnt[t][c];
+                    tcnt[t][c] = bkt[c];
+                    bkt[c] -= x;
+                }
+            }
+        }
+        // (c) write them in parallel
+        parallel_for(p, [&](uint32_t t) {
+            uint64_t b, e;
+            chunk(hi-lo, p, t, b, e);
+            std::vector<t_idx>& pos = tcnt[t];
+            if (lpass) {
+                for (uint64_t k=b; k < e; ++k) {
+                    if (induced[k] != EMPTY) {
+                        sa[pos[symbol[k]]++] = induced[k];
+                    }
+                }
+            } else {
+                for (uint64_t k=e; k-- > b;) {
+                    if (induced[k] != EMPTY) {
+                        sa[--pos[symbol[k]]] = induced[k];
+                    }
+                }
+            }
+        });
+    };
+    // induces the order of the L- and S-type suffixes from the LMS suffixes in sa
+    auto induce = [&]() {
+        // Every suffix is written before the scan reaches it. So in the
+        // L-part of a bucket the entries up to the fill pointer are final
+        // and the S-part does not change. All entries before the fill
+        // pointer of the first bucket with an unwritten L-part are final;
+        // the entries induced from them are written behind it. A bucket is
+        // complete if its fill pointer was passed by the scan or points to
+        // an S-part or to a written entry of the next bucket.
+        bucket_starts();
+        sa[bkt[s[n-1]]++] = n-1; // the last suffix is L-type and follows the sentinel
+        for (uint64_t f=0, i=0; i < n;) {
+            while (f < sigma and (bkt[f] <= i or bkt[f] == n or !lslot[bkt[f]] or sa[bkt[f]] != EMPTY)) {
+                ++f;
+            }
+            uint64_t hi = std::min(f < sigma ? (uint64_t)bkt[f] : n, i+BLOCK_SIZE);
+            induce_block(i, hi, true);
+            i = hi;
+        }
+        // symmetrically, the S-part of a bucket is final from the fill
+        // pointer on and the L-part does not change
+        bucket_ends();
+        for (uint64_t f=sigma, i=n; i > 0;) {
+            while (f > 0 and (bkt[f-1] >= i or bkt[f-1] == 0 or lslot[bkt[f-1]-1])) {
+                --f;
+            }
+            uint64_t lo = std::max(f > 0 ? (uint64_t)bkt[f-1] : 0, i-std::min(i, BLOCK_SIZE));
+            induce_block(lo, i, false);
+            i = lo;
+        }
+    };
+
+    // (1) sort the LMS substrings
+    fill(sa, 0, n, EMPTY, p);
+    bucket_ends();
+    if (small) {
+        // the order of the LMS suffixes in a bucket does not matter here
+        parallel_for(p, [&](uint32_t t) {
+            uint64_t b, e;
+            chunk(n, p, t, b, e);
+            std::fill(tcnt[t].begin(), tcnt[t].end(), 0);
+            for (uint64_t i=b; i < e; ++i) {
+                if (is_lms(i)) {
+                    ++tcnt[t][s[i]];
+                }
+            }
+        });
+        for (uint64_t c=0; c < sigma; ++c) {
+            for (uint32_t t=0; t < p; ++t) {
+                t_idx x = tcnt[t][c];
+                tcnt[t][c] = bkt[c];
+                bkt[c] -= x;
+            }
+        }
+        parallel_for(p, [&](uint32_t t) {
+            uint64_t b, e;
+            chunk(n, p, t, b, e);
+            for (uint64_t i=b; i < e; ++i) {
+                if (is_lms(i)) {
+                    sa[--tcnt[t][s[i]]] = i;
+                }
+            }
+        });
+    } else {
+        for (uint64_t i=1; i < n; ++i) {
+            if (is_lms(i)) {
+                sa[--bkt[s[i]]] = i;
+            }
+        }
+    }
+    induce();
+    uint64_t n1 = compact(sa, n, p, [&](t_idx j) {
+        return is_lms(j);
+    });
+
+    // (2) name the LMS substrings; LMS positions differ by at least 2
+    fill(sa, n1, n, EMPTY, p);
+    auto differs = [&](uint64_t pos, uint64_t prev) {
+        for (uint64_t d=0; ; ++d) {
+            if (pos+d == n or prev+d == n or s[pos+d] != s[prev+d] or stype[pos+d] != stype[prev+d]) {
+                return true;
+            } else if (d > 0 and (is_lms(pos+d) or is_lms(prev+d))) {
+                return false;
+            }
+        }
+    };
+    std::vector<uint64_t> tnames(p, 0);
+    parallel_for(p, [&](uint32_t t) {
+        uint64_t b, e;
+        chunk(n1, p, t, b, e);
+        for (uint64_t i=b; i < e; ++i) {
+            bool diff = i == 0 or differs(sa[i], sa[i-1]);
+            sa[n1+sa[i]/2] = diff;
+            tnames[t] += diff;
+        }
+    });
+    uint64_t names = 0;
+    for (uint32_t t=0; t < p; ++t) {
+        uint64_t x = tnames[t];
+        tnames[t] = names;
+        names += x;
+    }
+    parallel_for(p, [&](uint32_t t) {
+        uint64_t b, e;
+        chunk(n1, p, t, b, e);
+        for (uint64_t i=b, name=tnames[t]; i < e; ++i) {
+            name += sa[n1+sa[i]/2];
+            sa[n1+sa[i]/2] = name-1;
+        }
+    });
+    compact_back(sa+n1, n-n1, p, [&](t_idx x) {
+        return x != EMPTY;
+    });
+
+    // (3) sort the LMS suffixes by the reduced text
+    t_idx* s1 = sa+n-n1;
+    if (names < n1) {
+        sort<t_idx>((const t_idx*)s1, sa, n1, names, p);
+    } else {
+        parallel_for(p, [&](uint32_t t) {
+            uint64_t b, e;
+            chunk(n1, p, t, b, e);
+            for (uint64_t i=b; i < e; ++i) {
+                sa[s1[i]] = i;
+            }
+        });
+    }
+    std::vector<uint64_t> tlms(p, 0);
+    parallel_for(p, [&](uint32_t t) {
+        uint64_t b, e;
+        chunk(n, p, t, b, e);
+        for (uint64_t i=b; i < e; ++i) {
+            tlms[t] += is_lms(i);
+        }
+    });
+    for (uint64_t t=0, sum=0; t < p; ++t) {
+        uint64_t x = tlms[t];
+        tlms[t] = sum;
+        sum += x;
+    }
+    parallel_for(p, [&](uint32_t t) {
+        uint64_t b, e;
+        chunk(n, p, t, b, e);
+        for (uint64_t i=b, j=tlms[t]; i < e; ++i) {
+            if (is_lms(i)) {
+                s1[j++] = i;
+            }
+        }
+    });
+    parallel_for(p, [&](uint32_t t) {
+        uint64_t b, e;
+        chunk(n1, p, t, b, e);
+        for (uint64_t i=b; i < e; ++i) {
+            sa[i] = s1[sa[i]];
+        }
+    });
+
+    // (4) induce the suffix array from the sorted LMS suffixes
+    fill(sa, n1, n, EMPTY, p);
+    bucket_ends();
+    if (small) {
+        // the LMS suffixes with equal first symbol are moved to the end of
+        // their bucket, starting with the largest symbol
+        for (uint64_t i=n1; i > 0;) {
+            uint64_t c = s[sa[i-1]];
+            uint64_t g = std::partition_point(sa, sa+i-1, [&](t_idx j) {
+                return (uint64_t)s[j] < c;
+            }) - sa;
+            uint64_t dest = bkt[c]-(i-g);
+            memmove(sa+dest, sa+g, (i-g)*sizeof(t_idx));
+            std::fill(sa+g, sa+std::min((uint64_t)i, dest), EMPTY);
+            bkt[c] = dest;
+            i = g;
+        }
+    } else {
+        for (uint64_t i=n1; i-- > 0;) {
+            t_idx j = sa[i];
+            sa[i] = EMPTY;
+            sa[--bkt[s[j]]] = j;
+        }
+    }
+    induce();
+}
+
+template<class t_text>
+void construct_sa(int_vector<>& sa, const t_text& text, uint64_t sigma, uint32_t threads)
+{
+    const uint64_t n = text.size();
+    const uint8_t w = bits::hi(std::max(n, (uint64_t)1))+1;
+    if (n < 0xFFFFFFFFULL) {
+        sa = int_vector<>(n, 0, 32);
+        sort<uint32_t>(text, (uint32_t*)sa.data(), n, sigma, threads);
+        for (uint64_t i=0; i < n; ++i) {
+            sa.set_int(i*w, sa.get_int(i<<5, 32), w);
+        }
+    } else {
+        sa = int_vector<>(n, 0, 64);
+        sort<uint64_t>(text, (uint64_t*)sa.data(), n, sigma, threads);
+        for (uint64_t i=0; i < n; ++i) {
+            sa.set_int(i*w, sa.get_int(i<<6, 64), w);
+        }
+    }
+    sa.width(w);
+    sa.resize(n);
+}
+
+//! Calculates the suffix array of text with the given number of threads.
+/*! \param sa      Receives the suffix array of width \f$\lceil\log(n+1)\rceil\f$.
+ *  \param text    The text; a random access container of unsigned integers.
+ *  \param threads Number of threads.
+ *  Large symbols are mapped to their ranks as in sais::construct_sa.
+ */
+template<class t_text>
+void construct_sa(int_vector<>& sa, const t_text& text, uint32_t threads)
+{
+    const uint64_t n = text.size();
+    threads = std::max(threads, (uint32_t)1);
+    std::vector<uint64_t> max_symbol(threads, 0);
+    parallel_for(threads, [&](uint32_t t) {
+        uint64_t b, e;
+        chunk(n, threads, t, b, e);
+        for (uint64_t i=b; i < e; ++i) {
+            max_symbol[t] = std::max(max_symbol[t], (uint64_t)text[i]);
+        }
+    });
+    uint64_t mx = *std::max_element(max_symbol.begin(), max_symbol.end());
+    if (mx < std::max(n, (uint64_t)256)) {
+        construct_sa(sa, text, mx+1, threads);
+        return;
+    }
+    std::vector<uint64_t> symbols(n);
+    for (uint64_t i=0; i < n; ++i) {
+        symbols[i] = text[i];
+    }
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+    int_vector<> mapped(n, 0, bits::hi(symbols.size())+1);
+    for (uint64_t i=0; i < n; ++i) {
+        mapped[i] = std::lower_bound(symbols.begin(), symbols.end(), (uint64_t)text[i]) - symbols.begin();
+    }
+    const uint64_t sigma = symbols.size();
+    std::vector<uint64_t>().swap(symbols);
+    construct_sa(sa, mapped, sigma, threads);
+}
+
+} // end namespace parallel_sufsort
+} // end namespace sdsl
+
+#endif
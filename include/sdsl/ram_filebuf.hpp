@@ -27,9 +27,15 @@ class ram_filebuf : public std::streambuf
         ram_filebuf*
         close();
 
+        // seekoff and seekpos are also reached through std::istream::seekg/tellg,
+        // e.g. when a compressed int_vector is loaded from a ram file
+        pos_type
+        seekoff(off_type off, std::ios_base::seekdir way,
+                std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override;
+
         pos_type
         seekpos(pos_type sp,
-                std::ios_base::openmode which = std::ios_base::in | std::ios_base::out);
+                std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override;
 
         pos_type
         pubseekoff(off_type off, std::ios_base::seekdir way,
@@ -104,6 +104,10 @@ struct rank_support_trait {
         return 0;
     }
 
+    static size_type full_words_rank(const uint64_t*, size_type) {
+        return 0;
+    }
+
     static uint64_t init_carry() {
         return 0;
     }
@@ -125,6 +129,11 @@ struct rank_support_trait<0,1> {
         return	bits::cnt((~*(data+(idx>>6))));
     }
 
+    //! Number of arguments in the first n words of data.
+    static size_type full_words_rank(const uint64_t* data, size_type n) {
+        return (n<<6) - bits::cnt(data, n);
+    }
+
     static uint64_t init_carry() {
         return 0;
     }
@@ -146,6 +155,11 @@ struct rank_support_trait<1,1> {
         return	bits::cnt(*(data+(idx>>6)));
     }
 
+    //! Number of arguments in the first n words of data.
+    static size_type full_words_rank(const uint64_t* data, size_type n) {
+        return bits::cnt(data, n);
+    }
+
     static uint64_t init_carry() {
         return 0;
     }
@@ -171,6 +185,15 @@ struct rank_support_trait<10,2> {
         return	bits::cnt(bits::map10(*data, carry));
     }
 
+    //! Number of arguments in the first n words of data.
+    static size_type full_words_rank(const uint64_t* data, size_type n) {
+        size_type res = 0;
+        for (size_type i=0; i < n; ++i) {
+            res += full_word_rank(data, i<<6);
+        }
+        return res;
+    }
+
     static uint64_t init_carry() {
         return 0;
     }
@@ -196,6 +219,15 @@ struct rank_support_trait<01,2> {
         return	bits::cnt(bits::map01(*data, carry));
     }
 
+    //! Number of arguments in the first n words of data.
+    static size_type full_words_rank(const uint64_t* data, size_type n) {
+        size_type res = 0;
+        for (size_type i=0; i < n; ++i) {
+            res += full_word_rank(data, i<<6);
+        }
+        return res;
+    }
+
     static uint64_t init_carry() {
         return 1;
     }
@@ -126,6 +126,135 @@ class rank_support_v : public rank_support
             return rank(idx);
         }
 
+        //! Returns the position of the first set bit at or after position idx
+        /*! \param idx An index with \f$ 0 \leq idx \leq size() \f$.
+         *  \return The smallest j with \f$ j\geq idx \f$ and bit j set, or
+         *          size() if there is no such position.
+         *  \par Time complexity
+         *       \f$ \Order{\log n} \f$
+         *
+         *  The rest of the superblock of idx is scanned word by word. The
+         *  superblocks without set bits after it are skipped by a binary
+         *  search on the absolute counts.
+         */
+        size_type successor(size_type idx)const {
+            static_assert(t_b == 1u and t_pat_len == 1u, "rank_support_v: successor is only defined for bit pattern `1`");
+            assert(m_v != nullptr);
+            const size_type n = m_v->size();
+            if (idx >= n)
+                return n;
+            const uint64_t* data = m_v->data();
+            const size_type words = (n+63)>>6;
+            size_type w = idx>>6;
+            uint64_t word = data[w] & ~bits::lo_set[idx&0x3F];
+            size_type sb = idx>>9;
+            size_type end = std::min((sb+1)<<3, words);
+            while (!word and ++w < end)
+                word = data[w];
+            if (!word) {
+                // the counts of superblocks sb+1, ..., b are equal, i.e.
+                // the next set bit lies in the last such superblock b
+                const size_type superblocks = m_basic_block.size()>>1;
+                if (sb+1 >= superblocks or ((sb+1)<<3) >= words)
+                    return n;
+                size_type r = m_basic_block[(sb+1)<<1];
+                size_type lo = sb+1, hi = superblocks;
+                while (hi-lo > 1) {
+                    size_type mid = (lo+hi)>>1;
+                    if (m_basic_block[mid<<1] > r)
+                        hi = mid;
+                    else
+                        lo = mid;
+                }
+                w   = lo<<3;
+                end = std::min(w+8, words);
+                for (; w < end and !(word = data[w]); ++w);
+                if (!word)
+                    return n;
+            }
+            size_type res = (w<<6) + bits::lo(word);
+            return res < n ? res : n;
+        }
+
+        //! Returns the position of the last set bit at or before position idx
+        /*! \param idx An index with \f$ 0 \leq idx < size() \f$.
+         *  \return The largest j with \f$ j\leq idx \f$ and bit j set, or
+         *          size() if there is no such position.
+         *  \par Time complexity
+         *       \f$ \Order{\log n} \f$
+         */
+        size_type predecessor(size_type idx)const {
+            static_assert(t_b == 1u and t_pat_len == 1u, "rank_support_v: predecessor is only defined for bit pattern `1`");
+            assert(m_v != nullptr);
+            assert(idx < m_v->size());
+            const uint64_t* data = m_v->data();
+            size_type w = idx>>6;
+            uint64_t word = data[w] & bits::lo_set[(idx&0x3F)+1];
+            size_type sb = idx>>9;
+            size_type begin = sb<<3;
+            while (!word and w > begin)
+                word = data[--w];
+            if (!word) {
+                // the previous set bit lies in the first superblock b whose
+                // successor has the same count as superblock sb
+                size_type r = m_basic_block[sb<<1];
+                if (r == 0)
+                    return m_v->size();
+                size_type lo = 0, hi = sb;
+                while (hi-lo > 1) {
+                    size_type mid = (lo+hi)>>1;
+                    if (m_basic_block[mid<<1] < r)
+                        lo = mid;
+                    else
+                        hi = mid;
+                }
+                w = (lo<<3)+7;
+                while (!(word = data[w]))
+                    --w;
+            }
+            return (w<<6) + bits::hi(word);
+        }
+
+        //! Answers a batch of rank queries.
+        /*! \param pos Array of n arguments for rank.
+         *  \param n   Number of queries.
+         *  \param out Array of size n; out[k] is set to rank(pos[k]).
+         *  The counts and the data word of query k+constants::SDSL_PREFETCH_DIST
+         *  are prefetched while query k is answered, so that the cache
+         *  misses of consecutive queries overlap.
+         */
+        void rank(const size_type* pos, size_type n, size_type* out)const {
+            assert(m_v != nullptr);
+            const size_type d = constants::SDSL_PREFETCH_DIST;
+            for (size_type k=0; k < n; ++k) {
+                if (k+d < n) {
+                    size_type idx = pos[k+d];
+                    __builtin_prefetch(m_basic_block.data() + ((idx>>8)&0xFFFFFFFFFFFFFFFEULL));
+                    __builtin_prefetch(m_v->data() + (idx>>6));
+                }
+                out[k] = rank_support_v::rank(pos[k]);
+            }
+        }
+
+        //! Combines the supported bit_vector with v and updates the counts
+        /*! \param bv The supported bit_vector, i.e. &bv equals the pointer
+         *            passed to the constructor or set_vector.
+         *  \param v  A bit_vector of the same size as bv.
+         *  \param op The operation; bv is replaced by bv op v.
+         *  The cumulative counts are written while the words of bv are
+         *  combined, so no second pass over bv is necessary.
+         */
+        void combine(bit_vector& bv, const bit_vector& v, bits::bit_op op) {
+            static_assert(t_b == 1u and t_pat_len == 1u, "rank_support_v: combine is only defined for bit pattern `1`");
+            assert(m_v == &bv);
+            if (bv.size() != v.size()) {
+                throw std::logic_error("rank_support_v::combine: bit_vectors differ in size");
+            }
+            m_basic_block.resize(((bv.capacity() >> 9)+1)<<1);
+            bits::combine(op, const_cast<uint64_t*>(bv.data()), v.data(), bv.capacity()>>6,
+                          const_cast<uint64_t*>(m_basic_block.data()));
+        }
+
         const size_type size()const {
             return m_v->size();
         }
@@ -136,6 +136,26 @@ class rank_support_v5 : public rank_support
         inline const size_type operator()(size_type idx)const {
             return rank(idx);
         }
+
+        //! Answers a batch of rank queries.
+        /*! \param pos Array of n arguments for rank.
+         *  \param n   Number of queries.
+         *  \param out Array of size n; out[k] is set to rank(pos[k]).
+         *  The counts and the data word of query k+constants::SDSL_PREFETCH_DIST
+         *  are prefetched while query k is answered.
+         */
+        void rank(const size_type* pos, size_type n, size_type* out)const {
+            assert(m_v != nullptr);
+            const size_type d = constants::SDSL_PREFETCH_DIST;
+            for (size_type k=0; k < n; ++k) {
+                if (k+d < n) {
+                    size_type idx = pos[k+d];
+                    __builtin_prefetch(m_basic_block.data() + ((idx>>10)&0xFFFFFFFFFFFFFFFEULL));
+                    __builtin_prefetch(m_v->data() + (idx>>6));
+                }
+                out[k] = rank_support_v5::rank(pos[k]);
+            }
+        }
         const size_type size()const {
             return m_v->size();
         }
@@ -107,6 +107,55 @@ class rrr_vector
         // have to be considered as inverted i.e. 1 and
         // 0 are swapped
 
+        // Position of the first set bit in the blocks j, j+1, ... of sample s,
+        // where the first off bits of block j are ignored and btnrp points
+        // to the number of block j. Returns m_size if there is none.
+        size_type first_one(size_type s, size_type j, size_type btnrp, uint16_t off)const {
+            const bool inv = m_invert[s];
+            size_type end = std::min((s+1)*m_k, (size_type)m_bt.size());
+            for (; j < end; ++j, off = 0) {
+                uint16_t bt = inv ? t_bs - m_bt[j] : m_bt[j];
+                uint16_t btnrlen = rrr_helper_type::space_for_bt(bt);
+                if (bt) {
+                    number_type btnr = rrr_helper_type::decode_btnr(m_btnr, btnrp, btnrlen);
+                    uint16_t cnt = off ? rrr_helper_type::decode_popcount(bt, btnr, off) : 0;
+                    if (cnt < bt)
+                        return j*t_bs + rrr_helper_type::decode_select(bt, btnr, cnt+1);
+                }
+                btnrp += btnrlen;
+            }
+            return m_size;
+        }
+
+        // Position of the last set bit in the blocks of sample s up to block j,
+        // where only the first len bits of block j are considered.
+        // Returns m_size if there is none.
+        size_type last_one(size_type s, size_type j, uint16_t len)const {
+            const bool inv = m_invert[s];
+            size_type btnrp = m_btnrp[s];
+            size_type last = 0, last_btnrp = 0;
+            uint16_t last_bt = 0;
+            for (size_type k = s*m_k; k < j; ++k) {
+                uint16_t bt = inv ? t_bs - m_bt[k] : m_bt[k];
+                if (bt) {
+                    last = k; last_bt = bt; last_btnrp = btnrp;
+                }
+                btnrp += rrr_helper_type::space_for_bt(bt);
+            }
+            uint16_t bt = inv ? t_bs - m_bt[j] : m_bt[j];
+            if (bt) {
+                number_type btnr = rrr_helper_type::decode_btnr(m_btnr, btnrp, rrr_helper_type::space_for_bt(bt));
+                uint16_t cnt = rrr_helper_type::decode_popcount(bt, btnr, len);
+                if (cnt)
+                    return j*t_bs + rrr_helper_type::decode_select(bt, btnr, cnt);
+            }
+            if (last_bt) {
+                number_type btnr = rrr_helper_type::decode_btnr(m_btnr, last_btnrp, rrr_helper_type::space_for_bt(last_bt));
+                return last*t_bs + rrr_helper_type::decode_select(last_bt, btnr, last_bt);
+            }
+            return m_size;
+        }
+
         void copy(const rrr_vector& rrr) {
             m_size = rrr.m_size;
             m_k = rrr.m_k;
@@ -271,6 +320,77 @@ class rrr_vector
             return rrr_helper_type::decode_bit(bt, btnr, off);
         }
 
+        //! Returns the position of the first set bit at or after position i
+        /*! \param i An index i with \f$ 0 \leq i \leq size()  \f$.
+         *  \return The smallest j with \f$ j\geq i \f$ and bit j set, or
+         *          size() if there is no such position.
+         *  \par Time complexity
+         *       \f$ \Order{ k + \log(n/(k\cdot t\_bs)) } \f$
+         *
+         *  The blocks of the superblock of i are decoded only up to the
+         *  first set bit. Empty superblocks are skipped by a binary search
+         *  on the rank samples.
+         */
+        size_type successor(size_type i)const {
+            if (i >= m_size)
+                return m_size;
+            size_type bt_idx = i/t_bs;
+            size_type sample_pos = bt_idx/m_k;
+            size_type r = m_rank[ sample_pos+1 ];
+            if (r > m_rank[ sample_pos ]) {
+                size_type btnrp = m_btnrp[ sample_pos ];
+                for (size_type j = sample_pos*m_k; j < bt_idx; ++j) {
+                    btnrp += rrr_helper_type::space_for_bt(m_bt[j]);
+                }
+                size_type res = first_one(sample_pos, bt_idx, btnrp, i % t_bs);
+                if (res < m_size)
+                    return res;
+            }
+            if (r == m_rank[ m_rank.size()-1 ])
+                return m_size;
+            // the next set bit lies in sample lo, the last sample with rank r
+            size_type lo = sample_pos+1, hi = m_rank.size()-1;
+            while (hi-lo > 1) {
+                size_type mid = (lo+hi)/2;
+                if (m_rank[mid] > r)
+                    hi = mid;
+                else
+                    lo = mid;
+            }
+            return first_one(lo, lo*m_k, m_btnrp[lo], 0);
+        }
+
+        //! Returns the position of the last set bit at or before position i
+        /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
+         *  \return The largest j with \f$ j\leq i \f$ and bit j set, or
+         *          size() if there is no such position.
+         *  \par Time complexity
+         *       \f$ \Order{ k + \log(n/(k\cdot t\_bs)) } \f$
+         */
+        size_type predecessor(size_type i)const {
+            assert(i < m_size);
+            size_type bt_idx = i/t_bs;
+            size_type sample_pos = bt_idx/m_k;
+            size_type r = m_rank[ sample_pos ];
+            if (m_rank[ sample_pos+1 ] > r) {
+                size_type res = last_one(sample_pos, bt_idx, i % t_bs + 1);
+                if (res < m_size)
+                    return res;
+            }
+            if (r == 0)
+                return m_size;
+            // the previous set bit lies in sample lo, the last sample with rank < r
+            size_type lo = 0, hi = sample_pos;
+            while (hi-lo > 1) {
+                size_type mid = (lo+hi)/2;
+                if (m_rank[mid] < r)
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            return last_one(lo, std::min((lo+1)*m_k, (size_type)m_bt.size())-1, t_bs);
+        }
+
         //! Assignment operator
         rrr_vector& operator=(const rrr_vector& rrr) {
             if (this != &rrr) {
@@ -326,6 +446,57 @@ class rrr_vector
         }
 };
 
+//! Batched binary search in the rank samples of a rrr_vector.
+/*! \param samples    Rank samples of the rrr_vector.
+ *  \param sample_len Number of bits between two rank samples.
+ *  \param arg        Array of n select arguments.
+ *  \param n          Number of queries.
+ *  \param begin      Array of size n, which must not overlap arg.
+ *
+ *  For each query k the index begin[k] of the last sample, whose count
+ *  is smaller than arg[k], is calculated. The count of sample j equals
+ *  samples[j] for t_b=1 and j*sample_len-samples[j] for t_b=0.
+ *  The binary searches of up to constants::SDSL_PREFETCH_DIST queries
+ *  advance in lockstep and the next probe of each query is prefetched
+ *  before it is read, so that their cache misses overlap.
+ */
+template<uint8_t t_b>
+void rrr_batch_sample_search(const int_vector<>& samples, uint64_t sample_len,
+                             const uint64_t* arg, uint64_t n, uint64_t* begin)
+{
+    const uint64_t g = constants::SDSL_PREFETCH_DIST;
+    uint64_t end[g];
+    for (uint64_t k0=0; k0 < n; k0 += g) {
+        uint64_t m = std::min(g, n-k0);
+        uint64_t* b = begin+k0;
+        for (uint64_t j=0; j < m; ++j) {
+            b[j]   = 0;
+            end[j] = samples.size()-1;
+        }
+        bool active = true;
+        while (active) {
+            active = false;
+            for (uint64_t j=0; j < m; ++j) {
+                if (end[j]-b[j] > 1) {
+                    uint64_t idx = (b[j]+end[j]) >> 1;
+                    __builtin_prefetch(samples.data() + ((idx*samples.width())>>6));
+                }
+            }
+            for (uint64_t j=0; j < m; ++j) {
+                if (end[j]-b[j] > 1) {
+                    uint64_t idx  = (b[j]+end[j]) >> 1;
+                    uint64_t rank = t_b ? samples[idx] : idx*sample_len - samples[idx];
+                    if (rank >= arg[k0+j])
+                        end[j] = idx;
+                    else
+                        b[j] = idx;
+                    active = active or (end[j]-b[j] > 1);
+                }
+            }
+        }
+    }
+}
+
 template<uint8_t t_bit_pattern>
 struct rank_support_rrr_trait {
     typedef bit_vector::size_type size_type;
@@ -424,6 +595,39 @@ class rank_support_rrr
             return rank(i);
         }
 
+        //! Position of the first set bit at or after i, see rrr_vector::successor.
+        size_type successor(size_type i)const {
+            static_assert(t_b == 1u, "rank_support_rrr: successor is only defined for bit pattern `1`");
+            return m_v->successor(i);
+        }
+
+        //! Position of the last set bit at or before i, see rrr_vector::predecessor.
+        size_type predecessor(size_type i)const {
+            static_assert(t_b == 1u, "rank_support_rrr: predecessor is only defined for bit pattern `1`");
+            return m_v->predecessor(i);
+        }
+
+        //! Answers a batch of rank queries.
+        /*! \param pos Array of n arguments for rank.
+         *  \param n   Number of queries.
+         *  \param out Array of size n; out[k] is set to rank(pos[k]).
+         *  The samples of query k+constants::SDSL_PREFETCH_DIST are prefetched
+         *  while query k is answered.
+         */
+        void rank(const size_type* pos, size_type n, size_type* out)const {
+            assert(m_v != nullptr);
+            const size_type d = constants::SDSL_PREFETCH_DIST;
+            for (size_type k=0; k < n; ++k) {
+                if (k+d < n) {
+                    size_type sample_pos = (pos[k+d]/t_bs)/m_k;
+                    __builtin_prefetch(m_v->m_rank.data() + ((sample_pos*m_v->m_rank.width())>>6));
+                    __builtin_prefetch(m_v->m_btnrp.data() + ((sample_pos*m_v->m_btnrp.width())>>6));
+                    __builtin_prefetch(m_v->m_invert.data() + (sample_pos>>6));
+                }
+                out[k] = rank(pos[k]);
+            }
+        }
+
         //! Returns the size of the original vector
         const size_type size()const {
             return m_v->size();
@@ -497,8 +701,6 @@ class select_support_rrr
         uint16_t m_k;     //!<    "     "   "      "
 
         size_type select1(size_type i)const {
-            if (m_v->m_rank[m_v->m_rank.size()-1] < i)
-                return size();
             //  (1) binary search for the answer in the rank_samples
             size_type begin=0, end=m_v->m_rank.size()-1; // min included, max excluded
             size_type idx, rank;
@@ -513,6 +715,15 @@ class select_support_rrr
                     begin = idx;
                 }
             }
+            return select1(i, begin);
+        }
+
+        // select1 for a known rank sample `begin` with m_rank[begin] < i <= m_rank[begin+1]
+        size_type select1(size_type i, size_type begin)const {
+            if (m_v->m_rank[m_v->m_rank.size()-1] < i)
+                return size();
+            size_type end = begin+1;
+            size_type idx, rank;
             //   (2) linear search between the samples
             rank = m_v->m_rank[begin]; // now i>rank
             idx = begin * m_k; // initialize idx for select result
@@ -536,9 +747,6 @@ class select_support_rrr
         }
 
         size_type select0(size_type i)const {
-            if ((size() - m_v->m_rank[m_v->m_rank.size()-1]) < i) {
-                return size();
-            }
             //  (1) binary search for the answer in the rank_samples
             size_type begin=0, end=m_v->m_rank.size()-1; // min included, max excluded
             size_type idx, rank;
@@ -553,6 +761,16 @@ class select_support_rrr
                     begin = idx;
                 }
             }
+            return select0(i, begin);
+        }
+
+        // select0 for a known rank sample `begin` which precedes the i-th zero
+        size_type select0(size_type i, size_type begin)const {
+            if ((size() - m_v->m_rank[m_v->m_rank.size()-1]) < i) {
+                return size();
+            }
+            size_type end = begin+1;
+            size_type idx, rank;
             //   (2) linear search between the samples
             rank = begin*t_bs*m_k - m_v->m_rank[begin]; // now i>rank
             idx = begin * m_k; // initialize idx for select result
@@ -588,6 +806,30 @@ class select_support_rrr
             return select(i);
         }
 
+        //! Answers a batch of select queries.
+        /*! \param pos Array of n arguments for select.
+         *  \param n   Number of queries.
+         *  \param out Array of size n, which must not overlap pos;
+         *             out[k] is set to select(pos[k]).
+         *  The binary searches in the rank samples are done in lockstep
+         *  (see rrr_batch_sample_search) and the block data of query
+         *  k+constants::SDSL_PREFETCH_DIST is prefetched while query k
+         *  is answered.
+         */
+        void select(const size_type* pos, size_type n, size_type* out)const {
+            assert(m_v != nullptr);
+            rrr_batch_sample_search<t_b>(m_v->m_rank, t_bs*m_k, pos, n, out);
+            const size_type d = constants::SDSL_PREFETCH_DIST;
+            for (size_type k=0; k < n; ++k) {
+                if (k+d < n) {
+                    size_type sample_pos = out[k+d];
+                    __builtin_prefetch(m_v->m_btnrp.data() + ((sample_pos*m_v->m_btnrp.width())>>6));
+                    __builtin_prefetch(m_v->m_invert.data() + (sample_pos>>6));
+                }
+                out[k] = t_b ? select1(pos[k], out[k]) : select0(pos[k], out[k]);
+            }
+        }
+
         const size_type size()const {
             return m_v->size();
         }
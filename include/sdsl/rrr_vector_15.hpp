@@ -152,6 +152,53 @@ class rrr_vector<15, t_rac>
         int_vector<> m_btnrp;    // Sample pointers into m_btnr.
         int_vector<> m_rank;     // Sample rank values.
 
+        // Decodes a block of type bt, whose number is stored at position btnrp
+        uint32_t decode_block(uint8_t bt, size_type btnrp)const {
+            if (bt == 0 or bt == block_size) {
+                return bt ? bits::lo_set[block_size] : 0;
+            }
+            return bi_type::nr_to_bin(bt, m_btnr.get_int(btnrp, bi_type::space_for_bt(bt)));
+        }
+
+        // Position of the first set bit in the blocks j, j+1, ... of sample s,
+        // where the first off bits of block j are ignored and btnrp points
+        // to the number of block j. Returns m_size if there is none.
+        size_type first_one(size_type s, size_type j, size_type btnrp, uint8_t off)const {
+            size_type end = std::min((s+1)*m_k, (size_type)m_bt.size());
+            for (; j < end; ++j, off = 0) {
+                uint8_t bt = m_bt[j];
+                if (bt) {
+                    uint32_t w = decode_block(bt, btnrp) >> off;
+                    if (w)
+                        return j*block_size + off + bits::lo(w);
+                }
+                btnrp += bi_type::space_for_bt(bt);
+            }
+            return m_size;
+        }
+
+        // Position of the last set bit in the blocks of sample s up to block j,
+        // where only the first len bits of block j are considered.
+        // Returns m_size if there is none.
+        size_type last_one(size_type s, size_type j, uint8_t len)const {
+            size_type btnrp = m_btnrp[s];
+            size_type last = 0, last_btnrp = 0;
+            uint8_t last_bt = 0;
+            for (size_type k = s*m_k; k < j; ++k) {
+                uint8_t bt = m_bt[k];
+                if (bt) {
+                    last = k; last_bt = bt; last_btnrp = btnrp;
+                }
+                btnrp += bi_type::space_for_bt(bt);
+            }
+            uint32_t w = decode_block(m_bt[j], btnrp) & bits::lo_set[len];
+            if (w)
+                return j*block_size + bits::hi(w);
+            if (last_bt)
+                return last*block_size + bits::hi(decode_block(last_bt, last_btnrp));
+            return m_size;
+        }
+
         void copy(const rrr_vector& rrr) {
             m_size = rrr.m_size;
             m_k = rrr.m_k;
@@ -297,6 +344,75 @@ class rrr_vector<15, t_rac>
             return (bi_type::nr_to_bin(i_bt, btnr) >> off) & (uint32_t)1;
         }
 
+        //! Returns the position of the first set bit at or after position i
+        /*! \param i An index i with \f$ 0 \leq i \leq size()  \f$.
+         *  \return The smallest j with \f$ j\geq i \f$ and bit j set, or
+         *          size() if there is no such position.
+         *  \par Time complexity
+         *       \f$ \Order{ k + \log(n/(15k)) } \f$
+         *
+         *  Empty superblocks are skipped by a binary search on the rank samples.
+         */
+        size_type successor(size_type i)const {
+            if (i >= m_size)
+                return m_size;
+            size_type bt_idx = i/block_size;
+            size_type sample_pos = bt_idx/m_k;
+            size_type r = m_rank[ sample_pos+1 ];
+            if (r > m_rank[ sample_pos ]) {
+                size_type btnrp = m_btnrp[ sample_pos ];
+                for (size_type j = sample_pos*m_k; j < bt_idx; ++j) {
+                    btnrp += bi_type::space_for_bt(m_bt[j]);
+                }
+                size_type res = first_one(sample_pos, bt_idx, btnrp, i % block_size);
+                if (res < m_size)
+                    return res;
+            }
+            if (r == m_rank[ m_rank.size()-1 ])
+                return m_size;
+            // the next set bit lies in sample lo, the last sample with rank r
+            size_type lo = sample_pos+1, hi = m_rank.size()-1;
+            while (hi-lo > 1) {
+                size_type mid = (lo+hi)/2;
+                if (m_rank[mid] > r)
+                    hi = mid;
+                else
+                    lo = mid;
+            }
+            return first_one(lo, lo*m_k, m_btnrp[lo], 0);
+        }
+
+        //! Returns the position of the last set bit at or before position i
+        /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
+         *  \return The largest j with \f$ j\leq i \f$ and bit j set, or
+         *          size() if there is no such position.
+         *  \par Time complexity
+         *       \f$ \Order{ k + \log(n/(15k)) } \f$
+         */
+        size_type predecessor(size_type i)const {
+            assert(i < m_size);
+            size_type bt_idx = i/block_size;
+            size_type sample_pos = bt_idx/m_k;
+            size_type r = m_rank[ sample_pos ];
+            if (m_rank[ sample_pos+1 ] > r) {
+                size_type res = last_one(sample_pos, bt_idx, i % block_size + 1);
+                if (res < m_size)
+                    return res;
+            }
+            if (r == 0)
+                return m_size;
+            // the previous set bit lies in sample lo, the last sample with rank < r
+            size_type lo = 0, hi = sample_pos;
+            while (hi-lo > 1) {
+                size_type mid = (lo+hi)/2;
+                if (m_rank[mid] < r)
+                    lo = mid;
+                else
+                    hi = mid;
+            }
+            return last_one(lo, std::min((lo+1)*m_k, (size_type)m_bt.size())-1, block_size);
+        }
+
         //! Assignment operator
         rrr_vector& operator=(const rrr_vector& rrr) {
             if (this != &rrr) {
@@ -477,6 +593,40 @@ class rank_support_rrr<t_b, 15, t_rac>
             return rank(i);
         }
 
+        //! Position of the first set bit at or after i, see rrr_vector::successor.
+        size_type successor(size_type i)const {
+            static_assert(t_b == 1u, "rank_support_rrr: successor is only defined for bit pattern `1`");
+            return m_v->successor(i);
+        }
+
+        //! Position of the last set bit at or before i, see rrr_vector::predecessor.
+        size_type predecessor(size_type i)const {
+            static_assert(t_b == 1u, "rank_support_rrr: predecessor is only defined for bit pattern `1`");
+            return m_v->predecessor(i);
+        }
+
+        //! Answers a batch of rank queries.
+        /*! \param pos Array of n arguments for rank.
+         *  \param n   Number of queries.
+         *  \param out Array of size n; out[k] is set to rank(pos[k]).
+         *  The samples and the first block types of the sampled range of
+         *  query k+constants::SDSL_PREFETCH_DIST are prefetched while query
+         *  k is answered.
+         */
+        void rank(const size_type* pos, size_type n, size_type* out)const {
+            assert(m_v != nullptr);
+            const size_type d = constants::SDSL_PREFETCH_DIST;
+            for (size_type k=0; k < n; ++k) {
+                if (k+d < n) {
+                    size_type sample_pos = (pos[k+d]/bit_vector_type::block_size)/m_k;
+                    __builtin_prefetch(m_v->m_rank.data() + ((sample_pos*m_v->m_rank.width())>>6));
+                    __builtin_prefetch(m_v->m_btnrp.data() + ((sample_pos*m_v->m_btnrp.width())>>6));
+                    __builtin_prefetch(m_v->m_bt.data() + ((sample_pos*m_k)>>4));
+                }
+                out[k] = rank(pos[k]);
+            }
+        }
+
         //! Returns the size of the original vector
         const size_type size()const {
             return m_v->size();
@@ -537,8 +687,6 @@ class select_support_rrr<t_b, 15, t_rac>
 
         // TODO: hinted binary search
         size_type  select1(size_type i)const {
-            if (m_v->m_rank[m_v->m_rank.size()-1] < i)
-                return size();
             //  (1) binary search for the answer in the rank_samples
             size_type begin=0, end=m_v->m_rank.size()-1; // min included, max excluded
             size_type idx, rank;
@@ -553,6 +701,15 @@ class select_support_rrr<t_b, 15, t_rac>
                     begin = idx;
                 }
             }
+            return select1(i, begin);
+        }
+
+        // select1 for a known rank sample `begin` with m_rank[begin] < i <= m_rank[begin+1]
+        size_type  select1(size_type i, size_type begin)const {
+            if (m_v->m_rank[m_v->m_rank.size()-1] < i)
+                return size();
+            size_type end = begin+1;
+            size_type idx, rank;
             //   (2) linear search between the samples
             rank = m_v->m_rank[begin]; // now i>rank
             idx = begin * m_k; // initialize idx for select result
@@ -574,8 +731,6 @@ class select_support_rrr<t_b, 15, t_rac>
 
         // TODO: hinted binary search
         size_type  select0(size_type i)const {
-            if ((size()-m_v->m_rank[m_v->m_rank.size()-1]) < i)
-                return size();
             //  (1) binary search for the answer in the rank_samples
             size_type begin=0, end=m_v->m_rank.size()-1; // min included, max excluded
             size_type idx, rank;
@@ -590,6 +745,15 @@ class select_support_rrr<t_b, 15, t_rac>
                     begin = idx;
                 }
             }
+            return select0(i, begin);
+        }
+
+        // select0 for a known rank sample `begin` which precedes the i-th zero
+        size_type  select0(size_type i, size_type begin)const {
+            if ((size()-m_v->m_rank[m_v->m_rank.size()-1]) < i)
+                return size();
+            size_type end = begin+1;
+            size_type idx, rank;
             //   (2) linear search between the samples
             rank = begin*bit_vector_type::block_size*m_k - m_v->m_rank[begin]; // now i>rank
             idx = begin * m_k; // initialize idx for select result
@@ -625,6 +789,27 @@ class select_support_rrr<t_b, 15, t_rac>
             return select(i);
         }
 
+        //! Answers a batch of select queries.
+        /*! \param pos Array of n arguments for select.
+         *  \param n   Number of queries.
+         *  \param out Array of size n, which must not overlap pos;
+         *             out[k] is set to select(pos[k]).
+         *  \sa rrr_batch_sample_search
+         */
+        void select(const size_type* pos, size_type n, size_type* out)const {
+            assert(m_v != nullptr);
+            rrr_batch_sample_search<t_b>(m_v->m_rank, bit_vector_type::block_size*m_k, pos, n, out);
+            const size_type d = constants::SDSL_PREFETCH_DIST;
+            for (size_type k=0; k < n; ++k) {
+                if (k+d < n) {
+                    size_type sample_pos = out[k+d];
+                    __builtin_prefetch(m_v->m_btnrp.data() + ((sample_pos*m_v->m_btnrp.width())>>6));
+                    __builtin_prefetch(m_v->m_bt.data() + ((sample_pos*m_k)>>4));
+                }
+                out[k] = t_b ? select1(pos[k], out[k]) : select0(pos[k], out[k]);
+            }
+        }
+
         const size_type size()const {
             return m_v->size();
         }
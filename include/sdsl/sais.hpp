@@ -0,0 +1,219 @@
+/*!\file sais.hpp
+   \brief sais.hpp contains a linear time suffix array construction for integer alphabets (SA-IS).
+*/
+#ifndef INCLUDED_SDSL_SAIS
+#define INCLUDED_SDSL_SAIS
+
+#include "int_vector.hpp"
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace sdsl
+{
+
+//! Suffix sorting by induced sorting (SA-IS)
+/*! The text is accessed by operator[], so bit-compressed int_vectors are
+ *  sorted without an uncompressed copy. The end of the text acts as a
+ *  sentinel which is smaller than all symbols, so the text may contain
+ *  any symbol including 0.
+ *
+ *  \par Time complexity
+ *       \f$ \Order{n+\sigma} \f$
+ *  \par Space complexity
+ *       The text, \f$ 4n \f$ bytes for \f$ n < 2^{32}-1 \f$ and \f$ 8n \f$
+ *       bytes otherwise, \f$ n \f$ bits for the suffix types and two
+ *       arrays of \f$\sigma\f$ integers for the buckets.
+ *  \par Reference
+ *    Ge Nong, Sen Zhang, Wai Hong Chan:
+ *    Two Efficient Algorithms for Linear Time Suffix Array Construction.
+ *    IEEE Trans. Computers 60(10): 1471-1484 (2011)
+ */
+namespace sais
+{
+
+//! Sorts the suffixes of s[0..n) with symbols in [0..sigma) into sa[0..n).
+template<class t_idx, class t_text>
+void sort(const t_text& s, t_idx* sa, uint64_t n, uint64_t sigma)
+{
+    const t_idx EMPTY = std::numeric_limits<t_idx>::max();
+    if (n <= 1) {
+        if (n == 1) {
+            sa[0] = 0;
+        }
+        return;
+    }
+    bit_vector stype(n, 0); // suffix i is smaller than suffix i+1
+    for (uint64_t i=n-1; i-- > 0;) {
+        stype[i] = s[i] < s[i+1] or (s[i] == s[i+1] and stype[i+1]);
+    }
+    auto is_lms = [&](uint64_t i) {
+        return i > 0 and i < n and stype[i] and !stype[i-1];
+    };
+    std::vector<t_idx> cnt(sigma, 0), bkt(sigma);
+    for (uint64_t i=0; i < n; ++i) {
+        ++cnt[s[i]];
+    }
+    auto bucket_starts = [&]() {
+        t_idx sum = 0;
+        for (uint64_t c=0; c < sigma; ++c) {
+            bkt[c] = sum;
+            sum += cnt[c];
+        }
+    };
+    auto bucket_ends = [&]() {
+        t_idx sum = 0;
+        for (uint64_t c=0; c < sigma; ++c) {
+            sum += cnt[c];
+            bkt[c] = sum;
+        }
+    };
+    // induces the order of the L- and S-type suffixes from the LMS suffixes in sa
+    auto induce = [&]() {
+        bucket_starts();
+        sa[bkt[s[n-1]]++] = n-1; // the last suffix is L-type and follows the sentinel
+        for (uint64_t i=0; i < n; ++i) {
+            t_idx j = sa[i];
+            if (j != EMPTY and j > 0 and !stype[j-1]) {
+                sa[bkt[s[j-1]]++] = j-1;
+            }
+        }
+        bucket_ends();
+        for (uint64_t i=n; i-- > 0;) {
+            t_idx j = sa[i];
+            if (j != EMPTY and j > 0 and stype[j-1]) {
+                sa[--bkt[s[j-1]]] = j-1;
+            }
+        }
+    };
+
+    // (1) sort the LMS substrings
+    std::fill(sa, sa+n, EMPTY);
+    bucket_ends();
+    for (uint64_t i=1; i < n; ++i) {
+        if (is_lms(i)) {
+            sa[--bkt[s[i]]] = i;
+        }
+    }
+    induce();
+    uint64_t n1 = 0;
+    for (uint64_t i=0; i < n; ++i) {
+        if (is_lms(sa[i])) {
+            sa[n1++] = sa[i];
+        }
+    }
+
+    // (2) name the LMS substrings; LMS positions differ by at least 2
+    std::fill(sa+n1, sa+n, EMPTY);
+    uint64_t names = 0, prev = n;
+    for (uint64_t i=0; i < n1; ++i) {
+        uint64_t pos = sa[i];
+        bool diff = (prev == n);
+        for (uint64_t d=0; !diff; ++d) {
+            if (pos+d == n or prev+d == n or s[pos+d] != s[prev+d] or stype[pos+d] != stype[prev+d]) {
+                diff = true;
+            } else if (d > 0 and (is_lms(pos+d) or is_lms(prev+d))) {
+                break;
+            }
+        }
+        if (diff) {
+            ++names;
+            prev = pos;
+        }
+        sa[n1+pos/2] = names-1;
+    }
+    for (uint64_t i=n, j=n; i-- > n1;) {
+        if (sa[i] != EMPTY) {
+            sa[--j] = sa[i];
+        }
+    }
+
+    // (3) sort the LMS suffixes by the reduced text
+    t_idx* s1 = sa+n-n1;
+    if (names < n1) {
+        sort<t_idx>((const t_idx*)s1, sa, n1, names);
+    } else {
+        for (uint64_t i=0; i < n1; ++i) {
+            sa[s1[i]] = i;
+        }
+    }
+    for (uint64_t i=1, j=0; i < n; ++i) {
+        if (is_lms(i)) {
+            s1[j++] = i;
+        }
+    }
+    for (uint64_t i=0; i < n1; ++i) {
+        sa[i] = s1[sa[i]];
+    }
+
+    // (4) induce the suffix array from the sorted LMS suffixes
+    std::fill(sa+n1, sa+n, EMPTY);
+    bucket_ends();
+    for (uint64_t i=n1; i-- > 0;) {
+        t_idx j = sa[i];
+        sa[i] = EMPTY;
+        sa[--bkt[s[j]]] = j;
+    }
+    induce();
+}
+
+template<class t_text>
+void construct_sa(int_vector<>& sa, const t_text& text, uint64_t sigma)
+{
+    const uint64_t n = text.size();
+    const uint8_t w = bits::hi(std::max(n, (uint64_t)1))+1;
+    if (n < 0xFFFFFFFFULL) {
+        sa = int_vector<>(n, 0, 32);
+        sort<uint32_t>(text, (uint32_t*)sa.data(), n, sigma);
+        for (uint64_t i=0; i < n; ++i) {
+            sa.set_int(i*w, sa.get_int(i<<5, 32), w);
+        }
+    } else {
+        sa = int_vector<>(n, 0, 64);
+        sort<uint64_t>(text, (uint64_t*)sa.data(), n, sigma);
+        for (uint64_t i=0; i < n; ++i) {
+            sa.set_int(i*w, sa.get_int(i<<6, 64), w);
+        }
+    }
+    sa.width(w);
+    sa.resize(n);
+}
+
+//! Calculates the suffix array of an integer text.
+/*! \param sa   Receives the suffix array of width \f$\lceil\log(n+1)\rceil\f$.
+ *  \param text The text; a random access container of unsigned integers.
+ *  If the largest symbol is not smaller than the text length, the
+ *  symbols are first mapped to their ranks among the occurring symbols,
+ *  which needs a temporary copy of the text.
+ */
+template<class t_text>
+void construct_sa(int_vector<>& sa, const t_text& text)
+{
+    const uint64_t n = text.size();
+    uint64_t max_symbol = 0;
+    for (uint64_t i=0; i < n; ++i) {
+        max_symbol = std::max(max_symbol, (uint64_t)text[i]);
+    }
+    if (max_symbol < std::max(n, (uint64_t)256)) {
+        construct_sa(sa, text, max_symbol+1);
+        return;
+    }
+    std::vector<uint64_t> symbols(n);
+    for (uint64_t i=0; i < n; ++i) {
+        symbols[i] = text[i];
+    }
+    std::sort(symbols.begin(), symbols.end());
+    symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+    int_vector<> mapped(n, 0, bits::hi(symbols.size())+1);
+    for (uint64_t i=0; i < n; ++i) {
+        mapped[i] = std::lower_bound(symbols.begin(), symbols.end(), (uint64_t)text[i]) - symbols.begin();
+    }
+    const uint64_t sigma = symbols.size();
+    std::vector<uint64_t>().swap(symbols);
+    construct_sa(sa, mapped, sigma);
+}
+
+} // end namespace sais
+} // end namespace sdsl
+
+#endif
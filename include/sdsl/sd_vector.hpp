@@ -26,6 +26,8 @@
 #include "select_support_mcl.hpp"
 #include "util.hpp"
 #include "iterators.hpp"
+#include <atomic>
+#include <stdexcept>
 
 //! Namespace for the succinct data structure library
 namespace sdsl
@@ -43,6 +45,107 @@ template<class t_hi_bit_vector= bit_vector,
          class t_select_0     = typename t_hi_bit_vector::select_0_type>
 class select_support_sd;  // in sd_vector
 
+//! Class for in-place construction of sd_vector from a strictly increasing sequence
+/*! The builder writes the low and high parts of the Elias-Fano representation
+ *  directly, i.e. no plain bit_vector of length n is ever materialized.
+ *  The positions are either added one by one with set(i), or in chunks with
+ *  set(r, begin, end). Chunks covering disjoint ranks may be added
+ *  concurrently from different threads. The two variants should not be mixed.
+ *
+ *  \par Example
+ *  \code
+ *  sd_vector_builder builder(n, m);
+ *  for (auto pos : positions) builder.set(pos);
+ *  sd_vector<> sdv(builder);
+ *  \endcode
+ */
+class sd_vector_builder
+{
+        template<class t_hi_bit_vector, class t_select_1, class t_select_0>
+        friend class sd_vector;
+
+    public:
+        typedef bit_vector::size_type size_type;
+
+    private:
+        size_type m_size     = 0;  // length of the bit vector
+        size_type m_capacity = 0;  // number of ones
+        uint8_t   m_wl       = 0;  // width of the low part
+        size_type m_tail     = 0;  // last position added by set(i)
+        std::atomic<size_type> m_items; // number of positions added so far
+
+        int_vector<> m_low;
+        bit_vector   m_high;
+
+        // ORs x into the zero initialized bits [offset..offset+len) of word; thread-safe
+        static void atomic_write_int(uint64_t* word, uint64_t x, uint8_t offset, uint8_t len) {
+            __atomic_fetch_or(word, x << offset, __ATOMIC_RELAXED);
+            if (offset + len > 64) {
+                __atomic_fetch_or(word+1, x >> (64-offset), __ATOMIC_RELAXED);
+            }
+        }
+
+    public:
+        sd_vector_builder();
+
+        //! Constructor
+        /*! \param n Size of the bit vector.
+         *  \param m Number of set bits.
+         */
+        sd_vector_builder(size_type n, size_type m);
+
+        sd_vector_builder(const sd_vector_builder&) = delete;
+        sd_vector_builder& operator=(const sd_vector_builder&) = delete;
+
+        //! Size of the bit vector.
+        size_type size() const { return m_size; }
+
+        //! Number of set bits which have to be added.
+        size_type capacity() const { return m_capacity; }
+
+        //! Number of set bits which have been added so far.
+        size_type items() const { return m_items; }
+
+        //! Sets the bit at position i.
+        /*! \param i Position; has to be larger than the previous position.
+         *  \throws std::runtime_error if i is out of order or out of range,
+         *          or if all m ones have already been added.
+         */
+        void set(size_type i);
+
+        //! Sets the bits at the positions of [begin, end)
+        /*! \param r     Number of set bits before *begin in the bit vector.
+         *  \param begin Iterator to the first position of the chunk.
+         *  \param end   Iterator past the last position of the chunk.
+         *  \throws std::runtime_error if the chunk is not strictly increasing,
+         *          or a position or rank is out of range.
+         *  \par Concurrency
+         *        Calls for disjoint rank ranges [r..r+(end-begin)) can be
+         *        executed concurrently. Each rank has to be covered by
+         *        exactly one call.
+         */
+        template<class t_itr>
+        void set(size_type r, t_itr begin, t_itr end) {
+            size_type len = std::distance(begin, end);
+            if (r + len > m_capacity)
+                throw std::runtime_error("sd_vector_builder: too many positions.");
+            uint64_t* low  = const_cast<uint64_t*>(m_low.data());
+            uint64_t* high = const_cast<uint64_t*>(m_high.data());
+            size_type prev = 0;
+            for (size_type k=r; begin != end; ++begin, ++k) {
+                size_type i = *begin;
+                if (i >= m_size or (k > r and i <= prev))
+                    throw std::runtime_error("sd_vector_builder: positions have to be strictly increasing and smaller than the size.");
+                uint64_t low_pos = k*m_wl;
+                atomic_write_int(low+(low_pos>>6), i & bits::lo_set[m_wl], low_pos&63, m_wl);
+                uint64_t high_pos = (i >> m_wl) + k;
+                __atomic_fetch_or(high+(high_pos>>6), 1ULL << (high_pos&63), __ATOMIC_RELAXED);
+                prev = i;
+            }
+            m_items += len;
+        }
+};
+
 //! A bit vector which compresses very sparse populated bit vectors by
 // representing the positions of 1 by the Elias-Fano representation for non-decreasing sequences
 /*!
@@ -107,6 +210,32 @@ class sd_vector
             m_high_0_select.set_vector(&m_high);
         }
 
+        // position of the (k+1)-th one of m_high, which follows the zero at
+        // position i; it is looked up in the word of i before select_1 is used
+        size_type next_high_one(size_type i, size_type k, const bit_vector&)const {
+            uint64_t w = m_high.data()[i>>6] >> (i&63);
+            if (w)
+                return i + bits::lo(w);
+            return m_high_1_select.select(k+1);
+        }
+        template<class t_bv>
+        size_type next_high_one(size_type, size_type k, const t_bv&)const {
+            return m_high_1_select.select(k+1);
+        }
+
+        // position of the k-th one of m_high, which precedes the zero at
+        // position i; it is looked up in the word of i before select_1 is used
+        size_type prev_high_one(size_type i, size_type k, const bit_vector&)const {
+            uint64_t w = m_high.data()[i>>6] << (63-(i&63));
+            if (w)
+                return i - 63 + bits::hi(w);
+            return m_high_1_select.select(k);
+        }
+        template<class t_bv>
+        size_type prev_high_one(size_type, size_type k, const t_bv&)const {
+            return m_high_1_select.select(k);
+        }
+
     public:
         const hi_bit_vector_type&    high          = m_high;
         const int_vector<>&          low           = m_low;
@@ -152,11 +281,33 @@ class sd_vector
             util::init_support(m_high_0_select, &m_high);
         }
 
+        //! Constructs the sd_vector from the content of builder
+        /*! \param builder Builder which contains all m positions; it is
+         *                 empty after the call.
+         *  \param threads Maximal number of threads used to initialize the
+         *                 select structures of the high part.
+         *  \throws std::runtime_error if not all positions were added.
+         */
+        sd_vector(sd_vector_builder& builder, uint64_t threads=1) {
+            if (builder.items() != builder.capacity()) {
+                throw std::runtime_error("sd_vector: the builder is not full.");
+            }
+            m_size = builder.m_size;
+            m_wl   = builder.m_wl;
+            m_low.swap(builder.m_low);
+            util::assign(m_high, builder.m_high);
+            util::init_support(m_high_1_select, &m_high, threads);
+            util::init_support(m_high_0_select, &m_high, threads);
+            builder.m_size = builder.m_capacity = builder.m_tail = 0;
+            builder.m_items = 0;
+        }
+
         //! Accessing the i-th element of the original bit_vector
         /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
         *   \return The i-th bit of the original bit_vector
         *   \par Time complexity
-        *           \f$ \Order{t_{select0} + n/m} \f$, where m equals the number of zeros
+        *           \f$ \Order{t_{select0} + k} \f$, where \f$ k \leq 2^{wl} \approx n/m \f$
+        *           is the number of set bits in the bucket of i
         *    \par Remark
          *         The time complexity can be easily improved to
         *            \f$\Order{t_{select0}+\log(n/m)}\f$
@@ -179,6 +330,69 @@ class sd_vector
             return m_high[sel_high] and m_low[rank_low] == val_low;
         }
 
+        //! Returns the position of the first set bit at or after position i
+        /*! \param i An index i with \f$ 0 \leq i \leq size()  \f$.
+         *  \return The smallest j with \f$ j\geq i \f$ and bit j set, or
+         *          size() if there is no such position.
+         *  \par Time complexity
+         *       \f$ \Order{t_{select0} + k + t_{select1}} \f$, where
+         *       \f$ k \leq 2^{wl} \approx n/m \f$ is the number of set bits
+         *       in the bucket of i.
+         *
+         *  The bucket of i in the high part is entered by one select_0 query
+         *  and scanned from left to right. If the bucket contains no
+         *  answer, the next set bit of the high part starts the next
+         *  non-empty bucket. It is taken from the current word if possible
+         *  and otherwise the select_1 structure skips the empty buckets.
+         */
+        size_type successor(size_type i)const {
+            if (i >= m_size)
+                return m_size;
+            size_type high_val = (i >> (m_wl));
+            size_type val_low  = i & bits::lo_set[ m_wl ];
+            size_type sel_high = high_val ? m_high_0_select.select(high_val) + 1 : 0;
+            size_type rank_low = sel_high - high_val;
+            while (m_high[sel_high]) {
+                if (m_low[rank_low] >= val_low)
+                    return (high_val << m_wl) + m_low[rank_low];
+                ++sel_high; ++rank_low;
+            }
+            if (rank_low == m_low.size())
+                return m_size;
+            // all later set bits lie in later buckets; jump to the next one
+            return m_low[rank_low] + ((next_high_one(sel_high, rank_low, m_high) - rank_low) << m_wl);
+        }
+
+        //! Returns the position of the last set bit at or before position i
+        /*! \param i An index i with \f$ 0 \leq i < size()  \f$.
+         *  \return The largest j with \f$ j\leq i \f$ and bit j set, or
+         *          size() if there is no such position.
+         *  \par Time complexity
+         *       \f$ \Order{t_{select0} + k + t_{select1}} \f$, where
+         *       \f$ k \leq 2^{wl} \approx n/m \f$ is the number of set bits
+         *       in the bucket of i.
+         *
+         *  Symmetric to successor: the bucket of i is scanned from right
+         *  to left and the select_1 structure skips the empty buckets
+         *  before it.
+         */
+        size_type predecessor(size_type i)const {
+            assert(i < m_size);
+            size_type high_val = (i >> (m_wl));
+            size_type val_low  = i & bits::lo_set[ m_wl ];
+            size_type sel_high = m_high_0_select.select(high_val + 1);
+            size_type rank_low = sel_high - high_val;
+            while (sel_high > 0 and m_high[sel_high-1]) {
+                --sel_high; --rank_low;
+                if (m_low[rank_low] <= val_low)
+                    return (high_val << m_wl) + m_low[rank_low];
+            }
+            if (rank_low == 0)
+                return m_size;
+            // all earlier set bits lie in earlier buckets; jump to the previous one
+            return m_low[rank_low-1] + ((prev_high_one(sel_high-1, rank_low, m_high) + 1 - rank_low) << m_wl);
+        }
+
         //! Swap method
         void swap(sd_vector& v) {
             if (this != &v) {
@@ -251,19 +465,9 @@ class rank_support_sd
     private:
         const bit_vector_type* m_v;
 
-    public:
-
-        explicit rank_support_sd(const bit_vector_type* v=nullptr) {
-            set_vector(v);
-        }
-
-        size_type rank(size_type i)const {
-            assert(m_v != nullptr);
-            assert(i <= m_v->size());
-            // split problem in two parts:
-            // (1) find  >=
+        // rank for a known position sel_high of the (i>>wl)+1-th zero in high
+        size_type rank(size_type i, size_type sel_high)const {
             size_type high_val = (i >> (m_v->m_wl));
-            size_type sel_high = m_v->m_high_0_select.select(high_val + 1);
             size_type rank_low = sel_high - high_val; //
             if (0 == rank_low)
                 return 0;
@@ -277,10 +481,63 @@ class rank_support_sd
             return rank_low+1;
         }
 
+    public:
+
+        explicit rank_support_sd(const bit_vector_type* v=nullptr) {
+            set_vector(v);
+        }
+
+        size_type rank(size_type i)const {
+            assert(m_v != nullptr);
+            assert(i <= m_v->size());
+            // split problem in two parts:
+            // (1) find  >=
+            size_type high_val = (i >> (m_v->m_wl));
+            return rank(i, m_v->m_high_0_select.select(high_val + 1));
+        }
+
         const size_type operator()(size_type i)const {
             return rank(i);
         }
 
+        //! Position of the first set bit at or after i, see sd_vector::successor.
+        size_type successor(size_type i)const {
+            return m_v->successor(i);
+        }
+
+        //! Position of the last set bit at or before i, see sd_vector::predecessor.
+        size_type predecessor(size_type i)const {
+            return m_v->predecessor(i);
+        }
+
+        //! Answers a batch of rank queries.
+        /*! \param pos Array of n arguments for rank.
+         *  \param n   Number of queries.
+         *  \param out Array of size n; out[k] is set to rank(pos[k]).
+         *  The select queries on the high part are answered by the batch
+         *  select of t_select_0. Afterwards the low part of query
+         *  k+constants::SDSL_PREFETCH_DIST is prefetched while query k
+         *  is answered.
+         */
+        void rank(const size_type* pos, size_type n, size_type* out)const {
+            assert(m_v != nullptr);
+            const size_type d = constants::SDSL_PREFETCH_DIST;
+            size_type arg[4*d], sel_high[4*d];
+            for (size_type k0=0; k0 < n; k0 += 4*d) {
+                size_type m = std::min(4*d, n-k0);
+                for (size_type j=0; j < m; ++j)
+                    arg[j] = (pos[k0+j] >> (m_v->m_wl)) + 1;
+                m_v->m_high_0_select.select(arg, m, sel_high);
+                for (size_type j=0; j < m; ++j) {
+                    if (j+d < m and sel_high[j+d] > arg[j+d]) {
+                        size_type rank_low = sel_high[j+d] - arg[j+d];
+                        __builtin_prefetch(m_v->m_low.data() + ((rank_low*m_v->m_wl)>>6));
+                    }
+                    out[k0+j] = rank(pos[k0+j], sel_high[j]);
+                }
+            }
+        }
+
         const size_type size()const {
             return m_v->size();
         }
@@ -339,6 +596,30 @@ class select_support_sd
             return select(i);
         }
 
+        //! Answers a batch of select queries.
+        /*! \param pos Array of n arguments for select.
+         *  \param n   Number of queries.
+         *  \param out Array of size n; out[k] is set to select(pos[k]).
+         *  The low parts of a chunk of queries are prefetched before the
+         *  select queries on the high part are answered by the batch select
+         *  of t_select_1.
+         */
+        void select(const size_type* pos, size_type n, size_type* out)const {
+            assert(m_v != nullptr);
+            const size_type d = constants::SDSL_PREFETCH_DIST;
+            size_type sel_high[4*d];
+            for (size_type k0=0; k0 < n; k0 += 4*d) {
+                size_type m = std::min(4*d, n-k0);
+                for (size_type j=0; j < m; ++j)
+                    __builtin_prefetch(m_v->m_low.data() + (((pos[k0+j]-1)*m_v->m_wl)>>6));
+                m_v->m_high_1_select.select(pos+k0, m, sel_high);
+                for (size_type j=0; j < m; ++j) {
+                    size_type i = pos[k0+j];
+                    out[k0+j] = m_v->m_low[i-1] + ((sel_high[j] + 1 - i) << (m_v->m_wl));
+                }
+            }
+        }
+
         const size_type size()const {
             return m_v->size();
         }
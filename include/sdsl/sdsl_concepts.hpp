@@ -45,6 +45,12 @@ struct lcp_tree_and_lf_compressed_tag {};
 struct byte_alphabet_tag { static const uint8_t WIDTH=8; };
 struct int_alphabet_tag { static const uint8_t WIDTH=0; };
 
+//! Indicates if an index can be constructed from the text and the BWT without the SA
+template<class t_index>
+struct construct_without_sa_trait {
+    enum {value = false};
+};
+
 } // end namespace sdsl
 
 #endif
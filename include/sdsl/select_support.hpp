@@ -102,6 +102,10 @@ struct select_support_trait {
         return 0;
     }
 
+    static size_type args_in_the_words(const uint64_t*, size_type, uint64_t) {
+        return 0;
+    }
+
     static size_type ith_arg_pos_in_the_word(uint64_t, size_type, uint64_t) {
         return 0;
     }
@@ -135,6 +139,10 @@ struct select_support_trait<0,1> {
     static size_type args_in_the_word(uint64_t w, uint64_t&) {
         return bits::cnt(~w);
     }
+    //! Number of arguments in the n words starting at data.
+    static size_type args_in_the_words(const uint64_t* data, size_type n, uint64_t) {
+        return (n<<6) - bits::cnt(data, n);
+    }
     static size_type ith_arg_pos_in_the_word(uint64_t w, size_type i, uint64_t) {
         return bits::sel(~w, i);
     }
@@ -165,6 +173,10 @@ struct select_support_trait<1,1> {
     static size_type args_in_the_word(uint64_t w, uint64_t&) {
         return bits::cnt(w);
     }
+    //! Number of arguments in the n words starting at data.
+    static size_type args_in_the_words(const uint64_t* data, size_type n, uint64_t) {
+        return bits::cnt(data, n);
+    }
     static size_type ith_arg_pos_in_the_word(uint64_t w, size_type i, uint64_t) {
         return bits::sel(w, i);
     }
@@ -195,6 +207,14 @@ struct select_support_trait<10,2> {
     static size_type args_in_the_word(uint64_t w, uint64_t& carry) {
         return bits::cnt10(w, carry);
     }
+    //! Number of arguments in the n words starting at data.
+    static size_type args_in_the_words(const uint64_t* data, size_type n, uint64_t carry) {
+        size_type res = 0;
+        for (size_type i=0; i < n; ++i) {
+            res += bits::cnt10(data[i], carry);
+        }
+        return res;
+    }
     static size_type ith_arg_pos_in_the_word(uint64_t w, size_type i, uint64_t carry) {
         return bits::sel(bits::map10(w, carry), i);
     }
@@ -227,6 +247,14 @@ struct select_support_trait<01,2> {
     static size_type args_in_the_word(uint64_t w, uint64_t& carry) {
         return bits::cnt01(w, carry);
     }
+    //! Number of arguments in the n words starting at data.
+    static size_type args_in_the_words(const uint64_t* data, size_type n, uint64_t carry) {
+        size_type res = 0;
+        for (size_type i=0; i < n; ++i) {
+            res += bits::cnt01(data[i], carry);
+        }
+        return res;
+    }
     static size_type ith_arg_pos_in_the_word(uint64_t w, size_type i, uint64_t carry) {
         return bits::sel(bits::map01(w, carry), i);
     }
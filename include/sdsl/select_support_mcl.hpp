@@ -24,6 +24,8 @@
 #include "int_vector.hpp"
 #include "util.hpp"
 #include "select_support.hpp"
+#include <functional>
+#include <vector>
 
 //! Namespace for the succinct data structure library.
 namespace sdsl
@@ -90,10 +92,14 @@ class select_support_mcl : public select_support
         select_support_mcl(select_support_mcl<t_b,t_pat_len>&&) = default;
         ~select_support_mcl();
         void init_slow(const bit_vector* v=nullptr);
+        //! Initializes the data structure with up to `threads` threads.
+        void init_parallel(const bit_vector* v, size_type threads);
         //! Select function
         inline const size_type select(size_type i) const;
         //! Alias for select(i).
         inline const size_type operator()(size_type i)const;
+        //! Batch select function: out[k] is set to select(pos[k]) for k in [0..n-1]
+        void select(const size_type* pos, size_type n, size_type* out)const;
         size_type serialize(std::ostream& out, structure_tree_node* v=nullptr, std::string name="")const;
         void load(std::istream& in, const bit_vector* v=nullptr);
         void set_vector(const bit_vector* v=nullptr);
@@ -103,6 +109,16 @@ class select_support_mcl : public select_support
 };
 
 
+namespace util
+{
+//! Initialise select_support_mcl with up to threads threads
+template<uint8_t t_b, uint8_t t_pat_len>
+void init_support(select_support_mcl<t_b,t_pat_len>& s, const bit_vector* x, uint64_t threads)
+{
+    s.init_parallel(x, threads);
+}
+}
+
 template<uint8_t t_b, uint8_t t_pat_len>
 select_support_mcl<t_b,t_pat_len>::select_support_mcl(const bit_vector* f_v):select_support(f_v)
 {
@@ -317,6 +333,120 @@ void select_support_mcl<t_b,t_pat_len>::init_fast(const bit_vector* v)
 }
 
 
+//! Initializes the data structure with up to `threads` threads
+/*! The bit vector is split into one word range per thread. The threads
+ *  (1) count the arguments in their range,
+ *  (2) record every 64th argument position and the last argument
+ *      position of each superblock, and
+ *  (3) build the long superblocks and miniblocks of disjoint sets of
+ *      superblocks.
+ *  Bit patterns of length 2 are initialized sequentially.
+ */
+template<uint8_t t_b, uint8_t t_pat_len>
+void select_support_mcl<t_b,t_pat_len>::init_parallel(const bit_vector* v, size_type threads)
+{
+    if (m_miniblock != nullptr) delete [] m_miniblock;
+    if (m_longsuperblock != nullptr) delete [] m_longsuperblock;
+    m_miniblock = m_longsuperblock = nullptr;
+    if (t_pat_len > 1 or threads < 2 or v == nullptr or v->size() < 100000) {
+        if (t_pat_len>1 or (v!=nullptr and  v->size() < 100000))
+            init_slow(v);
+        else
+            init_fast(v);
+        return;
+    }
+    set_vector(v);
+    initData();
+
+    const size_type SUPER_BLOCK_SIZE = 4096;
+    const uint64_t* data = v->data();
+    const size_type words = (v->size()+63)>>6;
+    // returns the argument bits of word j
+    auto arg_word = [&](size_type j) {
+        uint64_t x = t_b ? data[j] : ~data[j];
+        if (j+1 == words and (v->size()&63))
+            x &= bits::lo_set[v->size()&63];
+        return x;
+    };
+    threads = std::min(threads, words);
+    std::vector<size_type> range(threads+1), args(threads+1, 0);
+    for (size_type t=0; t <= threads; ++t) {
+        range[t] = (words*t)/threads;
+    }
+    // (1) count the arguments of each range
+    util::parallel_for(threads, [&](size_type t) {
+        size_type cnt = 0;
+        for (size_type j=range[t]; j < range[t+1]; ++j)
+            cnt += bits::cnt(arg_word(j));
+        args[t+1] = cnt;
+    });
+    for (size_type t=0; t < threads; ++t) {
+        args[t+1] += args[t];
+    }
+    m_arg_cnt = args[threads];
+    if (m_arg_cnt == 0)
+        return;
+    size_type sb = (m_arg_cnt+SUPER_BLOCK_SIZE-1)/SUPER_BLOCK_SIZE; // number of superblocks
+    // (2) sample every 64th argument and the last argument of each superblock
+    std::vector<size_type> sample((m_arg_cnt+63)/64), last(sb);
+    auto last_arg = [&](size_type i) { // index of the last argument in superblock i
+        return std::min((i+1)*SUPER_BLOCK_SIZE, m_arg_cnt)-1;
+    };
+    util::parallel_for(threads, [&](size_type t) {
+        size_type r  = args[t];             // arguments before word j
+        size_type ns = ((r+63)/64)*64;      // next sampled argument
+        size_type nb = r/SUPER_BLOCK_SIZE;  // next superblock whose last argument is searched
+        for (size_type j=range[t]; j < range[t+1]; ++j) {
+            uint64_t x = arg_word(j);
+            size_type c = bits::cnt(x);
+            if (c == 0)
+                continue;
+            for (; ns < r+c; ns += 64)
+                sample[ns/64] = (j<<6) + bits::sel(x, ns-r+1);
+            for (; nb < sb and last_arg(nb) < r+c; ++nb)
+                last[nb] = (j<<6) + bits::sel(x, last_arg(nb)-r+1);
+            r += c;
+        }
+    });
+    m_superblock = int_vector<0>(sb, 0, m_logn);
+    m_miniblock  = new int_vector<0>[sb];
+    bool long_blocks = false;
+    for (size_type i=0; i < sb; ++i) {
+        m_superblock[i] = sample[i*64];
+        long_blocks |= (last[i] - sample[i*64] > m_logn4);
+    }
+    if (long_blocks)
+        m_longsuperblock = new int_vector<0>[sb];
+    // (3) build the superblocks
+    util::parallel_for(threads, [&](size_type t) {
+        for (size_type i=(sb*t)/threads; i < (sb*(t+1))/threads; ++i) {
+            size_type first = sample[i*64];
+            size_type pos_diff = last[i] - first;
+            if (pos_diff > m_logn4) { // long block
+                int_vector<0> lsb(SUPER_BLOCK_SIZE, 0, bits::hi(last[i]) + 1);
+                for (size_type j=first>>6, k=0; j <= (last[i]>>6); ++j) {
+                    uint64_t x = arg_word(j);
+                    if (j == (first>>6))
+                        x &= bits::lo_unset[first&63];
+                    if (j == (last[i]>>6))
+                        x &= bits::lo_set[(last[i]&63)+1];
+                    while (x) {
+                        lsb[k++] = (j<<6) + bits::lo(x);
+                        x &= x-1;
+                    }
+                }
+                m_longsuperblock[i].swap(lsb);
+            } else { // short block
+                size_type samples = std::min((m_arg_cnt-i*SUPER_BLOCK_SIZE+63)/64, (size_type)64);
+                m_miniblock[i] = int_vector<0>(64, 0, bits::hi(pos_diff)+1);
+                for (size_type j=0; j < samples; ++j) {
+                    m_miniblock[i][j] = sample[i*64+j] - first;
+                }
+            }
+        }
+    });
+}
+
 template<uint8_t t_b, uint8_t t_pat_len>
 inline auto select_support_mcl<t_b,t_pat_len>::select(size_type i)const -> const size_type
 {
@@ -372,6 +502,39 @@ inline auto select_support_mcl<t_b,t_pat_len>::operator()(size_type i)const -> c
     return select(i);
 }
 
+template<uint8_t t_b, uint8_t t_pat_len>
+void select_support_mcl<t_b,t_pat_len>::select(const size_type* pos, size_type n, size_type* out)const
+{
+    // The memory accesses of a query are prefetched in two stages:
+    // (1) the superblock sample and the long/mini block descriptors
+    //     2*SDSL_PREFETCH_DIST queries ahead and
+    // (2) the entry in the long superblock or miniblock, which depends
+    //     on the descriptors, SDSL_PREFETCH_DIST queries ahead.
+    const size_type d = constants::SDSL_PREFETCH_DIST;
+    for (size_type k=0; k < n; ++k) {
+        if (k+2*d < n) {
+            size_type sb_idx = (pos[k+2*d]-1)>>12;
+            __builtin_prefetch(m_superblock.data() + ((sb_idx*m_superblock.width())>>6));
+            __builtin_prefetch(m_miniblock + sb_idx);
+            if (m_longsuperblock!=nullptr)
+                __builtin_prefetch(m_longsuperblock + sb_idx);
+        }
+        if (k+d < n) {
+            size_type i = pos[k+d]-1;
+            size_type sb_idx = i>>12;
+            size_type offset = i&0xFFF;
+            if (m_longsuperblock!=nullptr and !m_longsuperblock[sb_idx].empty()) {
+                const int_vector<0>& lsb = m_longsuperblock[sb_idx];
+                __builtin_prefetch(lsb.data() + ((offset*lsb.width())>>6));
+            } else {
+                const int_vector<0>& mb = m_miniblock[sb_idx];
+                __builtin_prefetch(mb.data() + (((offset>>6)*mb.width())>>6));
+            }
+        }
+        out[k] = select_support_mcl::select(pos[k]);
+    }
+}
+
 template<uint8_t t_b, uint8_t t_pat_len>
 void select_support_mcl<t_b,t_pat_len>::initData()
 {
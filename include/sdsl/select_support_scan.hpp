@@ -89,6 +89,23 @@ inline const typename select_support_scan<t_b,t_pat_len>::size_type select_suppo
     carry = select_support_trait<t_b,t_pat_len>::get_carry(*data);
     uint64_t old_carry = carry;
     args = select_support_trait<t_b,t_pat_len>::args_in_the_word(*(++data), carry);
+    if (t_pat_len == 1) {
+        // skip blocks of words with the bulk count of bits::cnt
+        const size_type block = 32;
+        const uint64_t* end = m_v->data() + ((m_v->size()+63)>>6);
+        while (sum_args + args < i and data + 1 + block <= end) {
+            size_type block_args = select_support_trait<t_b,t_pat_len>::args_in_the_words(data+1, block, carry);
+            if (sum_args + args + block_args >= i)
+                break;
+            sum_args += args + block_args;
+            data += block;
+            word_pos += block;
+            carry = select_support_trait<t_b,t_pat_len>::get_carry(*data);
+            old_carry = carry;
+            args = select_support_trait<t_b,t_pat_len>::args_in_the_word(*(++data), carry);
+            word_pos += 1;
+        }
+    }
     while (sum_args + args < i) {
         sum_args += args;
         assert(data+1 < m_v->data() + (m_v->capacity()>>6));
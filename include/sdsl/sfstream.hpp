@@ -10,6 +10,7 @@
 #include <string>
 #include "sdsl/ram_fs.hpp"
 #include "sdsl/ram_filebuf.hpp"
+#include "sdsl/mmap_filebuf.hpp"
 
 namespace sdsl
 {
@@ -74,6 +75,29 @@ class isfstream : public std::istream
         std::streampos tellg();
 };
 
+//! Input stream which reads from a memory mapped file
+/*! int_vectors which are loaded from this stream point into the mapping
+ *  instead of copying their data, see mmap_filebuf.
+ */
+class mmap_ifstream : public std::istream
+{
+    private:
+        mmap_filebuf m_streambuf;
+    public:
+        //! Standard constructor.
+        mmap_ifstream();
+        //! Constructor taking a file name.
+        mmap_ifstream(const std::string& file);
+        //! Open the stream.
+        std::streambuf* open(const std::string& file);
+        //! Is the stream open?
+        bool is_open();
+        //! Close the stream.
+        void close();
+        //! Standard destructor
+        ~mmap_ifstream();
+};
+
 } // end namespace
 
 #endif
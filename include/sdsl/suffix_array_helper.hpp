@@ -592,6 +592,25 @@ void set_isa_samples(int_vector_buffer<int_width>& sa_buf, typename Csa::isa_sam
     }
 }
 
+//! Sets the ISA samples from a walk over the rows of the SA, see sa_walk_type
+template<class Csa, class t_walk>
+void set_isa_samples(typename Csa::size_type n, const t_walk& walk, typename Csa::isa_sample_type& isa_sample)
+{
+    isa_sample.width(bits::hi(n)+1);
+    if (n >= 1) {
+        isa_sample.resize((n-1+Csa::isa_sample_dens-1)/Csa::isa_sample_dens + 1);
+    }
+    util::set_to_value(isa_sample, 0);
+
+    walk([n, &isa_sample](uint64_t i, uint64_t sa, uint64_t) {
+        if ((sa % Csa::isa_sample_dens) == 0) {
+            isa_sample[sa/Csa::isa_sample_dens] = i;
+        } else if (sa+1 == n) {
+            isa_sample[(sa+Csa::isa_sample_dens-1)/Csa::isa_sample_dens] = i;
+        }
+    });
+}
+
 
 }
 
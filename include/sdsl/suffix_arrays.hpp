@@ -30,6 +30,7 @@
 #include "csa_sada.hpp"
 #include "wavelet_trees.hpp"
 #include "construct.hpp"
+#include "merge_bwt.hpp"
 #include "suffix_array_algorithm.hpp"
 
 namespace sdsl
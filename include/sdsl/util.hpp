@@ -43,10 +43,14 @@
 #include <sys/resource.h> // for struct rusage
 #include <iomanip>
 #include <numeric>
+#include <algorithm>
 #include <random>
 #include <chrono>
 #include <atomic>
+#include <functional>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 // macros to transform a defined name to a string
 #define SDSL_STR(x) #x
@@ -162,6 +166,26 @@ template <class t_int_vec>
 typename t_int_vec::size_type prev_bit(const t_int_vec& v, uint64_t idx);
 
 
+//============= Threads =============================
+
+//! Runs f(0), ..., f(threads-1) in parallel; f(0) runs in the calling thread.
+/*! The other threads use the allocator of the calling thread for their
+ *  int_vectors, see mm::allocator_scope.
+ */
+void parallel_for(uint32_t threads, const std::function<void(uint32_t)>& f);
+
+//! Runs the tasks with up to threads threads; task j runs in thread j mod threads.
+inline void parallel_invoke(uint32_t threads, const std::vector<std::function<void()>>& tasks)
+{
+    threads = std::max(std::min(threads, (uint32_t)tasks.size()), (uint32_t)1);
+    parallel_for(threads, [&](uint32_t t) {
+        for (size_t j=t; j < tasks.size(); j += threads) {
+            tasks[j]();
+        }
+    });
+}
+
+
 //============= Handling files =============================
 
 //! Get the size of a file in bytes
@@ -225,7 +249,7 @@ uint64_t pid();
 class _id_helper
 {
     private:
-        static uint64_t id;
+        static std::atomic<uint64_t> id;
     public:
         static uint64_t getId() {
             return id++;
@@ -307,6 +331,18 @@ void init_support(S& s, const X* x)
     s.set_vector(x); // set the support object's  pointer to x
 }
 
+//! Initialise support data structure with up to threads threads
+/*! \param s       Support structure which should be initialized
+ *  \param x       Pointer to the data structure which should be supported.
+ *  \param threads Maximal number of threads.
+ *  Support structures without parallel construction are initialized sequentially.
+ */
+template<class S, class X>
+void init_support(S& s, const X* x, uint64_t)
+{
+    init_support(s, x);
+}
+
 class spin_lock
 {
     private:
@@ -371,22 +407,29 @@ void util::mod(t_int_vec& v, typename t_int_vec::size_type m)
 template<class t_int_vec>
 void util::bit_compress(t_int_vec& v)
 {
+    typedef typename t_int_vec::size_type size_type;
+    // the elements are decoded and encoded in blocks, see bits::read_ints
+    const size_type block_size = 1024;
+    uint64_t block[block_size];
+    const size_type n = v.size();
+    const uint8_t old_width = v.width();
     typename t_int_vec::value_type max=0;
-    for (typename t_int_vec::size_type i=0; i < v.size(); ++i) {
-        if (v[i] > max) {
-            max = v[i];
+    for (size_type i=0; i < n; i += block_size) {
+        size_type m = std::min(block_size, n-i);
+        bits::read_ints(v.m_data + ((i*old_width)>>6), (i*old_width)&0x3F, old_width, m, block);
+        for (size_type k=0; k < m; ++k) {
+            if (block[k] > max) {
+                max = block[k];
+            }
         }
     }
     uint8_t min_width = bits::hi(max)+1;
-    uint8_t old_width = v.width();
     if (old_width > min_width) {
-        const uint64_t* read_data = v.m_data;
-        uint64_t* write_data = v.m_data;
-        uint8_t read_offset = 0;
-        uint8_t write_offset = 0;
-        for (typename t_int_vec::size_type i=0; i < v.size(); ++i) {
-            uint64_t x = bits::read_int_and_move(read_data, read_offset, old_width);
-            bits::write_int_and_move(write_data,  x, write_offset, min_width);
+        // in place: a block is written in front of the unread elements
+        for (size_type i=0; i < n; i += block_size) {
+            size_type m = std::min(block_size, n-i);
+            bits::read_ints(v.m_data + ((i*old_width)>>6), (i*old_width)&0x3F, old_width, m, block);
+            bits::write_ints(v.m_data + ((i*min_width)>>6), (i*min_width)&0x3F, min_width, m, block);
         }
         v.bit_resize(v.size()*min_width);
         v.width(min_width);
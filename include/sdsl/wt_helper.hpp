@@ -31,6 +31,17 @@ void calculate_character_occurences(t_file_buffer& text, const int_vector_size_t
 }
 
 
+//! Constructs wt from the first size symbols of buf with up to threads threads
+/*! wt_int, wt_pc and wt_rlmn are constructed by several threads, the
+ *  other wavelet trees by one thread.
+ */
+template<class t_wt, class t_buf>
+void construct_wt(t_wt& wt, t_buf& buf, int_vector_size_type size, uint32_t)
+{
+    t_wt tmp(buf, size);
+    wt.swap(tmp);
+}
+
 template<class t_rac, class sigma_type>
 void calculate_effective_alphabet_size(const t_rac& C, sigma_type& sigma)
 {
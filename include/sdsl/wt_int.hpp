@@ -29,6 +29,7 @@
 #include "select_support_mcl.hpp"
 #include "temp_write_read_buffer.hpp"
 #include "util.hpp"
+#include "wt_helper.hpp"
 #include <set> // for calculating the alphabet size
 #include <map> // for mapping a symbol to its lexicographical index
 #include <algorithm> // for std::swap
@@ -103,6 +104,120 @@ class wt_int
             m_path_rank_off = int_vector<64>(max_depth+1);
         }
 
+        // Level-wise construction of the tree bits and sigma with threads
+        // threads. The text is split into one chunk per thread. At each level
+        // the threads first write the bits of their chunk and then move the
+        // symbols of their chunk to their positions in the next level. The
+        // nodes of a level are the runs of equal prefixes in rac.
+        template<class t_sym, class t_rac>
+        void construct_levels(t_rac& text, bit_vector& tree, uint32_t threads) {
+            const size_type n = m_size;
+            std::vector<t_sym> rac(text.begin(), text.end());
+            util::clear(text);
+            const size_type chunk = (n+threads-1)/threads;
+            std::vector<t_sym> next(m_max_depth > 1 ? n : 0);
+            std::vector<size_type> b(threads+1), zeros(threads+1), first(threads), last(threads), sigma(threads);
+            tree = bit_vector(n*m_max_depth, 0);
+            for (uint32_t k=0; k < m_max_depth; ++k) {
+                const uint32_t shift = m_max_depth-k-1;
+                const uint64_t mask = bits::lo_set[k];
+                const size_type off = k*n;
+                auto prefix = [&](uint64_t x) {
+                    return k ? (x >> (shift+1)) & mask : 0;
+                };
+                auto boundary = [&](size_type i) {
+                    return i == 0 or prefix(rac[i]) != prefix(rac[i-1]);
+                };
+                // zeros in [i, j) of the level
+                auto level_zeros = [&](size_type i, size_type j) {
+                    size_type cnt0 = j-i;
+                    for (; i < j; i += 64) {
+                        cnt0 -= bits::cnt(tree.get_int(off+i, std::min((size_type)64, j-i)));
+                    }
+                    return cnt0;
+                };
+                // chunks start at word boundaries of the tree
+                b[0] = 0;
+                b[threads] = n;
+                for (uint32_t t=1; t < threads; ++t) {
+                    b[t] = std::max(b[t-1], std::min(n, ((off+t*chunk+63) & ~(size_type)63) - off));
+                }
+                // (1) write the bits and find the first and last node start of each chunk
+                util::parallel_for(threads, [&](uint32_t t) {
+                    size_type cnt0 = 0;
+                    first[t] = last[t] = n;
+                    for (size_type i=b[t]; i < b[t+1]; ++i) {
+                        if ((rac[i] >> shift) & 1) {
+                            tree[off+i] = 1;
+                        } else {
+                            ++cnt0;
+                        }
+                        if (boundary(i)) {
+                            if (first[t] == n) first[t] = i;
+                            last[t] = i;
+                        }
+                    }
+                    zeros[t+1] = cnt0;
+                });
+                for (uint32_t t=0; t < threads; ++t) {
+                    zeros[t+1] += zeros[t];
+                }
+                // (2) move the symbols to the next level, zeros before ones in each node
+                util::parallel_for(threads, [&](uint32_t t) {
+                    sigma[t] = 0;
+                    if (b[t] == b[t+1]) {
+                        return;
+                    }
+                    size_type s = b[t]; // start of the current node
+                    for (uint32_t u=t; first[t] != b[t] and u-- > 0;) {
+                        if (last[u] != n) {
+                            s = last[u];
+                            break;
+                        }
+                    }
+                    size_type next_start = n; // first node start after the chunk
+                    for (uint32_t u=t+1; u < threads and next_start == n; ++u) {
+                        next_start = first[u];
+                    }
+                    size_type z  = zeros[t];                      // zeros before i
+                    size_type zs = z - level_zeros(s, b[t]);       // zeros before s
+                    for (size_type i=b[t]; i < b[t+1];) {
+                        if (i > b[t]) {
+                            s  = i;
+                            zs = z;
+                        }
+                        size_type e = i+1; // end of the current node
+                        while (e < b[t+1] and !boundary(e)) {
+                            ++e;
+                        }
+                        size_type ze = z + level_zeros(i, e);      // zeros before e
+                        if (e == b[t+1]) {
+                            e  = next_start;
+                            ze = zeros[t+1] + level_zeros(b[t+1], e);
+                        }
+                        const size_type cnt0 = ze-zs;
+                        if (s >= b[t]) { // leaves are counted by the chunk of their start
+                            sigma[t] += (cnt0 > 0) + (e-s > cnt0);
+                        }
+                        for (const size_type end=std::min(e, b[t+1]); i < end; ++i) {
+                            bool bit = tree[off+i];
+                            if (k+1 < m_max_depth) {
+                                next[bit ? s+cnt0+(i-s)-(z-zs) : s+(z-zs)] = rac[i];
+                            }
+                            z += !bit;
+                        }
+                    }
+                });
+                if (k+1 < m_max_depth) {
+                    rac.swap(next);
+                }
+            }
+            m_sigma = 0;
+            for (uint32_t t=0; t < threads; ++t) {
+                m_sigma += sigma[t];
+            }
+        }
+
     public:
 
         const size_type&       sigma = m_sigma; //!< Effective alphabet size of the wavelet tree.
@@ -117,15 +232,18 @@ class wt_int
         /*! \param buf         File buffer of the int_vector for which the wt_int should be build.
          *  \param size        Size of the prefix of v, which should be indexed.
          *  \param max_depth   Maximal depth of the wavelet tree. If set to 0, determined automatically.
+         *  \param threads     Number of threads.
          *    \par Time complexity
          *        \f$ \Order{n\log|\Sigma|}\f$, where \f$n=size\f$
          *        I.e. we need \Order{n\log n} if rac is a permutation of 0..n-1.
          *    \par Space complexity
          *        \f$ n\log|\Sigma| + O(1)\f$ bits, where \f$n=size\f$.
+         *        For more than one thread the symbols are kept in two
+         *        arrays of 8, 16, 32 or 64 bit integers.
          */
         template<uint8_t int_width>
         wt_int(int_vector_buffer<int_width>& buf, size_type size,
-               uint32_t max_depth=0) : m_size(size) {
+               uint32_t max_depth=0, uint32_t threads=1) : m_size(size) {
             init_buffers(m_max_depth);
             if (0 == m_size)
                 return;
@@ -155,6 +273,27 @@ class wt_int
             }
             init_buffers(m_max_depth);
 
+            if (threads > 1) {
+                bit_vector tree;
+                uint32_t width = std::max((uint32_t)bits::hi(x)+1, m_max_depth);
+                if (width <= 8) {
+                    construct_levels<uint8_t>(rac, tree, threads);
+                } else if (width <= 16) {
+                    construct_levels<uint16_t>(rac, tree, threads);
+                } else if (width <= 32) {
+                    construct_levels<uint32_t>(rac, tree, threads);
+                } else {
+                    construct_levels<uint64_t>(rac, tree, threads);
+                }
+                m_tree = bit_vector_type(std::move(tree));
+                util::parallel_invoke(threads, {
+                    [&]() { util::init_support(m_tree_rank, &m_tree); },
+                    [&]() { util::init_support(m_tree_select0, &m_tree); },
+                    [&]() { util::init_support(m_tree_select1, &m_tree); }
+                });
+                return;
+            }
+
             std::string tree_out_buf_file_name = (dir+"/m_tree"+util::to_string(util::pid())+"_"+util::to_string(util::id()));
             osfstream tree_out_buf(tree_out_buf_file_name, std::ios::binary | std::ios::trunc | std::ios::out);   // open buffer for tree
             size_type bit_size = m_size*m_max_depth;
@@ -839,5 +978,13 @@ class wt_int
         }
 };
 
+template<class t_bitvector, class t_rank, class t_select, class t_select_zero, uint8_t t_width>
+void construct_wt(wt_int<t_bitvector, t_rank, t_select, t_select_zero>& wt,
+                  int_vector_buffer<t_width>& buf, int_vector_size_type size, uint32_t threads)
+{
+    wt_int<t_bitvector, t_rank, t_select, t_select_zero> tmp(buf, size, 0, threads);
+    wt.swap(tmp);
+}
+
 }// end namespace sdsl
 #endif
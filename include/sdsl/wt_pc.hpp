@@ -119,10 +119,126 @@ class wt_pc
             return bv_size;
         }
 
-        void construct_init_rank_select() {
-            util::init_support(m_bv_rank, &m_bv);
-            util::init_support(m_bv_select0, &m_bv);
-            util::init_support(m_bv_select1, &m_bv);
+        void construct_init_rank_select(uint32_t threads=1) {
+            util::parallel_invoke(threads, {
+                [&]() { util::init_support(m_bv_rank, &m_bv); },
+                [&]() { util::init_support(m_bv_select0, &m_bv); },
+                [&]() { util::init_support(m_bv_select1, &m_bv); }
+            });
+        }
+
+        // insert_char for the parallel construction: the words inside the
+        // node segments of a chunk belong to one thread, the first and the
+        // last word of the segment of node v may be shared with other
+        // threads and are collected in border[2v] and border[2v+1]
+        void insert_char(value_type old_chr, std::vector<uint64_t>& bv_node_pos,
+                         size_type times, bit_vector& bv,
+                         const std::vector<uint64_t>& seg_begin,
+                         const std::vector<uint64_t>& seg_end,
+                         std::vector<uint64_t>& border) {
+            uint64_t p = m_tree.bit_path(old_chr);
+            uint32_t path_len = p>>56;
+            node_type v = m_tree.root();
+            uint64_t* data = (uint64_t*)bv.data();
+            for (uint32_t l=0; l<path_len; ++l, p >>= 1) {
+                if (p&1) {
+                    for (uint64_t i=bv_node_pos[v], end=i+times; i < end;) {
+                        uint64_t w = i>>6, len = std::min(64-(i&63), end-i);
+                        uint64_t mask = bits::lo_set[len] << (i&63);
+                        if (w == (seg_begin[v]>>6)) {
+                            border[2*v] |= mask;
+                        } else if (w == ((seg_end[v]-1)>>6)) {
+                            border[2*v+1] |= mask;
+                        } else {
+                            data[w] |= mask;
+                        }
+                        i += len;
+                    }
+                }
+                bv_node_pos[v] += times;
+                v = m_tree.child(v, p&1);
+            }
+        }
+
+        // steps 1 to 4 of the constructor with threads threads; the text is
+        // split into one chunk per thread and each thread inserts its chunk
+        // starting at the node positions of the chunk
+        void construct_parallel(int_vector_buffer<t_tree_strat::int_width>& input_buf,
+                                bit_vector& bv, uint32_t threads) {
+            if (input_buf.size() < m_size) {
+                throw std::logic_error("Stream size is smaller than size!");
+            }
+            int_vector<t_tree_strat::int_width> text(m_size, 0, input_buf.width());
+            for (size_type i=0; i < m_size; ++i) {
+                text[i] = input_buf[i];
+            }
+            const size_type chunk = (m_size+threads-1)/threads;
+            // 1. Count occurrences of characters in each chunk
+            std::vector<std::vector<size_type>> cnt(threads);
+            util::parallel_for(threads, [&](uint32_t t) {
+                for (size_type i=t*chunk; i < std::min(m_size, (t+1)*chunk); ++i) {
+                    uint64_t c = text[i];
+                    if (c >= cnt[t].size()) { cnt[t].resize(c+1, 0); }
+                    ++cnt[t][c];
+                }
+            });
+            std::vector<size_type> C;
+            for (const auto& ct : cnt) {
+                C.resize(std::max(C.size(), ct.size()), 0);
+                for (size_type c=0; c < ct.size(); ++c) {
+                    C[c] += ct[c];
+                }
+            }
+            // 2. and 3. as in the sequential construction
+            calculate_effective_alphabet_size(C, m_sigma);
+            bv = bit_vector(construct_tree_shape(C), 0);
+            // node positions at the begin of each chunk
+            std::vector<std::vector<uint64_t>> pos(threads+1, std::vector<uint64_t>(m_tree.size()));
+            for (size_type v=0; v < m_tree.size(); ++v) {
+                pos[0][v] = m_tree.bv_pos(v);
+            }
+            for (uint32_t t=0; t < threads; ++t) {
+                pos[t+1] = pos[t];
+                for (size_type c=0; c < cnt[t].size(); ++c) {
+                    uint64_t p = m_tree.bit_path(c);
+                    node_type v = m_tree.root();
+                    for (uint32_t l=0, path_len=p>>56; cnt[t][c] and l < path_len; ++l, p >>= 1) {
+                        pos[t+1][v] += cnt[t][c];
+                        v = m_tree.child(v, p&1);
+                    }
+                }
+            }
+            // 4. Generate the bits of each chunk
+            std::vector<std::vector<uint64_t>> border(threads, std::vector<uint64_t>(2*m_tree.size(), 0));
+            util::parallel_for(threads, [&](uint32_t t) {
+                const size_type begin = std::min(m_size, t*chunk), end = std::min(m_size, (t+1)*chunk);
+                if (begin == end) {
+                    return;
+                }
+                std::vector<uint64_t> bv_node_pos = pos[t];
+                value_type old_chr = text[begin];
+                uint32_t times = 0;
+                for (size_type i=begin; i < end; ++i) {
+                    value_type chr = text[i];
+                    if (chr != old_chr or times == 64) {
+                        insert_char(old_chr, bv_node_pos, times, bv, pos[t], pos[t+1], border[t]);
+                        times = 0;
+                        old_chr = chr;
+                    }
+                    ++times;
+                }
+                insert_char(old_chr, bv_node_pos, times, bv, pos[t], pos[t+1], border[t]);
+            });
+            // set the border words after all threads finished
+            uint64_t* data = (uint64_t*)bv.data();
+            for (uint32_t t=0; t < threads; ++t) {
+                for (size_type v=0; v < m_tree.size(); ++v) {
+                    if (pos[t][v] < pos[t+1][v]) {
+                        data[pos[t][v]>>6] |= border[t][2*v];
+                        data[(pos[t+1][v]-1)>>6] |= border[t][2*v+1];
+                    }
+                }
+            }
         }
 
         // recursive internal version of the method interval_symbols
@@ -174,13 +290,23 @@ class wt_pc
         //! Construct the wavelet tree from a file_buffer
         /*! \param input_buf    File buffer of the input.
          *  \param size         The length of the prefix.
+         *  \param threads      Number of threads. For more than one thread
+         *                      the prefix is loaded into memory.
          *    \par Time complexity
          *        \f$ \Order{n\log|\Sigma|}\f$, where \f$n=size\f$
          */
         wt_pc(int_vector_buffer<t_tree_strat::int_width>& input_buf,
-              size_type size):m_size(size) {
+              size_type size, uint32_t threads=1):m_size(size) {
             if (0 == m_size)
                 return;
+            if (threads > 1) {
+                bit_vector temp_bv;
+                construct_parallel(input_buf, temp_bv, threads);
+                m_bv = bit_vector_type(std::move(temp_bv));
+                construct_init_rank_select(threads);
+                m_tree.init_node_ranks(m_bv_rank);
+                return;
+            }
             // O(n + |\Sigma|\log|\Sigma|) algorithm for calculating node sizes
             // TODO: C should also depend on the tree_strategy. C is just a mapping
             // from a symbol to its frequency. So a map<uint64_t,uint64_t> could be
@@ -545,6 +671,14 @@ class wt_pc
 
 };
 
+template<class t_shape, class t_bitvector, class t_rank, class t_select, class t_select_zero, class t_tree_strat>
+void construct_wt(wt_pc<t_shape, t_bitvector, t_rank, t_select, t_select_zero, t_tree_strat>& wt,
+                  int_vector_buffer<t_tree_strat::int_width>& buf, int_vector_size_type size, uint32_t threads)
+{
+    wt_pc<t_shape, t_bitvector, t_rank, t_select, t_select_zero, t_tree_strat> tmp(buf, size, threads);
+    wt.swap(tmp);
+}
+
 }
 
 #endif
@@ -25,6 +25,8 @@
 #include "sdsl_concepts.hpp"
 #include "int_vector.hpp"
 #include "sd_vector.hpp"// for standard initialisation of template parameters
+#include "bit_vectors.hpp"
+#include "rank_support.hpp"
 #include "util.hpp"
 #include "wt_huff.hpp"
 #include <algorithm> // for std::swap
@@ -38,6 +40,45 @@
 namespace sdsl
 {
 
+//! Indicates if a rank support answers predecessor queries.
+template<class t_rank>
+struct rank_support_has_predecessor_trait {
+    enum {value = false};
+};
+
+template<>
+struct rank_support_has_predecessor_trait<rank_support_v<1,1> > {
+    enum {value = true};
+};
+
+template<class t_hi_bit_vector, class t_select_1, class t_select_0>
+struct rank_support_has_predecessor_trait<rank_support_sd<t_hi_bit_vector, t_select_1, t_select_0> > {
+    enum {value = true};
+};
+
+template<uint16_t t_bs, class t_rac>
+struct rank_support_has_predecessor_trait<rank_support_rrr<1, t_bs, t_rac> > {
+    enum {value = true};
+};
+
+//! Calculates the position of the last set bit at or before position i,
+//! where r equals the number of set bits in [0..i].
+template<bool t_has_predecessor>
+struct predecessor_trait {
+    template<class t_rank, class t_select>
+    static uint64_t get(const t_rank&, const t_select& select, uint64_t, uint64_t r) {
+        return select(r);
+    }
+};
+
+template<>
+struct predecessor_trait<true> {
+    template<class t_rank, class t_select>
+    static uint64_t get(const t_rank& rank, const t_select&, uint64_t i, uint64_t) {
+        return rank.predecessor(i);
+    }
+};
+
 //! A Wavelet Tree class for byte sequences.
 /*!
  *    \par Space complexity
@@ -93,6 +134,12 @@ class wt_rlmn
         // the prefixes m_bf[0..m_C[0]],m_bf[0..m_C[1]],....,m_bf[0..m_C[255]];
         // named C_s in the original paper
 
+        // Start of the run which contains position i, where r equals the
+        // number of runs which start in [0..i]
+        size_type run_begin(size_type i, size_type r)const {
+            return predecessor_trait<rank_support_has_predecessor_trait<rank_support_type>::value>::get(m_bl_rank, m_bl_select, i, r);
+        }
+
         void copy(const wt_rlmn& wt) {
             m_size          = wt.m_size;
             m_bl            = wt.m_bl;
@@ -121,9 +168,11 @@ class wt_rlmn
         /*! \param text_buf  A int_vector_buffer to the original text.
          *  \param size      The length of the prefix of the text, for which
          *                   the wavelet tree should be build.
+         *  \param threads   Number of threads for the wavelet tree of the
+         *                   run heads and the rank and select supports.
          */
         // TODO: new signature: sdsl::file, size_type size
-        wt_rlmn(int_vector_buffer<8>& text_buf, size_type size):m_size(size) {
+        wt_rlmn(int_vector_buffer<8>& text_buf, size_type size, uint32_t threads=1):m_size(size) {
             std::string temp_file = text_buf.filename() +
                                     + "_wt_rlmn_" + util::to_string(util::pid())
                                     + "_" + util::to_string(util::id());
@@ -168,17 +217,19 @@ class wt_rlmn
                 }
                 {
                     int_vector_buffer<8> temp_bwt_buf(temp_file);
-                    m_wt = wt_type(temp_bwt_buf, temp_bwt_buf.size());
+                    construct_wt(m_wt, temp_bwt_buf, temp_bwt_buf.size(), threads);
                 }
                 sdsl::remove(temp_file);
                 m_bl = bit_vector_type(std::move(bl));
                 m_bf = bit_vector_type(std::move(bf));
             }
 
-            util::init_support(m_bl_rank, &m_bl);
-            util::init_support(m_bf_rank, &m_bf);
-            util::init_support(m_bf_select, &m_bf);
-            util::init_support(m_bl_select, &m_bl);
+            util::parallel_invoke(threads, {
+                [&]() { util::init_support(m_bl_rank, &m_bl); },
+                [&]() { util::init_support(m_bf_rank, &m_bf); },
+                [&]() { util::init_support(m_bf_select, &m_bf); },
+                [&]() { util::init_support(m_bl_select, &m_bl); }
+            });
             m_C_bf_rank = int_vector<64>(256,0);
             for (size_type i=0; i<256; ++i) {
                 m_C_bf_rank[i] = m_bf_rank(m_C[i]);
@@ -265,7 +316,7 @@ class wt_rlmn
             if (c_runs == 0)
                 return 0;
             if (m_wt[wt_ex_pos-1] == c) {
-                size_type c_run_begin = m_bl_select(wt_ex_pos);
+                size_type c_run_begin = run_begin(i-1, wt_ex_pos);
                 return m_bf_select(m_C_bf_rank[c]+c_runs)-m_C[c]+i-c_run_begin;
             } else {
                 return m_bf_select(m_C_bf_rank[c] + c_runs + 1) - m_C[c];
@@ -291,7 +342,7 @@ class wt_rlmn
             if (c_runs == 0)
                 return 0;
             if (m_wt[wt_ex_pos-1] == c) {
-                size_type c_run_begin = m_bl_select(wt_ex_pos);
+                size_type c_run_begin = run_begin(i, wt_ex_pos);
                 return m_bf_select(m_C_bf_rank[c]+c_runs)-m_C[c]+i-c_run_begin;
             } else {
                 return m_bf_select(m_C_bf_rank[c]+c_runs+1)-m_C[c];
@@ -349,5 +400,13 @@ class wt_rlmn
         }
 };
 
+template<class t_bitvector, class t_rank, class t_select, class t_wt>
+void construct_wt(wt_rlmn<t_bitvector, t_rank, t_select, t_wt>& wt,
+                  int_vector_buffer<8>& buf, int_vector_size_type size, uint32_t threads)
+{
+    wt_rlmn<t_bitvector, t_rank, t_select, t_wt> tmp(buf, size, threads);
+    wt.swap(tmp);
+}
+
 }// end namespace sdsl
 #endif
@@ -15,10 +15,475 @@
     along with this program.  If not, see http://www.gnu.org/licenses/ .
 */
 #include "sdsl/bits.hpp"
+#include <algorithm>
+#include <cstring>
+#ifdef SDSL_CPU_DISPATCH
+#include <immintrin.h>
+#endif
 
 namespace sdsl
 {
 
+namespace
+{
+
+uint64_t cnt_portable(const uint64_t* word, uint64_t n)
+{
+    uint64_t res = 0;
+    for (const uint64_t* end = word+n; word != end; ++word) {
+        res += bits::cnt(*word);
+    }
+    return res;
+}
+
+template<uint8_t t_op>
+inline uint64_t apply_op(uint64_t a, uint64_t b)
+{
+    switch (t_op) {
+        case bits::op_and: return a & b;
+        case bits::op_or:  return a | b;
+        case bits::op_xor: return a ^ b;
+        default:           return a & ~b;
+    }
+}
+
+// Packs the prefix counts of the words 1..7 of a 512-bit block, whose
+// first m words have cnt[0..m) set bits, as in rank_support_v.
+inline uint64_t pack_counts(const uint64_t* cnt, uint64_t m)
+{
+    uint64_t res = 0, sum = 0;
+    for (uint64_t t=1; t < 8; ++t) {
+        if (t <= m)
+            sum += cnt[t-1];
+        res |= sum << (63-9*t);
+    }
+    return res;
+}
+
+// Writes the entry after the last block, if the last block is full
+inline void finish_counts(uint64_t n, uint64_t total, uint64_t* counts)
+{
+    if (counts != nullptr and !(n&7)) {
+        counts[n>>2]     = total;
+        counts[(n>>2)+1] = 0;
+    }
+}
+
+template<uint8_t t_op>
+uint64_t combine_portable_op(uint64_t* a, const uint64_t* b, uint64_t n, uint64_t* counts)
+{
+    uint64_t total = 0, cnt[8];
+    for (uint64_t i=0; i < n; i += 8) {
+        uint64_t m = std::min((uint64_t)8, n-i), sum = 0;
+        for (uint64_t t=0; t < m; ++t) {
+            a[i+t] = apply_op<t_op>(a[i+t], b[i+t]);
+            sum += (cnt[t] = bits::cnt(a[i+t]));
+        }
+        if (counts != nullptr) {
+            counts[i>>2]     = total;
+            counts[(i>>2)+1] = pack_counts(cnt, m);
+        }
+        total += sum;
+    }
+    finish_counts(n, total, counts);
+    return total;
+}
+
+uint64_t combine_portable(bits::bit_op op, uint64_t* a, const uint64_t* b, uint64_t n, uint64_t* counts)
+{
+    switch (op) {
+        case bits::op_and: return combine_portable_op<bits::op_and>(a, b, n, counts);
+        case bits::op_or:  return combine_portable_op<bits::op_or>(a, b, n, counts);
+        case bits::op_xor: return combine_portable_op<bits::op_xor>(a, b, n, counts);
+        default:           return combine_portable_op<bits::op_andnot>(a, b, n, counts);
+    }
+}
+
+// Reads each value by one unaligned 64-bit load, as long as the load
+// stays inside the words which contain the n values.
+template<uint8_t t_len>
+void read_ints_len(const uint64_t* word, uint8_t offset, uint64_t n, uint64_t* out)
+{
+    uint64_t i = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (t_len <= 57) {
+        const uint8_t* base = (const uint8_t*)word;
+        const uint64_t end  = ((offset+n*t_len+63)>>6)<<3;
+        uint64_t p = offset;
+        for (; i < n and (p>>3)+8 <= end; ++i, p += t_len) {
+            uint64_t x;
+            memcpy(&x, base+(p>>3), 8);
+            out[i] = (x >> (p&7)) & bits::lo_set[t_len];
+        }
+        word  += p>>6;
+        offset = p&0x3F;
+    }
+#endif
+    for (; i < n; ++i) {
+        out[i] = bits::read_int_and_move(word, offset, t_len);
+    }
+}
+
+// Collects the values in a register and writes each word once.
+template<uint8_t t_len>
+void write_ints_len(uint64_t* word, uint8_t offset, uint64_t n, const uint64_t* in)
+{
+    if (n == 0)
+        return;
+    uint64_t cur = *word & bits::lo_set[offset];
+    uint32_t off = offset;
+    for (uint64_t i=0; i < n; ++i) {
+        uint64_t x = in[i] & bits::lo_set[t_len];
+        cur |= x << off;
+        if ((off += t_len) >= 64) {
+            *word++ = cur;
+            off -= 64;
+            cur = off ? x >> (t_len-off) : 0;
+        }
+    }
+    if (off) {
+        *word = cur | (*word & ~bits::lo_set[off]);
+    }
+}
+
+struct int_kernels {
+    void (*read[65])(const uint64_t*, uint8_t, uint64_t, uint64_t*);
+    void (*write[65])(uint64_t*, uint8_t, uint64_t, const uint64_t*);
+    int_kernels();
+};
+
+template<uint8_t t_len>
+struct int_kernels_fill {
+    static void fill(int_kernels& k) {
+        k.read[t_len]  = read_ints_len<t_len>;
+        k.write[t_len] = write_ints_len<t_len>;
+        int_kernels_fill<t_len-1>::fill(k);
+    }
+};
+
+template<>
+struct int_kernels_fill<0> {
+    static void fill(int_kernels& k) {
+        k.read[0]  = read_ints_len<0>;
+        k.write[0] = write_ints_len<0>;
+    }
+};
+
+int_kernels::int_kernels()
+{
+    int_kernels_fill<64>::fill(*this);
+}
+
+// The kernels of all widths, indexed by the width
+const int_kernels& int_kernel_table()
+{
+    static const int_kernels k;
+    return k;
+}
+
+void read_ints_portable(const uint64_t* word, uint8_t offset, uint8_t len, uint64_t n, uint64_t* out)
+{
+    int_kernel_table().read[len](word, offset, n, out);
+}
+
+#ifdef SDSL_CPU_DISPATCH
+
+// Eight consecutive values occupy exactly len bytes. Hence the byte
+// offsets and shifts of the values relative to the first byte of
+// their group repeat and the groups are read by gathers.
+// Returns the number of values which are read.
+inline uint64_t read_ints_setup(uint8_t offset, uint8_t len, uint64_t n,
+                                int64_t* idx, int64_t* shift, uint64_t& groups)
+{
+    if (len > 57 or n < 8) {
+        groups = 0;
+        return 0;
+    }
+    for (uint64_t j=0; j < 8; ++j) {
+        uint64_t p = offset + j*len;
+        idx[j]   = p>>3;
+        shift[j] = p&7;
+    }
+    // the load of the last value of a group must not pass the last word
+    const uint64_t end = ((offset+n*len+63)>>6)<<3;
+    groups = n>>3;
+    while (groups > 0 and (groups-1)*len + idx[7] + 8 > end)
+        --groups;
+    return groups<<3;
+}
+
+__attribute__((target("avx2")))
+void read_ints_avx2(const uint64_t* word, uint8_t offset, uint8_t len, uint64_t n, uint64_t* out)
+{
+    int64_t idx[8], shift[8];
+    uint64_t groups;
+    uint64_t i = read_ints_setup(offset, len, n, idx, shift, groups);
+    if (groups > 0) {
+        const uint8_t* base = (const uint8_t*)word;
+        const __m256i idx0 = _mm256_loadu_si256((const __m256i*)idx);
+        const __m256i idx1 = _mm256_loadu_si256((const __m256i*)(idx+4));
+        const __m256i sh0  = _mm256_loadu_si256((const __m256i*)shift);
+        const __m256i sh1  = _mm256_loadu_si256((const __m256i*)(shift+4));
+        const __m256i mask = _mm256_set1_epi64x(bits::lo_set[len]);
+        for (uint64_t g=0; g < groups; ++g, base += len) {
+            __m256i x = _mm256_i64gather_epi64((const long long*)base, idx0, 1);
+            __m256i y = _mm256_i64gather_epi64((const long long*)base, idx1, 1);
+            x = _mm256_and_si256(_mm256_srlv_epi64(x, sh0), mask);
+            y = _mm256_and_si256(_mm256_srlv_epi64(y, sh1), mask);
+            _mm256_storeu_si256((__m256i*)(out+(g<<3)), x);
+            _mm256_storeu_si256((__m256i*)(out+(g<<3)+4), y);
+        }
+    }
+    uint64_t p = offset + i*len;
+    read_ints_portable(word+(p>>6), p&0x3F, len, n-i, out+i);
+}
+
+__attribute__((target("avx512f")))
+void read_ints_avx512(const uint64_t* word, uint8_t offset, uint8_t len, uint64_t n, uint64_t* out)
+{
+    int64_t idx[8], shift[8];
+    uint64_t groups;
+    uint64_t i = read_ints_setup(offset, len, n, idx, shift, groups);
+    if (groups > 0) {
+        const uint8_t* base = (const uint8_t*)word;
+        const __m512i vidx = _mm512_loadu_si512((const void*)idx);
+        const __m512i sh   = _mm512_loadu_si512((const void*)shift);
+        const __m512i mask = _mm512_set1_epi64(bits::lo_set[len]);
+        const __m512i zero = _mm512_setzero_si512();
+        for (uint64_t g=0; g < groups; ++g, base += len) {
+            __m512i x = _mm512_mask_i64gather_epi64(zero, 0xFF, vidx, (const void*)base, 1);
+            x = _mm512_and_si512(_mm512_maskz_srlv_epi64(0xFF, x, sh), mask);
+            _mm512_storeu_si512((void*)(out+(g<<3)), x);
+        }
+    }
+    uint64_t p = offset + i*len;
+    read_ints_portable(word+(p>>6), p&0x3F, len, n-i, out+i);
+}
+
+__attribute__((target("popcnt")))
+uint64_t cnt_popcnt(const uint64_t* word, uint64_t n)
+{
+    // four independent sums to hide the latency of popcnt
+    uint64_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
+    const uint64_t* end = word + (n&~3ULL);
+    for (; word != end; word += 4) {
+        r0 += __builtin_popcountll(word[0]);
+        r1 += __builtin_popcountll(word[1]);
+        r2 += __builtin_popcountll(word[2]);
+        r3 += __builtin_popcountll(word[3]);
+    }
+    for (end = word + (n&3ULL); word != end; ++word) {
+        r0 += __builtin_popcountll(*word);
+    }
+    return r0 + r1 + r2 + r3;
+}
+
+__attribute__((target("popcnt,avx512f,avx512vpopcntdq")))
+uint64_t cnt_avx512(const uint64_t* word, uint64_t n)
+{
+    __m512i sum = _mm512_setzero_si512();
+    const uint64_t* end = word + (n&~7ULL);
+    for (; word != end; word += 8) {
+        __m512i x = _mm512_loadu_si512((const void*)word);
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(x));
+    }
+    uint64_t lanes[8];
+    _mm512_storeu_si512((void*)lanes, sum);
+    uint64_t res = 0;
+    for (size_t j=0; j < 8; ++j) {
+        res += lanes[j];
+    }
+    for (end = word + (n&7ULL); word != end; ++word) {
+        res += __builtin_popcountll(*word);
+    }
+    return res;
+}
+
+template<uint8_t t_op>
+__attribute__((target("popcnt,avx2")))
+uint64_t combine_avx2_op(uint64_t* a, const uint64_t* b, uint64_t n, uint64_t* counts)
+{
+    uint64_t total = 0, cnt[8];
+    for (uint64_t i=0; i < n; i += 8) {
+        uint64_t m = std::min((uint64_t)8, n-i), sum = 0;
+        if (m == 8) {
+            for (uint64_t t=0; t < 8; t += 4) {
+                __m256i x = _mm256_loadu_si256((const __m256i*)(a+i+t));
+                __m256i y = _mm256_loadu_si256((const __m256i*)(b+i+t));
+                switch (t_op) {
+                    case bits::op_and: x = _mm256_and_si256(x, y); break;
+                    case bits::op_or:  x = _mm256_or_si256(x, y); break;
+                    case bits::op_xor: x = _mm256_xor_si256(x, y); break;
+                    default:           x = _mm256_andnot_si256(y, x);
+                }
+                _mm256_storeu_si256((__m256i*)(a+i+t), x);
+            }
+        } else {
+            for (uint64_t t=0; t < m; ++t)
+                a[i+t] = apply_op<t_op>(a[i+t], b[i+t]);
+        }
+        for (uint64_t t=0; t < m; ++t)
+            sum += (cnt[t] = __builtin_popcountll(a[i+t]));
+        if (counts != nullptr) {
+            counts[i>>2]     = total;
+            counts[(i>>2)+1] = pack_counts(cnt, m);
+        }
+        total += sum;
+    }
+    finish_counts(n, total, counts);
+    return total;
+}
+
+uint64_t combine_avx2(bits::bit_op op, uint64_t* a, const uint64_t* b, uint64_t n, uint64_t* counts)
+{
+    switch (op) {
+        case bits::op_and: return combine_avx2_op<bits::op_and>(a, b, n, counts);
+        case bits::op_or:  return combine_avx2_op<bits::op_or>(a, b, n, counts);
+        case bits::op_xor: return combine_avx2_op<bits::op_xor>(a, b, n, counts);
+        default:           return combine_avx2_op<bits::op_andnot>(a, b, n, counts);
+    }
+}
+
+// One 512-bit block of the operands fits exactly in one register. The
+// per-word counts of vpopcntq give the prefix counts of the block.
+template<uint8_t t_op>
+__attribute__((target("popcnt,avx512f,avx512vpopcntdq")))
+uint64_t combine_avx512_op(uint64_t* a, const uint64_t* b, uint64_t n, uint64_t* counts)
+{
+    uint64_t total = 0, cnt[8];
+    __m512i sum = _mm512_setzero_si512();
+    for (uint64_t i=0; i < n; i += 8) {
+        uint64_t m = std::min((uint64_t)8, n-i);
+        __mmask8 k = (__mmask8)((1U << m) - 1);
+        __m512i x = _mm512_maskz_loadu_epi64(k, a+i);
+        __m512i y = _mm512_maskz_loadu_epi64(k, b+i);
+        switch (t_op) {
+            case bits::op_and: x = _mm512_and_si512(x, y); break;
+            case bits::op_or:  x = _mm512_or_si512(x, y); break;
+            case bits::op_xor: x = _mm512_xor_si512(x, y); break;
+            default:           x = _mm512_and_si512(x, _mm512_xor_si512(y, _mm512_set1_epi64(-1)));
+        }
+        _mm512_mask_storeu_epi64(a+i, k, x);
+        __m512i c = _mm512_popcnt_epi64(x);
+        if (counts != nullptr) {
+            _mm512_storeu_si512((void*)cnt, c);
+            counts[i>>2]     = total;
+            counts[(i>>2)+1] = pack_counts(cnt, m);
+            for (uint64_t t=0; t < m; ++t)
+                total += cnt[t];
+        } else {
+            sum = _mm512_add_epi64(sum, c);
+        }
+    }
+    if (counts == nullptr) {
+        _mm512_storeu_si512((void*)cnt, sum);
+        for (uint64_t t=0; t < 8; ++t)
+            total += cnt[t];
+    }
+    finish_counts(n, total, counts);
+    return total;
+}
+
+uint64_t combine_avx512(bits::bit_op op, uint64_t* a, const uint64_t* b, uint64_t n, uint64_t* counts)
+{
+    switch (op) {
+        case bits::op_and: return combine_avx512_op<bits::op_and>(a, b, n, counts);
+        case bits::op_or:  return combine_avx512_op<bits::op_or>(a, b, n, counts);
+        case bits::op_xor: return combine_avx512_op<bits::op_xor>(a, b, n, counts);
+        default:           return combine_avx512_op<bits::op_andnot>(a, b, n, counts);
+    }
+}
+
+bits::cpu_features detect_cpu_features()
+{
+    bits::cpu_features f;
+    __builtin_cpu_init();
+    f.popcnt = __builtin_cpu_supports("popcnt");
+    // pdep is microcoded and very slow on AMD CPUs before Zen 3
+    f.bmi2   = __builtin_cpu_supports("bmi2") and
+               !__builtin_cpu_is("amdfam15h") and !__builtin_cpu_is("amdfam17h");
+    f.avx2   = __builtin_cpu_supports("avx2") and __builtin_cpu_supports("popcnt");
+    f.avx512f = __builtin_cpu_supports("avx512f");
+    f.avx512_popcnt = __builtin_cpu_supports("avx512f") and
+                      __builtin_cpu_supports("avx512vpopcntdq");
+    return f;
+}
+
+#else
+
+bits::cpu_features detect_cpu_features()
+{
+    return bits::cpu_features();
+}
+
+#endif
+
+} // end anonymous namespace
+
+const bits::cpu_features bits::cpu = detect_cpu_features();
+
+// constant initialized, so the portable kernels are used by calls which
+// happen before the dynamic initialization of this translation unit
+std::atomic<bits::cnt_kernel_type> bits::cnt_kernel{cnt_portable};
+
+std::atomic<bits::combine_kernel_type> bits::combine_kernel{combine_portable};
+
+std::atomic<bits::read_ints_kernel_type> bits::read_ints_kernel{read_ints_portable};
+
+std::atomic<bits::sel_kernel_type> bits::sel_kernel{bits::sel_portable};
+
+void bits::write_ints(uint64_t* word, uint8_t offset, uint8_t len, uint64_t n, const uint64_t* in)
+{
+    int_kernel_table().write[len](word, offset, n, in);
+}
+
+namespace
+{
+// Replaces the portable kernels by the best ones for bits::cpu. Runs once
+// during the static initialization of the library, i.e. before any thread
+// of the program is started.
+bool resolve_kernels()
+{
+#ifdef SDSL_CPU_DISPATCH
+    const bits::cpu_features& f = bits::cpu;
+    if (f.avx512_popcnt) {
+        bits::cnt_kernel.store(cnt_avx512, std::memory_order_relaxed);
+    } else if (f.popcnt) {
+        bits::cnt_kernel.store(cnt_popcnt, std::memory_order_relaxed);
+    }
+    if (f.avx512_popcnt) {
+        bits::combine_kernel.store(combine_avx512, std::memory_order_relaxed);
+    } else if (f.avx2) {
+        bits::combine_kernel.store(combine_avx2, std::memory_order_relaxed);
+    }
+    if (f.avx512f) {
+        bits::read_ints_kernel.store(read_ints_avx512, std::memory_order_relaxed);
+    } else if (f.avx2) {
+        bits::read_ints_kernel.store(read_ints_avx2, std::memory_order_relaxed);
+    }
+    if (f.bmi2) {
+        bits::sel_kernel.store(bits::sel_bmi2, std::memory_order_relaxed);
+    }
+#endif
+    return true;
+}
+
+const bool kernels_resolved __attribute__((unused)) = resolve_kernels();
+}
+
+#ifdef SDSL_CPU_DISPATCH
+__attribute__((target("bmi,bmi2")))
+uint32_t bits::sel_bmi2(uint64_t x, uint32_t i)
+{
+    return __builtin_ctzll(_pdep_u64(1ULL<<(i-1), x));
+}
+#else
+uint32_t bits::sel_bmi2(uint64_t x, uint32_t i)
+{
+    return _sel(x, i);
+}
+#endif
+
 const uint8_t bits::lt_cnt[] = {
     0, 1, 1, 2, 1, 2, 2, 3,
     1, 2, 2, 3, 2, 3, 3, 4,
@@ -0,0 +1,193 @@
+#include "sdsl/block_compression.hpp"
+#include "sdsl/bits.hpp"
+#include "sdsl/io.hpp"
+
+#include <algorithm>
+
+namespace sdsl
+{
+namespace block_compression
+{
+
+namespace
+{
+
+enum codec : uint64_t {
+    frame_of_reference = 0,
+    delta              = 1,
+    runs               = 2
+};
+
+inline uint8_t bit_width(uint64_t x)
+{
+    return x ? bits::hi(x)+1 : 0;
+}
+
+inline uint64_t zigzag(uint64_t d)
+{
+    return (d<<1) ^ (uint64_t)(((int64_t)d)>>63);
+}
+
+inline uint64_t unzigzag(uint64_t z)
+{
+    return (z>>1) ^ (0-(z&1));
+}
+
+// writes n values of width w starting at word 2 of out
+void pack(std::vector<uint64_t>& out, uint8_t w, uint64_t n, const uint64_t* in)
+{
+    out.resize(2+(n*w+63)/64, 0);
+    if (w and n) {
+        bits::write_ints(out.data()+2, 0, w, n, in);
+    }
+}
+
+void unpack(const uint64_t* in, uint8_t w, uint64_t n, uint64_t* out)
+{
+    if (w) {
+        bits::read_ints(in, 0, w, n, out);
+    } else {
+        std::fill(out, out+n, 0);
+    }
+}
+
+} // end anonymous namespace
+
+void write_header(std::ostream& out, const header& h)
+{
+    write_member(MAGIC, out);
+    write_member(h.width, out);
+    write_member(h.size, out);
+    write_member(h.block_size, out);
+    write_member(h.index_offset, out);
+}
+
+bool read_header(std::istream& in, header& h)
+{
+    uint64_t magic = 0;
+    read_member(magic, in);
+    if (magic != MAGIC) {
+        return false;
+    }
+    read_member(h.width, in);
+    read_member(h.size, in);
+    read_member(h.block_size, in);
+    read_member(h.index_offset, in);
+    return (bool)in;
+}
+
+void read_index(std::istream& in, std::streampos begin, const header& h, index_type& index)
+{
+    index.resize(blocks(h));
+    in.seekg(begin + (std::streamoff)h.index_offset);
+    in.read((char*)index.data(), index.size()*sizeof(index[0]));
+}
+
+void write_index(std::ostream& out, const index_type& index)
+{
+    out.write((const char*)index.data(), index.size()*sizeof(index[0]));
+}
+
+void encode(const uint64_t* in, uint64_t n, std::vector<uint64_t>& out)
+{
+    out.assign(2, 0);
+    if (n == 0) {
+        return;
+    }
+    // one pass determines the size of all codecs
+    uint64_t mn = in[0], mx = in[0], zz = 0, run_lens = 0, run = 0, r = 1;
+    for (uint64_t i=1; i < n; ++i) {
+        mn = std::min(mn, in[i]);
+        mx = std::max(mx, in[i]);
+        zz |= zigzag(in[i]-in[i-1]);
+        if (in[i] == in[i-1]) {
+            ++run;
+        } else {
+            run_lens |= run;
+            run = 0;
+            ++r;
+        }
+    }
+    run_lens |= run;
+    uint8_t w_for = bit_width(mx-mn), w_delta = bit_width(zz), w_run = bit_width(run_lens);
+    uint64_t bits_for = n*w_for, bits_delta = (n-1)*w_delta, bits_runs = r*(w_for+w_run);
+
+    std::vector<uint64_t> tmp(n);
+    if (bits_runs < bits_for and bits_runs < bits_delta) {
+        out[0] = runs | ((uint64_t)w_for<<2) | ((uint64_t)w_run<<9) | (n<<16);
+        out[1] = mn;
+        tmp.resize(2*r);
+        uint64_t k = 0;
+        for (uint64_t i=0; i < n; ++k) {
+            uint64_t j = i+1;
+            while (j < n and in[j] == in[i]) {
+                ++j;
+            }
+            tmp[k] = in[i]-mn;
+            tmp[r+k] = j-i-1;
+            i = j;
+        }
+        out.resize(2+(bits_runs+63)/64, 0);
+        uint64_t* word = out.data()+2;
+        uint8_t offset = 0;
+        for (k=0; k < r; ++k) {
+            bits::write_int_and_move(word, tmp[k], offset, w_for);
+            bits::write_int_and_move(word, tmp[r+k], offset, w_run);
+        }
+    } else if (bits_delta < bits_for) {
+        out[0] = delta | ((uint64_t)w_delta<<2) | (n<<16);
+        out[1] = in[0];
+        for (uint64_t i=1; i < n; ++i) {
+            tmp[i-1] = zigzag(in[i]-in[i-1]);
+        }
+        pack(out, w_delta, n-1, tmp.data());
+    } else {
+        out[0] = frame_of_reference | ((uint64_t)w_for<<2) | (n<<16);
+        out[1] = mn;
+        for (uint64_t i=0; i < n; ++i) {
+            tmp[i] = in[i]-mn;
+        }
+        pack(out, w_for, n, tmp.data());
+    }
+}
+
+uint64_t decode(const uint64_t* in, uint64_t* out)
+{
+    uint64_t n = in[0]>>16;
+    if (n == 0) {
+        return 0;
+    }
+    uint8_t w = (in[0]>>2)&0x7F;
+    uint64_t base = in[1];
+    switch (in[0]&3) {
+        case frame_of_reference:
+            unpack(in+2, w, n, out);
+            for (uint64_t i=0; i < n; ++i) {
+                out[i] += base;
+            }
+            break;
+        case delta:
+            unpack(in+2, w, n-1, out+1);
+            out[0] = base;
+            for (uint64_t i=1; i < n; ++i) {
+                out[i] = out[i-1] + unzigzag(out[i]);
+            }
+            break;
+        case runs: {
+                uint8_t w_run = (in[0]>>9)&0x7F;
+                const uint64_t* word = in+2;
+                uint8_t offset = 0;
+                for (uint64_t* p = out; p < out+n;) {
+                    uint64_t x = base + bits::read_int_and_move(word, offset, w);
+                    uint64_t len = bits::read_int_and_move(word, offset, w_run)+1;
+                    std::fill(p, p+len, x);
+                    p += len;
+                }
+            }
+            break;
+    }
+    return n;
+}
+
+} // end namespace block_compression
+} // end namespace sdsl
@@ -2,7 +2,7 @@
 #include "sdsl/util.hpp"
 
 namespace sdsl{
-	cache_config::cache_config(bool f_delete_files, std::string f_dir, std::string f_id, tMSS f_file_map) : delete_files(f_delete_files), dir(f_dir), id(f_id), file_map(f_file_map) { 
+	cache_config::cache_config(bool f_delete_files, std::string f_dir, std::string f_id, tMSS f_file_map, bool f_compress_files, uint64_t f_memory_limit, uint32_t f_threads, bool f_parallel_sa) : delete_files(f_delete_files), dir(f_dir), id(f_id), file_map(f_file_map), compress_files(f_compress_files), memory_limit(f_memory_limit), threads(f_threads), parallel_sa(f_parallel_sa) { 
 		if ( "" == id ){
 			id = util::to_string(util::pid())+"_"+util::to_string(util::id());
 		}
@@ -0,0 +1,146 @@
+#include "sdsl/construct_budget.hpp"
+#include "sdsl/bits.hpp"
+#include "sdsl/parallel_sufsort.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace sdsl
+{
+
+namespace
+{
+// bytes of an int_vector of n integers of width w
+inline uint64_t vector_bytes(uint64_t n, uint8_t w)
+{
+    return ((n*w+63)>>6)<<3;
+}
+
+// width of the suffix array of a text of length n
+inline uint8_t sa_width(uint64_t n)
+{
+    return bits::hi(n)+1;
+}
+}
+
+uint64_t construct_buffer_size(const cache_config& config, uint64_t default_size,
+                               uint64_t resident, uint64_t buffers)
+{
+    if (config.memory_limit == 0) {
+        return default_size;
+    }
+    const uint64_t min_size = 1ULL<<12, max_size = 1ULL<<26;
+    uint64_t available = config.memory_limit > resident ? config.memory_limit - resident : 0;
+    uint64_t size = available / (3*std::max(buffers, (uint64_t)1));
+    return std::min(std::max(size, min_size), max_size) & ~7ULL;
+}
+
+uint64_t sa_peak_memory(uint64_t n, uint8_t text_width)
+{
+    if (text_width == 8) { // divsufsort works on 32 or 64 bit integers
+        return n + n*(n < 0x7FFFFFFFULL ? 4 : 8);
+    }
+    // SA-IS keeps the text, the SA as 32 or 64 bit integers, the suffix
+    // types and two bucket arrays of at most min(n, 2^text_width) entries
+    uint64_t idx_bytes = n < 0xFFFFFFFFULL ? 4 : 8;
+    uint64_t sigma = text_width < 64 ? std::min(n, (uint64_t)1<<text_width) : n;
+    return vector_bytes(n, text_width) + idx_bytes*(n+2*sigma) + vector_bytes(n, 1);
+}
+
+uint64_t parallel_sa_peak_memory(uint64_t n, uint8_t text_width)
+{
+    // the memory of SA-IS, n bits for the L-parts of the buckets and the
+    // two blocks and the per thread counters of the induced sorting
+    uint64_t idx_bytes = n < 0xFFFFFFFFULL ? 4 : 8;
+    uint64_t sigma = text_width < 64 ? std::min(n, (uint64_t)1<<text_width) : n;
+    return vector_bytes(n, text_width) + idx_bytes*(n+2*sigma) + 2*vector_bytes(n, 1)
+           + idx_bytes*(9*parallel_sufsort::BLOCK_SIZE/4);
+}
+
+uint64_t bwt_peak_memory(uint64_t n, uint8_t text_width)
+{
+    return vector_bytes(n, text_width);
+}
+
+uint64_t blockwise_bwt_peak_memory(uint64_t n, uint8_t text_width, uint64_t block_size)
+{
+    const uint64_t b = std::min(n, block_size);
+    // (1) the wavelet tree of the BWT of the tail during its construction,
+    //     the block and the counts of the smaller suffixes of the tail
+    uint64_t search = 2*vector_bytes(n, text_width) + vector_bytes(b, text_width) + vector_bytes(b, sa_width(n));
+    // (2) SA-IS of the recoded block on 32 or 64 bit integers
+    uint64_t idx_bytes = b+2 < 0xFFFFFFFFULL ? 4 : 8;
+    uint64_t sigma = text_width < 62 ? std::min(b+2, (uint64_t)3<<text_width) : b+2;
+    uint64_t sort = vector_bytes(b, text_width) + vector_bytes(b, sa_width(n)) + vector_bytes(b+2, text_width+2)
+                    + idx_bytes*(b+2+2*sigma) + vector_bytes(b+2, 1);
+    return std::max(search, sort);
+}
+
+uint64_t blockwise_bwt_block_size(const cache_config& config, uint64_t n, uint8_t text_width)
+{
+    if (config.memory_limit == 0) {
+        return std::max(n, (uint64_t)1);
+    }
+    uint64_t lb = std::min(n, (uint64_t)1<<16), rb = n;
+    while (lb < rb) {
+        uint64_t mid = rb - (rb-lb)/2;
+        if (blockwise_bwt_peak_memory(n, text_width, mid) <= config.memory_limit) {
+            lb = mid;
+        } else {
+            rb = mid-1;
+        }
+    }
+    return std::max(lb, (uint64_t)1);
+}
+
+uint64_t csa_peak_memory(uint64_t n, uint8_t text_width)
+{
+    return vector_bytes(n, text_width) + vector_bytes(n, sa_width(n));
+}
+
+uint64_t lcp_peak_memory(lcp_byte_algorithm alg, uint64_t n)
+{
+    switch (alg) {
+        case LCP_PHI:
+            return n + vector_bytes(n, sa_width(n));
+        case LCP_SEMI_EXTERN_PHI:
+            return n + vector_bytes((n+63)/64, 64);
+    }
+    return 0;
+}
+
+uint64_t lcp_peak_memory(uint64_t n, uint8_t text_width)
+{
+    return vector_bytes(n, text_width) + vector_bytes(n, sa_width(n));
+}
+
+uint64_t parallel_lcp_peak_memory(uint64_t n, uint8_t text_width)
+{
+    // PLCP of 32 or 64 bit integers
+    uint64_t idx_bytes = n < 0xFFFFFFFFULL ? 4 : 8;
+    return vector_bytes(n, text_width) + idx_bytes*n;
+}
+
+lcp_byte_algorithm select_lcp_algorithm(const cache_config& config, uint64_t n)
+{
+    if (config.memory_limit == 0) {
+        return LCP_SEMI_EXTERN_PHI;
+    }
+    if (lcp_peak_memory(LCP_PHI, n) <= config.memory_limit) {
+        return LCP_PHI;
+    }
+    check_memory_limit(config, lcp_peak_memory(LCP_SEMI_EXTERN_PHI, n), "lcp");
+    return LCP_SEMI_EXTERN_PHI;
+}
+
+bool check_memory_limit(const cache_config& config, uint64_t peak, const char* step)
+{
+    if (config.memory_limit == 0 or peak <= config.memory_limit) {
+        return true;
+    }
+    std::cerr << "WARNING: construct: the " << step << " construction needs about " << peak
+              << " bytes, which exceeds the memory limit of " << config.memory_limit << " bytes" << std::endl;
+    return false;
+}
+
+} // end namespace sdsl
@@ -0,0 +1,197 @@
+#include "sdsl/construct_graph.hpp"
+#include "sdsl/construct_profile.hpp"
+#include "sdsl/io.hpp"
+#include "sdsl/memory_management.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace sdsl
+{
+
+void construct_graph::add(const std::string& name, const std::vector<std::string>& inputs,
+                          const std::vector<std::string>& outputs, memory_type memory, function_type function)
+{
+    m_stages.push_back(stage{name, inputs, outputs, memory, function});
+}
+
+void construct_graph::run()
+{
+    const size_t n = m_stages.size();
+    auto registered = [&](const std::string& key) {
+        return m_config.file_map.find(key) != m_config.file_map.end();
+    };
+    // cached stages do not wait for their inputs
+    auto ready = [&](const stage& s) {
+        for (const std::string& key : s.inputs) {
+            if (!registered(key)) {
+                return false;
+            }
+        }
+        return true;
+    };
+    // (1) find the cached stages and the stages which are needed
+    std::vector<bool> cached(n, false), needed(n, false);
+    std::vector<size_t> todo;
+    for (size_t i=0; i < n; ++i) {
+        const stage& s = m_stages[i];
+        cached[i] = !s.outputs.empty();
+        for (size_t k=0; k < s.outputs.size() and cached[i]; ++k) {
+            cached[i] = cache_file_exists(s.outputs[k], m_config);
+        }
+        if (s.outputs.empty()) {
+            needed[i] = true;
+            todo.push_back(i);
+        }
+    }
+    while (!todo.empty()) {
+        size_t i = todo.back();
+        todo.pop_back();
+        if (cached[i]) {
+            continue;
+        }
+        for (const std::string& key : m_stages[i].inputs) {
+            for (size_t j=0; j < n and !registered(key); ++j) {
+                const std::vector<std::string>& out = m_stages[j].outputs;
+                if (!needed[j] and std::find(out.begin(), out.end(), key) != out.end()) {
+                    needed[j] = true;
+                    todo.push_back(j);
+                }
+            }
+        }
+    }
+    std::vector<bool> started(n, false);
+    std::vector<uint64_t> memory(n, 0);
+    size_t finished = 0;
+    for (size_t i=0; i < n; ++i) {
+        started[i] = !needed[i];
+        finished += !needed[i];
+    }
+    auto register_outputs = [&](const stage& s, cache_config& config) {
+        for (const std::string& key : s.outputs) {
+            register_cache_file(key, config);
+        }
+    };
+    auto stuck = [&]() {
+        std::string names;
+        for (size_t i=0; i < n; ++i) {
+            if (!started[i]) {
+                names += " " + m_stages[i].name;
+            }
+        }
+        throw std::logic_error("construct_graph: missing inputs of the stages" + names);
+    };
+
+    // (2) run the stages one after another
+    if (m_config.threads <= 1) {
+        while (finished < n) {
+            size_t i = 0;
+            while (i < n and (started[i] or !(cached[i] or ready(m_stages[i])))) {
+                ++i;
+            }
+            if (i == n) {
+                stuck();
+            }
+            started[i] = true;
+            const stage& s = m_stages[i];
+            {
+                construct_profile::phase phase(s.name);
+                if (!cached[i]) {
+                    s.function(m_config);
+                }
+                register_outputs(s, m_config);
+            }
+            ++finished;
+        }
+        return;
+    }
+
+    // (2) or run the ready stages concurrently
+    construct_profile* profile = construct_profile::current();
+    construct_profile::overlap overlap;
+    mm_allocator* alloc = mm::allocator();
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<std::thread> workers;
+    std::exception_ptr error;
+    uint64_t running = 0, running_memory = 0;
+
+    std::unique_lock<std::mutex> lock(mtx);
+    while (finished < n and !(error and running == 0)) {
+        size_t i = n;
+        for (size_t j=0; j < n and i == n and !error; ++j) {
+            const stage& s = m_stages[j];
+            if (started[j] or (running > 0 and running >= m_config.threads) or !(cached[j] or ready(s))) {
+                continue;
+            }
+            if (m_config.memory_limit and s.memory and !cached[j] and memory[j] == 0) {
+                memory[j] = s.memory(m_config);
+            }
+            if (running == 0 or m_config.memory_limit == 0 or running_memory+memory[j] <= m_config.memory_limit) {
+                i = j;
+            }
+        }
+        if (i == n) {
+            if (running == 0) {
+                break;
+            }
+            cv.wait(lock);
+            continue;
+        }
+        started[i] = true;
+        const stage& s = m_stages[i];
+        if (cached[i]) {
+            construct_profile::phase phase(s.name);
+            register_outputs(s, m_config);
+            ++finished;
+            continue;
+        }
+        ++running;
+        running_memory += memory[i];
+        cache_config config = m_config;
+        workers.emplace_back([&, i, config]() mutable {
+            const stage& s = m_stages[i];
+            construct_profile local;
+            std::exception_ptr e;
+            try {
+                mm::allocator_scope alloc_scope(alloc);
+                construct_profile::scope scope(profile != nullptr ? &local : nullptr);
+                construct_profile::phase phase(s.name);
+                s.function(config);
+                register_outputs(s, config);
+            } catch (...) {
+                e = std::current_exception();
+            }
+            std::lock_guard<std::mutex> guard(mtx);
+            for (const auto& file : config.file_map) {
+                m_config.file_map[file.first] = file.second;
+            }
+            if (profile != nullptr) {
+                profile->append(local);
+            }
+            if (e and !error) {
+                error = e;
+            }
+            --running;
+            running_memory -= memory[i];
+            ++finished;
+            cv.notify_all();
+        });
+    }
+    lock.unlock();
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    if (finished < n) {
+        stuck();
+    }
+}
+
+} // end namespace sdsl
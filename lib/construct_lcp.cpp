@@ -50,23 +50,44 @@ void construct_lcp_semi_extern_PHI(cache_config& config)
 
 
     mm::log("lcp-calc-sparse-plcp-begin");
-    for (size_type i=0,j,k,l=0; i < plcp.size(); ++i) {
-        j =	i<<log_q;   // j=i*q
-        k = plcp[i];
-        while (text[j+l] == text[k+l])
-            ++l;
-        plcp[i] = l;
-        if (l >= q) {
-            l -= q;
-        } else {
-            l = 0;
+    // each thread calculates a chunk of the sparse PLCP, starting with l=0
+    const uint32_t threads = std::max(config.threads, (uint32_t)1);
+    const size_type chunk = (plcp.size()+threads-1)/threads;
+    util::parallel_for(threads, [&](uint32_t t) {
+        for (size_type i=std::min(plcp.size(), t*chunk), e=std::min(plcp.size(), (t+1)*chunk), j, k, l=0; i < e; ++i) {
+            j =	i<<log_q;   // j=i*q
+            k = plcp[i];
+            while (text[j+l] == text[k+l])
+                ++l;
+            plcp[i] = l;
+            if (l >= q) {
+                l -= q;
+            } else {
+                l = 0;
+            }
         }
-    }
+    });
     mm::log("lcp-calc-sparse-plcp-end");
 
-    size_type buffer_size = 4000000; // buffer_size is a multiple of 8!
+    size_type buffer_size = construct_buffer_size(config, 4000000, text.size()+plcp.capacity()/8, 2); // buffer_size is a multiple of 8!
     sa_buf.buffersize(buffer_size);
-    int_vector_buffer<> lcp_out_buf(cache_file_name(constants::KEY_LCP, config), std::ios::out, buffer_size, sa_buf.width());	// open buffer for plcp
+    int_vector_buffer<> lcp_out_buf(cache_file_name(constants::KEY_LCP, config), std::ios::out, buffer_size, sa_buf.width(), false, config.compress_files);	// open buffer for plcp
+
+    if (threads > 1) {
+        parallel_lcp_write(sa_buf, lcp_out_buf, threads, [&](size_type sai_1, size_type sai) {
+            size_type l = plcp[sai>>log_q];
+            if ((sai & modq) != 0) {
+                size_type iq = sai & bits::lo_unset[log_q];
+                l = (l > sai-iq) ? l-(sai-iq) : 0;
+                while (text[ sai+l ] == text[ sai_1+l ])
+                    ++l;
+            }
+            return l;
+        });
+        lcp_out_buf.close();
+        register_cache_file(constants::KEY_LCP, config);
+        return;
+    }
 
     for (size_type i=0, sai_1=0,l=0, sai=0,iq=0; i < n; ++i) {
         /*size_type*/ sai = sa_buf[i];
@@ -398,7 +419,10 @@ void construct_lcp_go(cache_config& config)
         const size_type buffer_size = 1000000; // buffer_size has to be a multiple of 8!
         int_vector_buffer<> lcp_big_buf(cache_file_name("lcp_big", config)); 					// file buffer containing the big LCP values
         int_vector_buffer<8> lcp_sml_buf(cache_file_name("lcp_sml", config), std::ios::in, buffer_size);		// file buffer containing the small LCP values
-        int_vector_buffer<> lcp_buf(cache_file_name(constants::KEY_LCP, config), std::ios::out, buffer_size, lcp_big_buf.width()); // buffer for the resulting LCP array
+        int_vector_buffer<> lcp_buf(cache_file_name(constants::KEY_LCP, config), std::ios::out, buffer_size, lcp_big_buf.width(), false, config.compress_files); // buffer for the resulting LCP array
+        lcp_big_buf.access(forward_access);
+        lcp_sml_buf.access(forward_access);
+        lcp_buf.access(forward_access);
         for (size_type i=0, i2=0; i < n; ++i) {
             size_type l = lcp_sml_buf[i];
             if (l >= m) { // if l >= m it is stored in lcp_big
@@ -606,8 +630,11 @@ void construct_lcp_goPHI(cache_config& config)
         const size_type buffer_size = 1000000; // buffer_size has to be a multiple of 8!
         int_vector_buffer<> lcp_big_buf(cache_file_name("lcp_big", config)); 					// file buffer containing the big LCP values
         int_vector_buffer<8> lcp_sml_buf(cache_file_name("lcp_sml", config), std::ios::in, buffer_size);		// file buffer containing the small LCP values
-        int_vector_buffer<> lcp_buf(cache_file_name(constants::KEY_LCP, config), std::ios::out, buffer_size, lcp_big_buf.width()); // file buffer for the resulting LCP array
+        int_vector_buffer<> lcp_buf(cache_file_name(constants::KEY_LCP, config), std::ios::out, buffer_size, lcp_big_buf.width(), false, config.compress_files); // file buffer for the resulting LCP array
 
+        lcp_big_buf.access(forward_access);
+        lcp_sml_buf.access(forward_access);
+        lcp_buf.access(forward_access);
         for (size_type i=0, i2=0; i < n; ++i) {
             size_type l = lcp_sml_buf[i];
             if (l > m) { // if l > m it is stored in lcp_big
@@ -867,6 +894,7 @@ void construct_lcp_bwt_based2(cache_config& config)
         wt_huff<bit_vector, rank_support_v<>, select_support_scan<1>, select_support_scan<0>> wt_bwt;
         construct(wt_bwt, cache_file_name(constants::KEY_BWT, config));
         n = wt_bwt.size();
+        buffer_size = construct_buffer_size(config, buffer_size, n+n/2, 2);
         mm::log("lcp-bwt2-create-wt-huff-begin");
 
         // Declare needed variables
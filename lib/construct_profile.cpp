@@ -0,0 +1,192 @@
+#include "sdsl/construct_profile.hpp"
+#include "sdsl/memory_management.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sys/resource.h>
+
+namespace sdsl
+{
+
+std::atomic<uint64_t> construct_profile::s_bytes_read{0};
+std::atomic<uint64_t> construct_profile::s_bytes_written{0};
+std::atomic<uint64_t> construct_profile::s_cache_hits{0};
+std::atomic<uint64_t> construct_profile::s_cache_misses{0};
+std::atomic<uint32_t> construct_profile::s_overlaps{0};
+
+namespace
+{
+thread_local construct_profile* current_profile = nullptr;
+
+// user and system time of all threads of the process in seconds
+double cpu_time()
+{
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) {
+        return 0;
+    }
+    return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec
+           + (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec)/1000000.0;
+}
+
+// peak resident set size since the last reset_peak_rss() in bytes
+uint64_t peak_rss()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return std::stoull(line.substr(6))*1024;
+        }
+    }
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) {
+        return 0;
+    }
+    return (uint64_t)ru.ru_maxrss*1024;
+}
+
+void reset_peak_rss()
+{
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    clear_refs << "5" << std::flush;
+}
+
+void output_tab(std::ostream& out, size_t level)
+{
+    for (size_t i=0; i < level; ++i) out << "\t";
+}
+
+void write_string(std::ostream& out, const std::string& s)
+{
+    out << "\"";
+    for (char c : s) {
+        if (c == '"' or c == '\\') {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << "\"";
+}
+
+void write_phases(std::ostream& out, const std::vector<construct_profile::phase_record>& phases, size_t level)
+{
+    out << "[";
+    for (size_t i=0; i < phases.size(); ++i) {
+        const construct_profile::phase_record& p = phases[i];
+        out << (i ? "," : "") << std::endl;
+        output_tab(out, level+1); out << "{" << std::endl;
+        output_tab(out, level+2); out << "\"name\":"; write_string(out, p.name); out << "," << std::endl;
+        output_tab(out, level+2); out << "\"wall_time_s\":" << p.wall_time << "," << std::endl;
+        output_tab(out, level+2); out << "\"cpu_time_s\":" << p.cpu_time << "," << std::endl;
+        output_tab(out, level+2); out << "\"peak_rss_bytes\":" << p.peak_rss << "," << std::endl;
+        output_tab(out, level+2); out << "\"bytes_read\":" << p.bytes_read << "," << std::endl;
+        output_tab(out, level+2); out << "\"bytes_written\":" << p.bytes_written << "," << std::endl;
+        output_tab(out, level+2); out << "\"cache_hits\":" << p.cache_hits << "," << std::endl;
+        output_tab(out, level+2); out << "\"cache_misses\":" << p.cache_misses << "," << std::endl;
+        output_tab(out, level+2); out << "\"phases\":";
+        write_phases(out, p.phases, level+2);
+        out << std::endl;
+        output_tab(out, level+1); out << "}";
+    }
+    if (!phases.empty()) {
+        out << std::endl;
+        output_tab(out, level);
+    }
+    out << "]";
+}
+}
+
+construct_profile* construct_profile::current()
+{
+    return current_profile;
+}
+
+construct_profile::scope::scope(construct_profile* profile) : m_prev(current_profile)
+{
+    current_profile = profile;
+}
+
+construct_profile::scope::~scope()
+{
+    current_profile = m_prev;
+}
+
+construct_profile::overlap::overlap()
+{
+    ++s_overlaps;
+}
+
+construct_profile::overlap::~overlap()
+{
+    --s_overlaps;
+}
+
+construct_profile::phase::phase(const std::string& name) : m_profile(current_profile), m_name(name)
+{
+    mm::log(m_name+"-begin");
+    if (m_profile == nullptr) {
+        return;
+    }
+    if (s_overlaps.load() == 0) {
+        if (!m_profile->m_open.empty()) {
+            // the peak of the enclosing phase up to now is lost by the reset
+            phase_record& parent = m_profile->m_open.back();
+            parent.peak_rss = std::max(parent.peak_rss, peak_rss());
+        }
+        reset_peak_rss();
+    }
+    m_profile->m_open.emplace_back();
+    m_profile->m_open.back().name = m_name;
+    m_read_begin    = s_bytes_read.load();
+    m_written_begin = s_bytes_written.load();
+    m_hits_begin    = s_cache_hits.load();
+    m_misses_begin  = s_cache_misses.load();
+    m_cpu_begin     = cpu_time();
+    m_wall_begin    = std::chrono::steady_clock::now();
+}
+
+construct_profile::phase::~phase()
+{
+    if (m_profile != nullptr and !m_profile->m_open.empty()) {
+        phase_record p = std::move(m_profile->m_open.back());
+        m_profile->m_open.pop_back();
+        p.wall_time     = std::chrono::duration<double>(std::chrono::steady_clock::now()-m_wall_begin).count();
+        p.cpu_time      = cpu_time()-m_cpu_begin;
+        p.peak_rss      = std::max(p.peak_rss, peak_rss());
+        p.bytes_read    = s_bytes_read.load()-m_read_begin;
+        p.bytes_written = s_bytes_written.load()-m_written_begin;
+        p.cache_hits    = s_cache_hits.load()-m_hits_begin;
+        p.cache_misses  = s_cache_misses.load()-m_misses_begin;
+        if (m_profile->m_open.empty()) {
+            m_profile->m_phases.push_back(std::move(p));
+        } else {
+            phase_record& parent = m_profile->m_open.back();
+            parent.peak_rss = std::max(parent.peak_rss, p.peak_rss);
+            parent.phases.push_back(std::move(p));
+        }
+    }
+    mm::log(m_name+"-end");
+}
+
+void construct_profile::append(const construct_profile& other)
+{
+    std::vector<phase_record>& phases = m_open.empty() ? m_phases : m_open.back().phases;
+    for (const phase_record& p : other.m_phases) {
+        if (!m_open.empty()) {
+            m_open.back().peak_rss = std::max(m_open.back().peak_rss, p.peak_rss);
+        }
+        phases.push_back(p);
+    }
+}
+
+void construct_profile::write_json(std::ostream& out) const
+{
+    out << "{" << std::endl;
+    output_tab(out, 1); out << "\"class_name\":"; write_string(out, m_name); out << "," << std::endl;
+    output_tab(out, 1); out << "\"phases\":";
+    write_phases(out, m_phases, 1);
+    out << std::endl << "}" << std::endl;
+}
+
+} // end namespace sdsl
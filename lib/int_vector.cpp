@@ -44,4 +44,67 @@ void bit_vector::flip()
     }
 }
 
+namespace
+{
+void check_combine_size(const bit_vector& a, const bit_vector& b, const char* op)
+{
+    if (a.size() != b.size()) {
+        throw std::logic_error(std::string("bit_vector::")+op+": bit_vectors differ in size");
+    }
+}
+}
+
+template<>
+bit_vector& bit_vector::operator&=(const bit_vector& v)
+{
+    check_combine_size(*this, v, "operator&=");
+    bits::combine(bits::op_and, m_data, v.m_data, (m_size+63)>>6);
+    return *this;
+}
+
+template<>
+bit_vector& bit_vector::operator|=(const bit_vector& v)
+{
+    check_combine_size(*this, v, "operator|=");
+    bits::combine(bits::op_or, m_data, v.m_data, (m_size+63)>>6);
+    return *this;
+}
+
+template<>
+bit_vector& bit_vector::operator^=(const bit_vector& v)
+{
+    check_combine_size(*this, v, "operator^=");
+    bits::combine(bits::op_xor, m_data, v.m_data, (m_size+63)>>6);
+    return *this;
+}
+
+template<>
+bit_vector& bit_vector::andnot(const bit_vector& v)
+{
+    check_combine_size(*this, v, "andnot");
+    bits::combine(bits::op_andnot, m_data, v.m_data, (m_size+63)>>6);
+    return *this;
+}
+
+template<>
+bit_vector::size_type bit_vector::count_ones() const
+{
+    return count_ones(0, m_size);
+}
+
+template<>
+bit_vector::size_type bit_vector::count_ones(size_type i, size_type j) const
+{
+    assert(i <= j and j <= m_size);
+    if (i >= j)
+        return 0;
+    size_type bw = i>>6, ew = (j-1)>>6;
+    uint64_t first = m_data[bw] & ~bits::lo_set[i&0x3F];
+    uint64_t last_mask = bits::lo_set[((j-1)&0x3F)+1];
+    if (bw == ew)
+        return bits::cnt(first & last_mask);
+    return bits::cnt(first) + bits::cnt(m_data+bw+1, ew-bw-1)
+           + bits::cnt(m_data[ew] & last_mask);
+}
+
 }
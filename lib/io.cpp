@@ -1,6 +1,7 @@
 #include "sdsl/io.hpp"
 #include "sdsl/sfstream.hpp"
 #include "sdsl/util.hpp"
+#include "sdsl/construct_profile.hpp"
 #include <vector>
 
 namespace sdsl
@@ -77,11 +78,12 @@ bool cache_file_exists(const std::string& key, const cache_config& config)
 {
     std::string file_name = cache_file_name(key, config);
     isfstream in(file_name);
-    if (in) {
+    bool exists = (bool)in;
+    if (exists) {
         in.close();
-        return true;
     }
-    return false;
+    construct_profile::count_cache_lookup(exists);
+    return exists;
 }
 
 std::string tmp_file(const cache_config& config, std::string name_part)
@@ -2,7 +2,18 @@
 
 #include <cstdlib> // for malloc and free
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <cstring>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <set>
+#include <type_traits>
 
 #ifdef MAP_HUGETLB
 #define HUGE_LEN 1073741824
@@ -14,8 +25,6 @@ static int nifty_counter = 0;
 
 using timer = std::chrono::high_resolution_clock;
 
-std::map<uint64_t, sdsl::mm_item_base*> sdsl::mm::m_items;
-uint64_t sdsl::mm::m_total_memory;
 uint64_t* sdsl::mm::m_data;
 std::ostream* sdsl::mm::m_out;
 std::chrono::microseconds sdsl::mm::m_granularity;
@@ -23,16 +32,17 @@ timer::time_point sdsl::mm::m_pre_rtime;
 uint64_t sdsl::mm::m_pre_max_mem;
 
 sdsl::util::spin_lock sdsl::mm::m_spinlock;
+std::atomic<bool> sdsl::mm::m_register_hp{false};
+std::atomic<uint64_t> sdsl::mm::m_registered{0};
 
 sdsl::mm_initializer::mm_initializer()
 {
     if (0 == nifty_counter++) {
-        mm::m_total_memory = 0;
         mm::m_granularity = std::chrono::microseconds(500);
         mm::m_pre_max_mem = 0;
         // initialize static members object here
-        // mm::m_items.clear();
-        mm::m_items = mm::tMVecItem();
+        mm::shards();
+        mm::memory_usage();
         mm::m_data = nullptr;
         mm::m_out = nullptr;
         mm::m_pre_rtime = timer::now();
@@ -49,11 +59,353 @@ sdsl::mm_initializer::~mm_initializer()
 namespace sdsl
 {
 
+namespace
+{
+struct file_mapping {
+    uint64_t len;  // length of the mapping in bytes
+    uint64_t refs; // number of references
+};
+
+// mappings of mm::map_file indexed by their start address
+typedef std::map<uint64_t, file_mapping> tMappings;
+
+tMappings& file_mappings()
+{
+    static tMappings mappings;
+    return mappings;
+}
+
+std::mutex& file_mappings_mutex()
+{
+    static std::mutex mtx;
+    return mtx;
+}
+
+tMappings::iterator find_mapping(const void* p)
+{
+    tMappings& mappings = file_mappings();
+    auto it = mappings.upper_bound((uint64_t)p);
+    if (it == mappings.begin()) {
+        throw std::logic_error("mm: address is not part of a mapped file");
+    }
+    --it;
+    if ((uint64_t)p >= it->first + it->second.len) {
+        throw std::logic_error("mm: address is not part of a mapped file");
+    }
+    return it;
+}
+}
+
+namespace
+{
+thread_local mm_allocator* current_allocator = nullptr;
+
+std::atomic<mm_allocator*>& global_allocator()
+{
+    static std::atomic<mm_allocator*> alloc{nullptr};
+    return alloc;
+}
+}
+
+mm_allocator* mm::default_allocator()
+{
+    static malloc_allocator alloc;
+    mm_allocator* res = global_allocator().load(std::memory_order_acquire);
+    return res != nullptr ? res : &alloc;
+}
+
+void mm::default_allocator(mm_allocator* alloc)
+{
+    global_allocator().store(alloc, std::memory_order_release);
+}
+
+mm_allocator* mm::allocator()
+{
+    return current_allocator != nullptr ? current_allocator : default_allocator();
+}
+
+mm::allocator_scope::allocator_scope(mm_allocator* alloc) : m_prev(current_allocator)
+{
+    current_allocator = alloc;
+}
+
+mm::allocator_scope::~allocator_scope()
+{
+    current_allocator = m_prev;
+}
+
+arena_allocator::arena_allocator(uint64_t capacity, bool hugepages, int numa_node)
+{
+    const uint64_t align = hugepages ? (1ULL<<21) : sysconf(_SC_PAGESIZE);
+    m_capacity = ((capacity+align-1)/align)*align;
+    if (m_capacity == 0) {
+        return;
+    }
+    void* addr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (hugepages) {
+        // no MAP_NORESERVE: the pages have to be reserved now, otherwise
+        // the first access to a missing hugepage raises SIGBUS
+        addr = mmap(nullptr, m_capacity, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        m_hugepages = (addr != MAP_FAILED);
+    }
+#endif
+    if (addr == MAP_FAILED) {
+        addr = mmap(nullptr, m_capacity, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (addr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+#ifdef MADV_HUGEPAGE
+        if (hugepages) {
+            madvise(addr, m_capacity, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    m_begin = (char*)addr;
+#if defined(__linux__) and defined(SYS_mbind)
+    if (numa_node >= 0) {
+        // bind the pages to the node before they are touched (MPOL_BIND)
+        const int mpol_bind = 2;
+        unsigned long mask[16] = {0};
+        if (numa_node < (int)(sizeof(mask)*8)) {
+            mask[numa_node/(sizeof(unsigned long)*8)] |= 1UL << (numa_node%(sizeof(unsigned long)*8));
+            if (syscall(SYS_mbind, addr, m_capacity, mpol_bind, mask, sizeof(mask)*8, 0) != 0 and util::verbose) {
+                std::cerr << "arena_allocator: could not bind to NUMA node " << numa_node << std::endl;
+            }
+        }
+    }
+#else
+    (void)numa_node;
+#endif
+    m_used = m_last = 0;
+}
+
+arena_allocator::~arena_allocator()
+{
+    if (m_begin != nullptr) {
+        munmap(m_begin, m_capacity);
+    }
+}
+
+// Appends a block to the arena; returns nullptr if it does not fit
+void* arena_allocator::allocate(uint64_t size)
+{
+    uint64_t offset = (m_used+63) & ~63ULL;  // cache line alignment
+    if (m_begin == nullptr or offset+size > m_capacity) {
+        return nullptr;
+    }
+    m_last = offset;
+    m_used = offset+size;
+    return m_begin+offset;
+}
+
+void* arena_allocator::reallocate(void* p, uint64_t old_size, uint64_t size)
+{
+    std::lock_guard<util::spin_lock> lock(m_lock);
+    if (p != nullptr and !contains(p)) { // block was allocated by malloc
+        return ::realloc(p, size);
+    }
+    if (p != nullptr) {
+        uint64_t offset = (char*)p - m_begin;
+        if (offset == m_last and m_used > m_last and offset+size <= m_capacity) {
+            m_used = offset+size; // the last block can grow and shrink in place
+            return p;
+        }
+        if (size <= old_size) {
+            return p;
+        }
+    }
+    void* res = allocate(size);
+    if (res == nullptr) {
+        res = malloc(size);
+        if (res == nullptr) {
+            return nullptr;
+        }
+    }
+    if (p != nullptr) {
+        memcpy(res, p, old_size);
+    }
+    return res;
+}
+
+void arena_allocator::deallocate(void* p, uint64_t)
+{
+    std::lock_guard<util::spin_lock> lock(m_lock);
+    if (!contains(p)) {
+        free(p);
+    } else if ((uint64_t)((char*)p - m_begin) == m_last and m_used > m_last) {
+        m_used = m_last; // roll back the last block
+    }
+}
+
+const uint64_t hugepage_allocator::HUGEPAGE_SIZE;
+
+hugepage_allocator::hugepage_allocator(mode_type mode, uint64_t threshold) :
+    m_mode(mode), m_threshold(std::max(threshold, (uint64_t)1)) {}
+
+hugepage_allocator::~hugepage_allocator()
+{
+    for (auto& block : m_blocks) {
+        munmap((void*)block.first, block.second.len);
+    }
+}
+
+// Maps a block of at least size bytes which starts at a hugepage boundary;
+// returns nullptr if this is not possible
+void* hugepage_allocator::map(uint64_t size)
+{
+    uint64_t len = ((size+HUGEPAGE_SIZE-1)/HUGEPAGE_SIZE)*HUGEPAGE_SIZE;
+    void* addr = MAP_FAILED;
+    bool on_hugetlb = false;
+#ifdef MAP_HUGETLB
+    if (m_mode == hugetlb) {
+        // hugetlbfs mappings are aligned by the kernel
+        addr = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        on_hugetlb = (addr != MAP_FAILED);
+    }
+#endif
+    if (addr == MAP_FAILED) {
+        // map one additional page and trim the mapping to the alignment
+        char* raw = (char*)mmap(nullptr, len+HUGEPAGE_SIZE, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == (char*)MAP_FAILED) {
+            return nullptr;
+        }
+        char* begin = (char*)((((uint64_t)raw)+HUGEPAGE_SIZE-1) & ~(HUGEPAGE_SIZE-1));
+        if (begin > raw) {
+            munmap(raw, begin-raw);
+        }
+        if (begin+len < raw+len+HUGEPAGE_SIZE) {
+            munmap(begin+len, raw+len+HUGEPAGE_SIZE-(begin+len));
+        }
+        addr = begin;
+#ifdef MADV_HUGEPAGE
+        madvise(addr, len, MADV_HUGEPAGE);
+#endif
+    }
+    m_blocks[(uint64_t)addr] = {len, on_hugetlb};
+    m_mapped_bytes += len;
+    if (on_hugetlb) {
+        m_hugetlb_bytes += len;
+    }
+    return addr;
+}
+
+void hugepage_allocator::unmap(void* p, uint64_t len, bool on_hugetlb)
+{
+    munmap(p, len);
+    m_mapped_bytes -= len;
+    if (on_hugetlb) {
+        m_hugetlb_bytes -= len;
+    }
+}
+
+void* hugepage_allocator::reallocate(void* p, uint64_t old_size, uint64_t size)
+{
+    std::lock_guard<util::spin_lock> lock(m_lock);
+    auto it = (p != nullptr) ? m_blocks.find((uint64_t)p) : m_blocks.end();
+    if (it != m_blocks.end() and size <= it->second.len) {
+        // shrink in place by releasing the pages after the new end
+        uint64_t len = std::max(((size+HUGEPAGE_SIZE-1)/HUGEPAGE_SIZE)*HUGEPAGE_SIZE, HUGEPAGE_SIZE);
+        if (len < it->second.len) {
+            unmap((char*)p+len, it->second.len-len, it->second.hugetlb);
+            it->second.len = len;
+        }
+        return p;
+    }
+    void* res = nullptr;
+    if (size >= m_threshold) {
+        res = map(size);
+    }
+    if (res == nullptr) {
+        if (it == m_blocks.end()) {
+            return ::realloc(p, size);
+        }
+        if ((res = malloc(size)) == nullptr) {
+            return nullptr;
+        }
+    }
+    if (p != nullptr) {
+        memcpy(res, p, std::min(old_size, size));
+        if (it != m_blocks.end()) {
+            unmap(p, it->second.len, it->second.hugetlb);
+            m_blocks.erase(it);
+        } else {
+            free(p);
+        }
+    }
+    return res;
+}
+
+void hugepage_allocator::deallocate(void* p, uint64_t)
+{
+    std::lock_guard<util::spin_lock> lock(m_lock);
+    auto it = m_blocks.find((uint64_t)p);
+    if (it == m_blocks.end()) {
+        free(p);
+    } else {
+        unmap(p, it->second.len, it->second.hugetlb);
+        m_blocks.erase(it);
+    }
+}
+
+const char* mm::map_file(const std::string& file, uint64_t& size)
+{
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        ::close(fd);
+        return nullptr;
+    }
+    size = st.st_size;
+    // reserve the space for the file and one additional zero page, since
+    // int_vector may access one word after its data
+    uint64_t page = sysconf(_SC_PAGESIZE);
+    uint64_t len  = ((size+page-1)/page)*page + page;
+    void* addr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+        ::close(fd);
+        return nullptr;
+    }
+    if (size > 0 and
+        mmap(addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(addr, len);
+        ::close(fd);
+        return nullptr;
+    }
+    ::close(fd); // the mapping stays valid
+    std::lock_guard<std::mutex> lock(file_mappings_mutex());
+    file_mappings()[(uint64_t)addr] = {len, 1};
+    return (const char*)addr;
+}
+
+void mm::ref_mapping(const void* p)
+{
+    std::lock_guard<std::mutex> lock(file_mappings_mutex());
+    ++find_mapping(p)->second.refs;
+}
+
+void mm::unref_mapping(const void* p)
+{
+    std::lock_guard<std::mutex> lock(file_mappings_mutex());
+    auto it = find_mapping(p);
+    if (0 == --it->second.refs) {
+        munmap((void*)it->first, it->second.len);
+        file_mappings().erase(it);
+    }
+}
+
 
 bool mm::map_hp()
 {
 #ifdef MAP_HUGETLB
-    size_t hpgs= (m_total_memory+HUGE_LEN-1)/HUGE_LEN; // number of huge pages required to store the int_vectors
+    size_t hpgs= (memory_usage()+HUGE_LEN-1)/HUGE_LEN; // number of huge pages required to store the int_vectors
     m_data = (uint64_t*)mmap(nullptr, hpgs*HUGE_LEN, HUGE_PROTECTION, HUGE_FLAGS, 0, 0);
     if (m_data == MAP_FAILED) {
         std::cout << "mmap was not successful" << std::endl;
@@ -62,8 +414,11 @@ bool mm::map_hp()
     // map int_vectors
     uint64_t* addr = m_data;
     bool success = true;
-    for (tMVecItem::const_iterator it=m_items.begin(); it!=m_items.end(); ++it) {
-        success = success && it->second->map_hp(addr);
+    for (uint64_t i=0; i < SHARDS; ++i) {
+        std::lock_guard<util::spin_lock> lock(shards()[i].lock);
+        for (tMVecItem::const_iterator it=shards()[i].items.begin(); it!=shards()[i].items.end(); ++it) {
+            success = success && it->second->map_hp(addr);
+        }
     }
     return success;
 #else
@@ -74,12 +429,15 @@ bool mm::map_hp()
 bool mm::unmap_hp()
 {
 #ifdef MAP_HUGETLB
-    size_t hpgs= (m_total_memory+HUGE_LEN-1)/HUGE_LEN; // number of huge pages
+    size_t hpgs= (memory_usage()+HUGE_LEN-1)/HUGE_LEN; // number of huge pages
     bool success = true;
-    for (tMVecItem::const_iterator it=m_items.begin(); it!=m_items.end(); ++it) {
-        success = success && it->second->unmap_hp();
+    for (uint64_t i=0; i < SHARDS; ++i) {
+        std::lock_guard<util::spin_lock> lock(shards()[i].lock);
+        for (tMVecItem::const_iterator it=shards()[i].items.begin(); it!=shards()[i].items.end(); ++it) {
+            success = success && it->second->unmap_hp();
+        }
     }
-//		uint64_t* tmp_data = (uint64_t*)malloc(m_total_memory); // allocate memory for int_vectors
+//		uint64_t* tmp_data = (uint64_t*)malloc(memory_usage()); // allocate memory for int_vectors
 //		memcpy(tmp_data, m_data, len); // copy data from the mmapped region
     int ret = munmap((void*)m_data, hpgs*HUGE_LEN);
     if (ret == -1) {
@@ -92,6 +450,95 @@ bool mm::unmap_hp()
 #endif
 }
 
+namespace
+{
+struct alignas(64) thread_counter {
+    std::atomic<int64_t> bytes{0};
+};
+
+// The counters of all running threads. Counters of finished threads are
+// folded into retired. The registry is never destroyed, since int_vectors
+// with static storage duration may still be freed after it would be.
+struct counter_registry {
+    std::mutex                 mtx;
+    std::set<thread_counter*>  counters;
+    std::atomic<int64_t>       retired{0};
+};
+
+counter_registry& registry()
+{
+    static counter_registry* r = new counter_registry();
+    return *r;
+}
+
+// int_vectors which are freed by thread local destructors after the
+// counter of the thread is gone are accounted in the retired counter
+thread_local bool local_counter_destroyed = false;
+
+struct thread_counter_guard {
+    thread_counter counter;
+    bool           active = false;
+
+    thread_counter* get() {
+        if (!active) {
+            std::lock_guard<std::mutex> lock(registry().mtx);
+            registry().counters.insert(&counter);
+            active = true;
+        }
+        return &counter;
+    }
+
+    ~thread_counter_guard() {
+        if (active) {
+            std::lock_guard<std::mutex> lock(registry().mtx);
+            registry().retired += counter.bytes.load();
+            registry().counters.erase(&counter);
+            active = false;
+        }
+        local_counter_destroyed = true;
+    }
+};
+
+thread_local thread_counter_guard local_counter;
+}
+
+mm::item_shard* mm::shards()
+{
+    // static storage keeps the alignment of item_shard, which operator new
+    // does not guarantee before C++17. The shards are never destroyed, since
+    // vectors with static storage duration may be removed after exit.
+    static std::aligned_storage<sizeof(item_shard), alignof(item_shard)>::type storage[SHARDS];
+    static item_shard* s = []() {
+        item_shard* p = reinterpret_cast<item_shard*>(storage);
+        for (uint64_t i=0; i < SHARDS; ++i) {
+            new (p+i) item_shard();
+        }
+        return p;
+    }();
+    return s;
+}
+
+void mm::add_memory(int64_t delta)
+{
+    if (local_counter_destroyed) {
+        registry().retired += delta;
+        return;
+    }
+    std::atomic<int64_t>& bytes = local_counter.get()->bytes;
+    bytes.store(bytes.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+uint64_t mm::memory_usage()
+{
+    counter_registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mtx);
+    int64_t total = r.retired.load();
+    for (thread_counter* c : r.counters) {
+        total += c->bytes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
 void mm::log_stream(std::ostream* out)
 {
     std::lock_guard<util::spin_lock> lock(m_spinlock);
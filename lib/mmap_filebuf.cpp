@@ -0,0 +1,70 @@
+#include "sdsl/mmap_filebuf.hpp"
+#include "sdsl/memory_management.hpp"
+
+namespace sdsl
+{
+
+mmap_filebuf::mmap_filebuf() {}
+
+mmap_filebuf::~mmap_filebuf()
+{
+    close();
+}
+
+mmap_filebuf*
+mmap_filebuf::open(const std::string& file)
+{
+    close();
+    m_data = (char*)mm::map_file(file, m_size);
+    if (m_data == nullptr) {
+        m_size = 0;
+        return nullptr;
+    }
+    setg(m_data, m_data, m_data+m_size);
+    return this;
+}
+
+bool
+mmap_filebuf::is_open()
+{
+    return m_data != nullptr;
+}
+
+mmap_filebuf*
+mmap_filebuf::close()
+{
+    if (!is_open())
+        return nullptr;
+    // vectors loaded from the buffer keep their own reference
+    mm::unref_mapping(m_data);
+    m_data = nullptr;
+    m_size = 0;
+    setg(nullptr, nullptr, nullptr);
+    return this;
+}
+
+mmap_filebuf::pos_type
+mmap_filebuf::seekpos(pos_type sp, std::ios_base::openmode which)
+{
+    if (!is_open() or !(which & std::ios_base::in) or
+        sp < (pos_type)0 or sp > (pos_type)m_size) {
+        return pos_type(off_type(-1));
+    }
+    setg(m_data, m_data+(off_type)sp, m_data+m_size);
+    return sp;
+}
+
+mmap_filebuf::pos_type
+mmap_filebuf::seekoff(off_type off, std::ios_base::seekdir way,
+                      std::ios_base::openmode which)
+{
+    off_type base = 0;
+    if (std::ios_base::cur == way) {
+        base = gptr()-eback();
+    } else if (std::ios_base::end == way) {
+        base = m_size;
+    }
+    return seekpos(pos_type(base+off), which);
+}
+
+}
@@ -75,7 +75,10 @@ ram_filebuf::close()
 ram_filebuf::pos_type
 ram_filebuf::seekpos(pos_type sp, std::ios_base::openmode mode)
 {
-    if (sp >= (pos_type)0 and sp <= (pos_type)m_ram_file->size()) {
+    if (!m_ram_file or sp < (pos_type)0) {
+        return pos_type(off_type(-1));
+    }
+    if (sp <= (pos_type)m_ram_file->size()) {
         setg(eback(), eback()+sp, egptr());
         setp(pbase(), epptr());
         pbump(pbase()+sp-pptr()); // pptr should be pbase() anyway after the setp call?
@@ -90,38 +93,35 @@ ram_filebuf::seekpos(pos_type sp, std::ios_base::openmode mode)
             return pos_type(off_type(-1));
         }
     }
-    return 0;
+    return sp;
 }
 
 ram_filebuf::pos_type
-ram_filebuf::pubseekoff(off_type off, std::ios_base::seekdir way,
-                        std::ios_base::openmode which)
+ram_filebuf::seekoff(off_type off, std::ios_base::seekdir way,
+                     std::ios_base::openmode which)
 {
-    if (std::ios_base::beg == way) {
-        if (seekpos(off, which) == pos_type(-1)) {
-            return pos_type(-1);
-        }
-    } else if (std::ios_base::cur == way) {
-        if (seekpos(gptr()-eback()+off, which) == pos_type(-1)) {
-            return pos_type(-1);
-        }
+    off_type base = 0;
+    if (std::ios_base::cur == way) {
+        // the put position may be ahead of the get position after a write
+        base = (which & std::ios_base::in) ? gptr()-eback() : pptr()-pbase();
     } else if (std::ios_base::end == way) {
-        if (seekpos(egptr()-eback()+off, which) == pos_type(-1)) {
-            return pos_type(-1);
-        }
+        base = m_ram_file ? m_ram_file->size() : 0;
     }
-    return gptr()-eback();
+    return seekpos(pos_type(base+off), which);
+}
+
+ram_filebuf::pos_type
+ram_filebuf::pubseekoff(off_type off, std::ios_base::seekdir way,
+                        std::ios_base::openmode which)
+{
+    return seekoff(off, way, which);
 }
 
 
 ram_filebuf::pos_type
 ram_filebuf::pubseekpos(pos_type sp, std::ios_base::openmode which)
 {
-    if (seekpos(sp, which) == pos_type(-1)) {
-        return pos_type(-1);
-    } else {
-        return gptr()-eback();
-    }
+    return seekpos(sp, which);
 }
 
 /*
@@ -0,0 +1,41 @@
+#include "sdsl/sd_vector.hpp"
+
+//! Namespace for the succinct data structure library
+namespace sdsl
+{
+
+sd_vector_builder::sd_vector_builder() : m_items(0) {}
+
+sd_vector_builder::sd_vector_builder(size_type n, size_type m) :
+    m_size(n), m_capacity(m), m_items(0)
+{
+    if (m > n) {
+        throw std::runtime_error("sd_vector_builder: requested capacity is larger than vector size.");
+    }
+    // same parameters as in sd_vector(const bit_vector&)
+    uint8_t logm = bits::hi(m)+1;
+    uint8_t logn = bits::hi(n)+1;
+    if (logm == logn) {
+        --logm;    // to ensure logn-logm > 0
+    }
+    m_wl   = logn - logm;
+    m_low  = int_vector<>(m, 0, m_wl);
+    m_high = bit_vector(m + (1ULL<<logm), 0);
+}
+
+void sd_vector_builder::set(size_type i)
+{
+    if (m_items >= m_capacity) {
+        throw std::runtime_error("sd_vector_builder: the builder is already full.");
+    }
+    if (i >= m_size or (m_items > 0 and i <= m_tail)) {
+        throw std::runtime_error("sd_vector_builder: positions have to be strictly increasing and smaller than the size.");
+    }
+    size_type k = m_items;
+    m_low[k] = i; // int_vector truncates the most significant logm bits
+    m_high[(i >> m_wl) + k] = 1;
+    m_tail = i;
+    ++m_items;
+}
+
+} // end namespace sdsl
@@ -287,4 +287,46 @@ isfstream::operator voidptr()const
     return m_streambuf; // streambuf closes the file on destruction
 }
 
+//  IMPLEMENTATION OF MMAP_IFSTREAM
+
+mmap_ifstream::mmap_ifstream() : std::istream(nullptr)
+{
+    this->init(&m_streambuf);
+    this->setstate(std::ios::failbit);
+}
+
+mmap_ifstream::mmap_ifstream(const std::string& file) : std::istream(nullptr)
+{
+    this->init(&m_streambuf);
+    open(file);
+}
+
+std::streambuf*
+mmap_ifstream::open(const std::string& file)
+{
+    std::streambuf* success = m_streambuf.open(file);
+    if (success) {
+        this->clear();
+    } else {
+        this->setstate(std::ios::failbit);
+    }
+    return success;
+}
+
+bool
+mmap_ifstream::is_open()
+{
+    return m_streambuf.is_open();
+}
+
+void
+mmap_ifstream::close()
+{
+    if (!m_streambuf.close()) {
+        this->setstate(std::ios::failbit);
+    }
+}
+
+mmap_ifstream::~mmap_ifstream() {}
+
 }// end namespace sdsl
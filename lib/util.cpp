@@ -16,6 +16,7 @@
 */
 
 #include "sdsl/util.hpp"
+#include "sdsl/memory_management.hpp"
 #include "cxxabi.h"
 #include <sys/types.h> // for file_size
 #include <sys/stat.h>  // for file_size
@@ -29,7 +30,7 @@ namespace sdsl
 namespace util
 {
 
-uint64_t _id_helper::id = 0;
+std::atomic<uint64_t> _id_helper::id{0};
 
 std::string basename(std::string file)
 {
@@ -139,6 +140,22 @@ off_t file_size(const std::string& file)
     }
 }
 
+void parallel_for(uint32_t threads, const std::function<void(uint32_t)>& f)
+{
+    mm_allocator* alloc = mm::allocator();
+    std::vector<std::thread> workers;
+    for (uint32_t t=1; t < threads; ++t) {
+        workers.emplace_back([&f, alloc, t]() {
+            mm::allocator_scope scope(alloc);
+            f(t);
+        });
+    }
+    f(0);
+    for (auto& w : workers) {
+        w.join();
+    }
+}
+
 }// end namespace util
 
 }// end namespace sdsl
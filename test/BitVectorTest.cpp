@@ -1,6 +1,8 @@
 #include "sdsl/bit_vectors.hpp" // for rrr_vector
 #include "gtest/gtest.h"
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace sdsl;
 using namespace std;
@@ -20,6 +22,10 @@ bit_vector,
 bit_vector_il<256>,
 bit_vector_il<512>,
 bit_vector_il<1024>,
+bit_vector_cl<>,
+bit_vector_cl<64>,
+hyb_vector<>,
+hyb_vector<4>,
 rrr_vector<64>,
 rrr_vector<256>,
 rrr_vector<129>,
@@ -70,6 +76,62 @@ TYPED_TEST(BitVectorTest, Swap)
     }
 }
 
+//! Test the construction of sd_vector by sd_vector_builder
+TEST(SdVectorBuilderTest, Set)
+{
+    bit_vector bv;
+    ASSERT_TRUE(load_from_file(bv, test_file));
+    sd_vector<> expected(bv);
+    std::vector<uint64_t> pos;
+    for (uint64_t j=0; j < bv.size(); ++j) {
+        if (bv[j]) pos.push_back(j);
+    }
+    sd_vector_builder builder(bv.size(), pos.size());
+    for (auto p : pos) {
+        builder.set(p);
+    }
+    ASSERT_EQ(builder.capacity(), builder.items());
+    sd_vector<> sdv(builder);
+    ASSERT_EQ(bv.size(), sdv.size());
+    ASSERT_TRUE(util::to_string(expected) == util::to_string(sdv));
+    sd_vector<>::select_1_type sel(&sdv);
+    for (uint64_t j=0; j < pos.size(); ++j) {
+        ASSERT_EQ(pos[j], sel(j+1));
+    }
+}
+
+//! Test the concurrent construction of sd_vector by sd_vector_builder
+TEST(SdVectorBuilderTest, ParallelSet)
+{
+    bit_vector bv;
+    ASSERT_TRUE(load_from_file(bv, test_file));
+    std::vector<uint64_t> pos;
+    for (uint64_t j=0; j < bv.size(); ++j) {
+        if (bv[j]) pos.push_back(j);
+    }
+    const uint64_t threads = 4;
+    sd_vector_builder builder(bv.size(), pos.size());
+    std::vector<std::thread> workers;
+    for (uint64_t t=0; t < threads; ++t) {
+        workers.emplace_back([&](uint64_t t) {
+            uint64_t b = (pos.size()*t)/threads, e = (pos.size()*(t+1))/threads;
+            builder.set(b, pos.begin()+b, pos.begin()+e);
+        }, t);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    sd_vector<> sdv(builder, threads);
+    ASSERT_EQ(bv.size(), sdv.size());
+    for (uint64_t j=0; j < bv.size(); ++j) {
+        ASSERT_EQ((bool)(bv[j]), (bool)(sdv[j]));
+    }
+    sd_vector<>::select_1_type sel(&sdv);
+    for (uint64_t j=0; j < pos.size(); ++j) {
+        ASSERT_EQ(pos[j], sel(j+1));
+    }
+}
+
 }// end namespace
 
 int main(int argc, char* argv[])
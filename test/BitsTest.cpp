@@ -125,6 +125,102 @@ TEST_F(BitsTest, cnt)
     }
 }
 
+TEST_F(BitsTest, cnt_words)
+{
+    const uint64_t* data = this->m_data.data();
+    for (uint64_t n=0; n<100; ++n) {
+        for (uint64_t offset=0; offset<8; ++offset) {
+            uint64_t cnt = 0;
+            for (uint64_t i=0; i<n; ++i) {
+                cnt += cnt_naive(data[offset+i]);
+            }
+            ASSERT_EQ(cnt, sdsl::bits::cnt(data+offset, n));
+        }
+    }
+    uint64_t cnt = 0;
+    for (uint64_t i=0; i < this->m_data.size(); ++i) {
+        cnt += cnt_naive(data[i]);
+    }
+    ASSERT_EQ(cnt, sdsl::bits::cnt(data, this->m_data.size()));
+}
+
+TEST_F(BitsTest, combine)
+{
+    const uint64_t* data = this->m_data.data();
+    for (uint64_t n=0; n<40; ++n) {
+        for (uint8_t op = sdsl::bits::op_and; op <= sdsl::bits::op_andnot; ++op) {
+            std::vector<uint64_t> a(data, data+n), b(data+n, data+2*n);
+            std::vector<uint64_t> counts(((n>>3)+1)*2, 0);
+            uint64_t cnt = 0;
+            std::vector<uint64_t> expected(n);
+            for (uint64_t i=0; i<n; ++i) {
+                switch (op) {
+                    case sdsl::bits::op_and: expected[i] = a[i] & b[i]; break;
+                    case sdsl::bits::op_or:  expected[i] = a[i] | b[i]; break;
+                    case sdsl::bits::op_xor: expected[i] = a[i] ^ b[i]; break;
+                    default:                 expected[i] = a[i] & ~b[i];
+                }
+                cnt += cnt_naive(expected[i]);
+            }
+            ASSERT_EQ(cnt, sdsl::bits::combine((sdsl::bits::bit_op)op, a.data(), b.data(), n, counts.data()));
+            ASSERT_TRUE(expected == a);
+            uint64_t sum = 0;
+            for (uint64_t i=0; i<n; ++i) {
+                if (!(i&7))
+                    ASSERT_EQ(sum, counts[i>>2]);
+                else
+                    ASSERT_EQ(sum-counts[(i>>3)<<1], (counts[((i>>3)<<1)+1] >> (63-9*(i&7)))&0x1FF);
+                sum += cnt_naive(expected[i]);
+            }
+        }
+    }
+}
+
+TEST_F(BitsTest, read_write_ints)
+{
+    const uint64_t* data = this->m_data.data();
+    std::vector<uint64_t> values(300);
+    for (uint8_t len=1; len<=64; ++len) {
+        for (uint8_t offset=0; offset<64; offset+=7) {
+            for (uint64_t n : {0, 1, 7, 8, 9, 100, 300}) {
+                std::vector<uint64_t> out(n+1, 0);
+                sdsl::bits::read_ints(data+1, offset, len, n, out.data());
+                const uint64_t* word = data+1;
+                uint8_t off = offset;
+                for (uint64_t i=0; i<n; ++i) {
+                    ASSERT_EQ(sdsl::bits::read_int_and_move(word, off, len), out[i]);
+                }
+                ASSERT_EQ((uint64_t)0, out[n]);
+
+                std::vector<uint64_t> a(data, data+600), b(data, data+600);
+                sdsl::bits::write_ints(a.data()+1, offset, len, n, data+700);
+                uint64_t* w = b.data()+1;
+                off = offset;
+                for (uint64_t i=0; i<n; ++i) {
+                    sdsl::bits::write_int_and_move(w, data[700+i], off, len);
+                }
+                ASSERT_TRUE(a == b);
+            }
+        }
+    }
+}
+
+TEST_F(BitsTest, sel_kernels)
+{
+    for (uint64_t i=0; i < this->m_data.size(); i+=7) {
+        uint64_t x = this->m_data[i];
+        for (uint64_t j=0, ones=0; j<64; ++j) {
+            if ((x >> j)&1) {
+                ++ones;
+                ASSERT_EQ(j, sdsl::bits::_sel(x, ones));
+                if (sdsl::bits::cpu.bmi2) {
+                    ASSERT_EQ(j, sdsl::bits::sel_bmi2(x, ones));
+                }
+            }
+        }
+    }
+}
+
 //! Test the parametrized constructor
 TEST_F(BitsTest, sel)
 {
@@ -1,6 +1,7 @@
 #include "sdsl/suffix_arrays.hpp"
 #include "sdsl/coder.hpp"
 #include "gtest/gtest.h"
+#include <sstream>
 #include <vector>
 #include <string>
 
@@ -48,6 +49,161 @@ TYPED_TEST(CsaByteTest, CreateAndStoreTest)
     ASSERT_EQ(true, success);
 }
 
+//! Test the suffix array construction in external memory
+TYPED_TEST(CsaByteTest, CreateExternal)
+{
+    cache_config config(false, temp_dir, util::basename(test_file)+"_external", tMSS(), false, 1ULL<<16);
+    int_vector<8> text;
+    int_vector<> sa, expected;
+    ASSERT_EQ(true, load_from_file(text, test_case_file_map[constants::KEY_TEXT]));
+    store_to_cache(text, constants::KEY_TEXT, config);
+    external_sufsort::construct_sa<8>(config);
+    ASSERT_EQ(true, load_from_cache(sa, constants::KEY_SA, config));
+    ASSERT_EQ(true, load_from_file(expected, test_case_file_map[constants::KEY_SA]));
+    ASSERT_EQ(expected.size(), sa.size());
+    for (size_type j=0; j<sa.size(); ++j) {
+        ASSERT_EQ(expected[j], sa[j])<<" j="<<j;
+    }
+    sdsl::remove(cache_file_name(constants::KEY_TEXT, config));
+    sdsl::remove(cache_file_name(constants::KEY_SA, config));
+}
+
+//! Test the multithreaded suffix array construction
+TYPED_TEST(CsaByteTest, CreateParallel)
+{
+    TypeParam csa;
+    cache_config config(false, temp_dir, util::basename(test_file)+"_parallel", tMSS(), false, 0, 4, true);
+    construct(csa, test_file, config, 1);
+    int_vector<> sa, expected;
+    ASSERT_EQ(true, load_from_cache(sa, constants::KEY_SA, config));
+    ASSERT_EQ(true, load_from_file(expected, test_case_file_map[constants::KEY_SA]));
+    ASSERT_EQ(expected.size(), sa.size());
+    for (size_type j=0; j<sa.size(); ++j) {
+        ASSERT_EQ(expected[j], sa[j])<<" j="<<j;
+        ASSERT_EQ(expected[j], csa[j])<<" j="<<j;
+    }
+    util::delete_all_files(config.file_map);
+}
+
+//! Test the construction by merging the index of a text suffix with a new text prefix
+TYPED_TEST(CsaByteTest, CreateMerged)
+{
+    int_vector<8> text;
+    ASSERT_EQ(true, load_vector_from_file(text, test_file, 1));
+    size_type m = text.size()/2;
+    int_vector<8> new_text(m), old_text(text.size()-m);
+    std::copy(text.begin(), text.begin()+m, new_text.begin());
+    std::copy(text.begin()+m, text.end(), old_text.begin());
+    store_to_plain_array<uint8_t>(new_text, temp_file+"_new");
+    store_to_plain_array<uint8_t>(old_text, temp_file+"_old");
+    cache_config old_config(false, temp_dir, util::basename(test_file)+"_old");
+    cache_config new_config(false, temp_dir, util::basename(test_file)+"_new");
+    cache_config config(false, temp_dir, util::basename(test_file)+"_merged");
+    TypeParam old_csa, new_csa, csa;
+    construct(old_csa, temp_file+"_old", old_config, 1);
+    construct(new_csa, temp_file+"_new", new_config, 1);
+    construct_merged(csa, old_csa, old_config, new_config, config);
+    int_vector<> expected;
+    ASSERT_EQ(true, load_from_file(expected, test_case_file_map[constants::KEY_SA]));
+    ASSERT_EQ(expected.size(), csa.size());
+    for (size_type j=0; j<csa.size(); ++j) {
+        ASSERT_EQ(expected[j], csa[j])<<" j="<<j;
+    }
+    util::delete_all_files(old_config.file_map);
+    util::delete_all_files(new_config.file_map);
+    util::delete_all_files(config.file_map);
+    sdsl::remove(temp_file+"_new");
+    sdsl::remove(temp_file+"_old");
+}
+
+//! Test the construction from a stream
+TYPED_TEST(CsaByteTest, CreateFromStream)
+{
+    TypeParam csa;
+    cache_config config(true, temp_dir, util::basename(test_file)+"_stream");
+    isfstream in(test_file);
+    construct(csa, in, config, 1);
+    int_vector<> expected;
+    ASSERT_EQ(true, load_from_file(expected, test_case_file_map[constants::KEY_SA]));
+    ASSERT_EQ(expected.size(), csa.size());
+    for (size_type j=0; j<csa.size(); ++j) {
+        ASSERT_EQ(expected[j], csa[j])<<" j="<<j;
+    }
+}
+
+//! Test that an invalid text leaves no cache file behind
+TYPED_TEST(CsaByteTest, CreateFromInvalidText)
+{
+    TypeParam csa;
+    cache_config config(true, temp_dir, util::basename(test_file)+"_invalid");
+    std::istringstream in(std::string("ab\0c", 4));
+    ASSERT_THROW(construct(csa, in, config, 1), std::logic_error);
+    ASSERT_FALSE(cache_file_exists(constants::KEY_TEXT, config));
+    int_vector<8> text(3, 'a');
+    text[1] = 0;
+    std::string file = temp_dir+"/"+util::basename(test_file)+"_invalid.sdsl";
+    ASSERT_TRUE(store_to_file(text, file));
+    ASSERT_THROW(construct(csa, file, config, 0), std::logic_error);
+    ASSERT_FALSE(cache_file_exists(constants::KEY_TEXT, config));
+    sdsl::remove(file);
+}
+
+TYPED_TEST(CsaByteTest, CreateBlockwise)
+{
+    int_vector<8> text;
+    ASSERT_EQ(true, load_vector_from_file(text, test_file, 1));
+    append_zero_symbol(text);
+    cache_config config(false, temp_dir, util::basename(test_file)+"_blockwise");
+    store_to_cache(text, constants::KEY_TEXT, config);
+    int_vector<8> expected_bwt;
+    ASSERT_EQ(true, load_from_file(expected_bwt, test_case_file_map[constants::KEY_BWT]));
+    size_type n = text.size();
+    for (size_type block_size : {(size_type)1, (size_type)7, n/3+1, n}) {
+        blockwise_bwt::construct_bwt<8>(config, block_size);
+        int_vector<8> bwt;
+        ASSERT_EQ(true, load_from_cache(bwt, constants::KEY_BWT, config));
+        ASSERT_EQ(expected_bwt.size(), bwt.size());
+        for (size_type j=0; j<n; ++j) {
+            ASSERT_EQ(expected_bwt[j], bwt[j])<<" j="<<j<<" block_size="<<block_size;
+        }
+    }
+    if (construct_without_sa_trait<TypeParam>::value) {
+        // the SA is not cached, so the samples are taken from the BWT
+        TypeParam csa(config);
+        int_vector<> expected;
+        ASSERT_EQ(true, load_from_file(expected, test_case_file_map[constants::KEY_SA]));
+        ASSERT_EQ(expected.size(), csa.size());
+        for (size_type j=0; j<csa.size(); ++j) {
+            ASSERT_EQ(expected[j], csa[j])<<" j="<<j;
+            ASSERT_EQ(j, csa(expected[j]))<<" j="<<j;
+        }
+    }
+    util::delete_all_files(config.file_map);
+}
+
+//! Test that construct() uses the blockwise BWT if only the SA exceeds the memory limit
+TYPED_TEST(CsaByteTest, CreateWithMemoryLimit)
+{
+    size_type n = util::file_size(test_file)+1;
+    uint64_t limit = blockwise_bwt_peak_memory(n, 8, (n+15)/16);
+    if (limit >= sa_peak_memory(n, 8)) { // too small to tell both apart
+        return;
+    }
+    TypeParam csa;
+    cache_config config(false, temp_dir, util::basename(test_file)+"_limit", tMSS(), false, limit);
+    ASSERT_TRUE(use_blockwise_bwt<8>(test_file, config, 1));
+    construct(csa, test_file, config, 1);
+    // without the trait the SA is sorted in external memory
+    ASSERT_EQ(!construct_without_sa_trait<TypeParam>::value, cache_file_exists(constants::KEY_SA, config));
+    int_vector<> expected;
+    ASSERT_EQ(true, load_from_file(expected, test_case_file_map[constants::KEY_SA]));
+    ASSERT_EQ(expected.size(), csa.size());
+    for (size_type j=0; j<csa.size(); ++j) {
+        ASSERT_EQ(expected[j], csa[j])<<" j="<<j;
+    }
+    util::delete_all_files(config.file_map);
+}
+
 //! Test sigma member
 TYPED_TEST(CsaByteTest, Sigma)
 {
@@ -83,6 +239,25 @@ TYPED_TEST(CsaByteTest, SaAccess)
     }
 }
 
+//! Test suffix array access of a CSA loaded from a memory mapped file
+TYPED_TEST(CsaByteTest, SaAccessMapped)
+{
+    uint64_t heap = mm::memory_usage();
+    TypeParam csa;
+    ASSERT_EQ(true, load_from_mapped_file(csa, temp_file));
+    // the int_vectors of csa point into the mapping, none is copied
+    if (!is_ram_file(temp_file)) {
+        ASSERT_EQ(heap, mm::memory_usage());
+    }
+    int_vector<> sa;
+    load_from_file(sa, test_case_file_map[constants::KEY_SA]);
+    size_type n = sa.size();
+    ASSERT_EQ(n, csa.size());
+    for (size_type j=0; j<n; ++j) {
+        ASSERT_EQ(sa[j], csa[j])<<" j="<<j;
+    }
+}
+
 //! Test inverse suffix access methods
 TYPED_TEST(CsaByteTest, IsaAccess)
 {
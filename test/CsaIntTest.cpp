@@ -1,6 +1,8 @@
 #include "sdsl/suffix_arrays.hpp"
 #include "gtest/gtest.h"
 #include <cstdlib>
+#include <sstream>
+#include <random>
 #include <vector>
 #include <string>
 
@@ -30,7 +32,8 @@ typedef Types<  csa_wt<wt_int<>, 32, 32, sa_order_sa_sampling<>, int_vector<>, i
         csa_bitcompressed<int_alphabet<> >,
         csa_wt<wt_int<rrr_vector<63> >, 8, 8, sa_order_sa_sampling<>, int_vector<>, int_alphabet<> >,
         csa_wt<wt_int<>, 32, 32, text_order_sa_sampling<>, int_vector<>, int_alphabet<> >,
-        csa_sada<enc_vector<>, 32, 32, text_order_sa_sampling<>, int_vector<>, int_alphabet<> >
+        csa_sada<enc_vector<>, 32, 32, text_order_sa_sampling<>, int_vector<>, int_alphabet<> >,
+        csa_wt<wt_int<hyb_vector<> >, 32, 32, text_order_sa_sampling<hyb_vector<> >, int_vector<>, int_alphabet<> >
         > Implementations;
 
 TYPED_TEST_CASE(CsaIntTest, Implementations);
@@ -45,6 +48,136 @@ TYPED_TEST(CsaIntTest, CreateAndStoreTest)
     ASSERT_EQ(true, success);
 }
 
+//! Test the suffix array construction in external memory
+TYPED_TEST(CsaIntTest, CreateExternal)
+{
+    cache_config config(false, temp_dir, util::basename(test_file)+"_external", tMSS(), false, 1ULL<<16);
+    int_vector<> text, sa, expected;
+    ASSERT_EQ(true, load_from_file(text, test_case_file_map[constants::KEY_TEXT_INT]));
+    store_to_cache(text, constants::KEY_TEXT_INT, config);
+    external_sufsort::construct_sa<0>(config);
+    ASSERT_EQ(true, load_from_cache(sa, constants::KEY_SA, config));
+    ASSERT_EQ(true, load_from_file(expected, test_case_file_map[constants::KEY_SA]));
+    ASSERT_EQ(expected.size(), sa.size());
+    for (size_type j=0; j<sa.size(); ++j) {
+        ASSERT_EQ(expected[j], sa[j])<<" j="<<j;
+    }
+    sdsl::remove(cache_file_name(constants::KEY_TEXT_INT, config));
+    sdsl::remove(cache_file_name(constants::KEY_SA, config));
+}
+
+//! Test the external suffix array construction with more runs than the fan-in of the merge
+TEST(ExternalSufsortTest, MultiPassMerge)
+{
+    // with the smallest budget each sorter merges at most 2 runs of 1024 records
+    cache_config config(false, temp_dir, "external_multi_pass", tMSS(), false, 1);
+    ASSERT_EQ((uint64_t)2, external_sufsort::record_sorter<2>(config, 8, 0, 0).fan_in());
+    std::mt19937_64 rng(5);
+    int_vector<> text(20000, 0, 3);
+    for (size_type j=0; j+1 < text.size(); ++j) {
+        text[j] = 1 + rng() % 3 + 2*(j/5000 == 2); // a block with a larger alphabet
+    }
+    store_to_cache(text, constants::KEY_TEXT_INT, config);
+    external_sufsort::construct_sa<0>(config);
+    int_vector<> sa, expected;
+    ASSERT_EQ(true, load_from_cache(sa, constants::KEY_SA, config));
+    sais::construct_sa(expected, text);
+    ASSERT_EQ(expected.size(), sa.size());
+    for (size_type j=0; j<sa.size(); ++j) {
+        ASSERT_EQ(expected[j], sa[j])<<" j="<<j;
+    }
+    sdsl::remove(cache_file_name(constants::KEY_TEXT_INT, config));
+    sdsl::remove(cache_file_name(constants::KEY_SA, config));
+}
+
+//! Test the multithreaded suffix array construction
+TYPED_TEST(CsaIntTest, CreateParallel)
+{
+    TypeParam csa;
+    cache_config config(false, temp_dir, util::basename(test_file)+"_parallel", tMSS(), false, 0, 4, true);
+    construct(csa, test_file, config, num_bytes);
+    int_vector<> sa, expected;
+    ASSERT_EQ(true, load_from_cache(sa, constants::KEY_SA, config));
+    ASSERT_EQ(true, load_from_file(expected, test_case_file_map[constants::KEY_SA]));
+    ASSERT_EQ(expected.size(), sa.size());
+    for (size_type j=0; j<sa.size(); ++j) {
+        ASSERT_EQ(expected[j], sa[j])<<" j="<<j;
+        ASSERT_EQ(expected[j], csa[j])<<" j="<<j;
+    }
+    util::delete_all_files(config.file_map);
+}
+
+//! Test the parallel SA-IS on texts which are long enough to be split into blocks
+TEST(ParallelSufsortTest, LongTexts)
+{
+    std::mt19937_64 rng(11);
+    const size_type n = 200000;
+    std::vector<int_vector<>> texts;
+    int_vector<> text(n, 0, 2); // small alphabet
+    for (size_type j=0; j+1 < n; ++j) {
+        text[j] = 1 + rng() % 3;
+    }
+    texts.push_back(text);
+    text = int_vector<>(n, 0, 17); // large alphabet
+    for (size_type j=0; j+1 < n; ++j) {
+        text[j] = 1 + rng() % 100000;
+    }
+    texts.push_back(text);
+    text = int_vector<>(n, 0, 8); // long runs and repetitions
+    for (size_type j=0; j+1 < n; ++j) {
+        text[j] = j%7000 < 3000 ? 1 : 2 + (j%7000)%11;
+    }
+    texts.push_back(text);
+    for (const auto& t : texts) {
+        int_vector<> expected;
+        sais::construct_sa(expected, t);
+        for (uint32_t threads : {3, 4}) {
+            int_vector<> sa;
+            parallel_sufsort::construct_sa(sa, t, threads);
+            ASSERT_EQ(expected.size(), sa.size());
+            for (size_type j=0; j<sa.size(); ++j) {
+                ASSERT_EQ(expected[j], sa[j])<<" j="<<j<<" threads="<<threads;
+            }
+        }
+    }
+}
+
+//! Test the construction from a text which arrives in small chunks
+TYPED_TEST(CsaIntTest, CreateFromSource)
+{
+    TypeParam csa;
+    cache_config config(false, temp_dir, util::basename(test_file)+"_source");
+    isfstream in(test_file);
+    construct(csa, [&in](char* buf, uint64_t size) -> uint64_t {
+        in.read(buf, std::min(size, (uint64_t)7));
+        return in.gcount();
+    }, config, num_bytes);
+    int_vector<> text, expected_text, expected;
+    ASSERT_EQ(true, load_from_cache(text, constants::KEY_TEXT_INT, config));
+    ASSERT_EQ(true, load_from_file(expected_text, test_case_file_map[constants::KEY_TEXT_INT]));
+    ASSERT_EQ(expected_text.size(), text.size());
+    for (size_type j=0; j<text.size(); ++j) {
+        ASSERT_EQ(expected_text[j], text[j])<<" j="<<j;
+    }
+    ASSERT_EQ(true, load_from_file(expected, test_case_file_map[constants::KEY_SA]));
+    ASSERT_EQ(expected.size(), csa.size());
+    for (size_type j=0; j<csa.size(); ++j) {
+        ASSERT_EQ(expected[j], csa[j])<<" j="<<j;
+    }
+    util::delete_all_files(config.file_map);
+}
+
+//! Test that decimal numbers which are followed by another character are rejected
+TYPED_TEST(CsaIntTest, CreateFromInvalidDecimals)
+{
+    TypeParam csa;
+    cache_config config(false, temp_dir, util::basename(test_file)+"_decimals");
+    // load_vector_from_file would stop at 'x' and return 3 1 2
+    std::istringstream in("3 1 2x 4\n");
+    ASSERT_THROW(construct(csa, in, config, 'd'), std::logic_error);
+    ASSERT_FALSE(cache_file_exists(constants::KEY_TEXT_INT, config));
+}
+
 //! Test access methods
 TYPED_TEST(CsaIntTest, Sigma)
 {
@@ -81,6 +214,33 @@ TYPED_TEST(CsaIntTest, SaAccess)
     }
 }
 
+//! Test the SA of the construction against qsufsort
+TYPED_TEST(CsaIntTest, SaMatchesQsufsort)
+{
+    int_vector<> text, sa, expected;
+    ASSERT_EQ(true, load_from_file(text, test_case_file_map[constants::KEY_TEXT_INT]));
+    ASSERT_EQ(true, load_from_file(sa, test_case_file_map[constants::KEY_SA]));
+    qsufsort::construct_sa(expected, text);
+    ASSERT_EQ(expected.size(), sa.size());
+    for (size_type j=0; j<sa.size(); ++j) {
+        ASSERT_EQ(expected[j], sa[j])<<" j="<<j;
+    }
+}
+
+
+//! Test suffix array access on a CSA loaded from a memory mapped file
+TYPED_TEST(CsaIntTest, SaAccessMapped)
+{
+    TypeParam csa;
+    ASSERT_EQ(true, load_from_mapped_file(csa, temp_file));
+    int_vector<> sa;
+    load_from_file(sa, test_case_file_map[constants::KEY_SA]);
+    size_type n = sa.size();
+    ASSERT_EQ(n, csa.size());
+    for (size_type j=0; j<n; ++j) {
+        ASSERT_EQ(sa[j], csa[j])<<" j="<<j;
+    }
+}
 
 //! Test inverse suffix access methods
 TYPED_TEST(CsaIntTest, IsaAccess)
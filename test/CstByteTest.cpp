@@ -62,6 +62,144 @@ TYPED_TEST(CstByteTest, CreateAndStoreTest)
     ASSERT_EQ(true, success);
 }
 
+//! Test construction with block compressed temporary files
+TYPED_TEST(CstByteTest, CreateCompressed)
+{
+    TypeParam cst1;
+    ASSERT_EQ(true, load_from_file(cst1, temp_file));
+    TypeParam cst2;
+    cache_config config(false, temp_dir, util::basename(test_file)+"_compressed", tMSS(), true);
+    construct(cst2, test_file, config, 1);
+    ASSERT_EQ(size_in_bytes(cst1), size_in_bytes(cst2));
+    sdsl::int_vector<> sa;
+    ASSERT_EQ(true, load_from_cache(sa, sdsl::constants::KEY_SA, config));
+    ASSERT_EQ(sa.size(), cst2.csa.size());
+    for (size_type j=0; j<sa.size(); ++j) {
+        ASSERT_EQ(cst1.csa[j], sa[j])<<" j="<<j;
+        ASSERT_EQ(cst1.lcp[j], cst2.lcp[j])<<" j="<<j;
+    }
+    util::delete_all_files(config.file_map);
+}
+
+//! Test construction with a memory budget
+TYPED_TEST(CstByteTest, CreateWithMemoryLimit)
+{
+    TypeParam cst1;
+    ASSERT_EQ(true, load_from_file(cst1, temp_file));
+    uint64_t n = cst1.size();
+    uint64_t limits[] = {lcp_peak_memory(LCP_PHI, n), lcp_peak_memory(LCP_PHI, n)-1};
+    lcp_byte_algorithm expected[] = {LCP_PHI, LCP_SEMI_EXTERN_PHI};
+    for (size_t k=0; k < 2; ++k) {
+        cache_config config(false, temp_dir, util::basename(test_file)+"_limit", tMSS(), false, limits[k]);
+        ASSERT_EQ(expected[k], select_lcp_algorithm(config, n));
+        ASSERT_EQ(0ULL, construct_buffer_size(config, 1000000, 0) % 8);
+        TypeParam cst2;
+        construct(cst2, test_file, config, 1);
+        ASSERT_EQ(n, cst2.size());
+        for (size_type j=0; j<n; ++j) {
+            ASSERT_EQ(cst1.lcp[j], cst2.lcp[j])<<" j="<<j<<" k="<<k;
+        }
+        util::delete_all_files(config.file_map);
+    }
+}
+
+//! Test the concurrent construction of the CSA and the LCP array
+TYPED_TEST(CstByteTest, CreateParallel)
+{
+    TypeParam cst1;
+    ASSERT_EQ(true, load_from_file(cst1, temp_file));
+    TypeParam cst2;
+    cache_config config(false, temp_dir, util::basename(test_file)+"_parallel", tMSS(), false, 0, 4);
+    construct_profile profile;
+    {
+        construct_profile::scope scope(&profile);
+        construct(cst2, test_file, config, 1);
+    }
+    ASSERT_EQ((size_t)6, profile.phases().size());
+    ASSERT_EQ(cst1.size(), cst2.size());
+    for (size_type j=0; j<cst1.size(); ++j) {
+        ASSERT_EQ(cst1.csa[j], cst2.csa[j])<<" j="<<j;
+        ASSERT_EQ(cst1.lcp[j], cst2.lcp[j])<<" j="<<j;
+    }
+    util::delete_all_files(config.file_map);
+}
+
+//! Test the construction by merging the index of a text suffix with a new text prefix
+TYPED_TEST(CstByteTest, CreateMerged)
+{
+    TypeParam cst1;
+    ASSERT_EQ(true, load_from_file(cst1, temp_file));
+    int_vector<8> text;
+    ASSERT_EQ(true, load_vector_from_file(text, test_file, 1));
+    size_type m = text.size()/2;
+    int_vector<8> new_text(m), old_text(text.size()-m);
+    std::copy(text.begin(), text.begin()+m, new_text.begin());
+    std::copy(text.begin()+m, text.end(), old_text.begin());
+    store_to_plain_array<uint8_t>(new_text, temp_file+"_new");
+    store_to_plain_array<uint8_t>(old_text, temp_file+"_old");
+    cache_config old_config(false, temp_dir, util::basename(test_file)+"_old");
+    cache_config new_config(false, temp_dir, util::basename(test_file)+"_new");
+    cache_config config(false, temp_dir, util::basename(test_file)+"_merged");
+    typename TypeParam::csa_type old_csa, new_csa;
+    construct(old_csa, temp_file+"_old", old_config, 1);
+    construct(new_csa, temp_file+"_new", new_config, 1);
+    TypeParam cst2;
+    construct_merged(cst2, old_csa, old_config, new_config, config);
+    ASSERT_EQ(cst1.size(), cst2.size());
+    for (size_type j=0; j<cst1.size(); ++j) {
+        ASSERT_EQ(cst1.csa[j], cst2.csa[j])<<" j="<<j;
+        ASSERT_EQ(cst1.lcp[j], cst2.lcp[j])<<" j="<<j;
+    }
+    util::delete_all_files(old_config.file_map);
+    util::delete_all_files(new_config.file_map);
+    util::delete_all_files(config.file_map);
+    sdsl::remove(temp_file+"_new");
+    sdsl::remove(temp_file+"_old");
+}
+
+//! Test the phase profile of the construction
+TYPED_TEST(CstByteTest, ConstructProfile)
+{
+    TypeParam cst;
+    construct_profile profile;
+    cache_config config(false, temp_dir, util::basename(test_file)+"_profile_"+util::class_to_hash(cst));
+    {
+        construct_profile::scope scope(&profile);
+        construct(cst, test_file, config, 1);
+    }
+    ASSERT_EQ(util::class_name(cst), profile.name());
+    ASSERT_EQ((size_t)6, profile.phases().size());
+    const char* names[] = {"text", "sa", "bwt", "csa", "lcp", "index"};
+    for (size_t i=0; i < 6; ++i) {
+        ASSERT_EQ(names[i], profile.phases()[i].name);
+    }
+    const construct_profile::phase_record& csa = profile.phases()[3];
+    // the peak of a phase includes the peaks of its nested phases
+    for (const auto& p : csa.phases) {
+        ASSERT_LE(p.peak_rss, csa.peak_rss);
+        ASSERT_LE(p.wall_time, csa.wall_time);
+    }
+    ASSERT_LT(0ULL, profile.phases()[4].bytes_written);
+    // a second construction finds all files in the cache and skips the
+    // stages which are only needed for missing files
+    construct_profile cached;
+    cache_config cached_config(false, temp_dir, config.id);
+    {
+        construct_profile::scope scope(&cached);
+        construct(cst, test_file, cached_config, 1);
+    }
+    ASSERT_EQ((size_t)4, cached.phases().size());
+    ASSERT_EQ("bwt", cached.phases()[0].name);
+    for (size_t i=0; i < 3; ++i) {
+        ASSERT_EQ(0ULL, cached.phases()[i].cache_misses);
+        ASSERT_EQ(0ULL, cached.phases()[i].bytes_written);
+    }
+    std::stringstream json;
+    profile.write_json(json);
+    ASSERT_NE(std::string::npos, json.str().find("\"peak_rss_bytes\""));
+    util::delete_all_files(config.file_map);
+}
+
 //! Test the swap method
 TYPED_TEST(CstByteTest, SwapMethod)
 {
@@ -369,6 +369,146 @@ void test_random_access(size_type width=1)
     ivb.close(true);
 }
 
+template<class t_T>
+void test_access_patterns(size_type width=1)
+{
+    std::mt19937_64 rng(17);
+    std::string file_name = "tmp/int_vector_buffer";
+    size_type buffersize = 128, n = 100000;
+    std::vector<uint64_t> exp(n);
+    {
+        // write forward, modify backward
+        t_T ivb(file_name, std::ios::out, buffersize, width);
+        ivb.access(sdsl::forward_access);
+        for (size_type i=0; i < n; ++i) {
+            exp[i] = rng() & sdsl::bits::lo_set[ivb.width()];
+            ivb.push_back(exp[i]);
+        }
+        ivb.access(sdsl::backward_access);
+        ASSERT_EQ(sdsl::backward_access, ivb.access());
+        for (size_type i=n; i > 0; --i) {
+            ASSERT_EQ(exp[i-1], (size_type)ivb[i-1]);
+            if (i % 3 == 0) {
+                exp[i-1] = (exp[i-1]+1) & sdsl::bits::lo_set[ivb.width()];
+                ivb[i-1] = exp[i-1];
+            }
+        }
+        // jump around while blocks are read ahead and written back
+        ivb.access(sdsl::forward_access);
+        for (size_type k=0; k < 1000; ++k) {
+            size_type i = rng() % n;
+            ASSERT_EQ(exp[i], (size_type)ivb[i]);
+            exp[i] = rng() & sdsl::bits::lo_set[ivb.width()];
+            ivb[i] = exp[i];
+        }
+    }
+    {
+        t_T ivb(file_name, std::ios::in, buffersize, width);
+        ivb.access(sdsl::forward_access);
+        ASSERT_EQ(n, ivb.size());
+        for (size_type i=0; i < n; ++i) {
+            ASSERT_EQ(exp[i], (size_type)ivb[i]);
+            ivb[i] = (exp[i]+1) & sdsl::bits::lo_set[ivb.width()];
+        }
+        ivb.access(sdsl::random_access);
+        for (size_type i=0; i < n; i+=1000) {
+            ASSERT_EQ((exp[i]+1) & sdsl::bits::lo_set[ivb.width()], (size_type)ivb[i]);
+        }
+        ivb.close(true);
+    }
+}
+
+//! Test read ahead and write back for announced access patterns
+TEST_F(IntVectorBufferTest, AccessPatterns)
+{
+    for (size_type width=1; width <= 64; width+=7) {
+        test_access_patterns< sdsl::int_vector_buffer<> >(width);
+    }
+    test_access_patterns< sdsl::int_vector_buffer<1> >();
+    test_access_patterns< sdsl::int_vector_buffer<8> >();
+    test_access_patterns< sdsl::int_vector_buffer<64> >();
+}
+
+template<class t_T, class t_V>
+void test_compressed(size_type width=1)
+{
+    std::mt19937_64 rng(19);
+    std::string file_name = "tmp/int_vector_buffer";
+    size_type buffersize = 1000, n = 50000;
+    std::vector<uint64_t> exp(n);
+    {
+        // runs, increasing and random values in different blocks
+        t_T ivb(file_name, std::ios::out, buffersize, width, false, true);
+        for (size_type i=0; i < n; ++i) {
+            if (i < n/3) {
+                exp[i] = (i/100)%3;
+            } else if (i < 2*n/3) {
+                exp[i] = i*7;
+            } else {
+                exp[i] = rng();
+            }
+            exp[i] &= sdsl::bits::lo_set[ivb.width()];
+            ivb.push_back(exp[i]);
+        }
+    }
+    if (width >= 8) {
+        // the runs and the increasing values are compressed
+        ASSERT_LT((size_type)sdsl::util::file_size(file_name), (n*width)/8);
+    }
+    {
+        t_T ivb(file_name, std::ios::in, 5000, width);
+        ASSERT_EQ(n, ivb.size());
+        ASSERT_EQ((uint8_t)width, ivb.width());
+        // blocks which are written again are appended to the file
+        for (size_type k=0; k < 1000; ++k) {
+            size_type i = rng() % n;
+            exp[i] = rng() & sdsl::bits::lo_set[ivb.width()];
+            ivb[i] = exp[i];
+        }
+        for (size_type k=0; k < 1000; ++k) {
+            size_type i = rng() % n;
+            ASSERT_EQ(exp[i], (size_type)ivb[i]);
+        }
+        ivb.access(sdsl::forward_access);
+        for (size_type i=0; i < n; ++i) {
+            ASSERT_EQ(exp[i], (size_type)ivb[i]);
+        }
+        ivb[n+10] = 1;
+        exp.resize(n+11, 0);
+        exp[n+10] = 1;
+    }
+    // int_vector::load decompresses the file
+    t_V iv;
+    ASSERT_TRUE(sdsl::load_from_file(iv, file_name));
+    ASSERT_EQ(exp.size(), iv.size());
+    ASSERT_EQ((uint8_t)width, iv.width());
+    for (size_type i=0; i < iv.size(); ++i) {
+        ASSERT_EQ(exp[i], (size_type)iv[i]);
+    }
+    ASSERT_TRUE(sdsl::store_to_compressed_file(iv, file_name));
+    t_V iv2;
+    ASSERT_TRUE(sdsl::load_from_file(iv2, file_name));
+    ASSERT_TRUE(iv == iv2);
+    sdsl::remove(file_name);
+    // the same for a file in the in-memory file system
+    std::string ram_file = sdsl::ram_file_name(file_name);
+    ASSERT_TRUE(sdsl::store_to_compressed_file(iv, ram_file));
+    t_V iv3;
+    ASSERT_TRUE(sdsl::load_from_file(iv3, ram_file));
+    ASSERT_TRUE(iv == iv3);
+    sdsl::remove(ram_file);
+}
+
+//! Test the block compressed file format
+TEST_F(IntVectorBufferTest, Compressed)
+{
+    for (size_type width=1; width <= 64; width+=9) {
+        test_compressed< sdsl::int_vector_buffer<>, sdsl::int_vector<> >(width);
+    }
+    test_compressed< sdsl::int_vector_buffer<8>, sdsl::int_vector<8> >(8);
+    test_compressed< sdsl::int_vector_buffer<64>, sdsl::int_vector<64> >(64);
+}
+
 //! Test RandomAcces, which should not be done in practice because it is expected to be very slow
 TEST_F(IntVectorBufferTest, RandomAccess)
 {
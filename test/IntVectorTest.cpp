@@ -5,6 +5,7 @@
 #include <string>
 #include <random>
 #include <algorithm>
+#include <thread>
 
 namespace
 {
@@ -201,6 +202,300 @@ void test_AssignAndModifyElement<sdsl::bit_vector>(uint64_t size, uint8_t width)
     }
 }
 
+TEST_F(IntVectorTest, BitOperations)
+{
+    std::mt19937_64 rng(7);
+    for (size_type i=0; i < vec_sizes.size(); ++i) {
+        size_type n = vec_sizes[i];
+        sdsl::bit_vector a(n), b(n);
+        for (size_type j=0; j < n; ++j) {
+            a[j] = rng()&1;
+            b[j] = rng()&1;
+        }
+        sdsl::bit_vector r_and = a, r_or = a, r_xor = a, r_andnot = a;
+        r_and &= b;
+        r_or |= b;
+        r_xor ^= b;
+        r_andnot.andnot(b);
+        size_type ones = 0;
+        for (size_type j=0; j < n; ++j) {
+            ASSERT_EQ(a[j] and b[j], r_and[j]);
+            ASSERT_EQ(a[j] or b[j], r_or[j]);
+            ASSERT_EQ(a[j] != b[j], r_xor[j]);
+            ASSERT_EQ(a[j] and !b[j], r_andnot[j]);
+            ones += a[j];
+        }
+        ASSERT_EQ(ones, a.count_ones());
+    }
+    sdsl::bit_vector a(10), b(11);
+    ASSERT_THROW(a &= b, std::logic_error);
+}
+
+TEST_F(IntVectorTest, CountOnes)
+{
+    std::mt19937_64 rng(11);
+    sdsl::bit_vector bv(5000);
+    for (size_type j=0; j < bv.size(); ++j) {
+        bv[j] = rng()&1;
+    }
+    for (size_type k=0; k < 2000; ++k) {
+        size_type i = rng()%(bv.size()+1), j = rng()%(bv.size()+1);
+        if (i > j)
+            std::swap(i, j);
+        if (k%4 == 0)
+            j = std::min(i+rng()%130, (size_type)bv.size());
+        size_type ones = 0;
+        for (size_type l=i; l < j; ++l) {
+            ones += bv[l];
+        }
+        ASSERT_EQ(ones, bv.count_ones(i, j));
+    }
+}
+
+template<class t_iv>
+void test_GetAndSetRange(size_type n, uint8_t width)
+{
+    std::mt19937_64 rng(17);
+    t_iv iv(n, 0, width);
+    for (size_type j=0; j < n; ++j) {
+        iv[j] = rng();
+    }
+    std::vector<uint64_t> buf(n);
+    for (size_type k=0; k < 50; ++k) {
+        size_type i = rng()%(n+1);
+        size_type m = rng()%(n-i+1);
+        iv.get_range(i, m, buf.data());
+        for (size_type j=0; j < m; ++j) {
+            ASSERT_EQ((uint64_t)iv[i+j], buf[j]);
+        }
+        if (k%10 == 0) {
+            auto it = iv.begin()+i;
+            std::vector<uint64_t> buf2(m);
+            for (size_type j=0; j < m; ++j) {
+                buf2[j] = *(it+j);
+            }
+            ASSERT_TRUE(std::equal(buf2.begin(), buf2.end(), buf.begin()));
+        }
+        t_iv expected = iv;
+        for (size_type j=0; j < m; ++j) {
+            buf[j] = rng() & sdsl::bits::lo_set[iv.width()];
+            expected[i+j] = buf[j];
+        }
+        iv.set_range(i, m, buf.data());
+        ASSERT_TRUE(expected == iv);
+    }
+}
+
+TEST_F(IntVectorTest, GetAndSetRange)
+{
+    for (uint8_t width=1; width <= 64; ++width) {
+        test_GetAndSetRange< sdsl::int_vector<> >(1000, width);
+    }
+    test_GetAndSetRange<sdsl::bit_vector     >(1000,  1);
+    test_GetAndSetRange<sdsl::int_vector< 8> >(1000,  8);
+    test_GetAndSetRange<sdsl::int_vector<16> >(1000, 16);
+    test_GetAndSetRange<sdsl::int_vector<32> >(1000, 32);
+    test_GetAndSetRange<sdsl::int_vector<64> >(1000, 64);
+    test_GetAndSetRange<sdsl::int_vector<13> >(1000, 13);
+}
+
+TEST_F(IntVectorTest, ConstIteratorGetRange)
+{
+    std::mt19937_64 rng(19);
+    sdsl::int_vector<> iv(5000, 0, 23);
+    for (size_type j=0; j < iv.size(); ++j) {
+        iv[j] = rng();
+    }
+    const sdsl::int_vector<>& civ = iv;
+    std::vector<uint64_t> buf(civ.size());
+    for (size_type i=0; i < civ.size(); i += 333) {
+        auto it = civ.begin()+i;
+        it.get_range(civ.size()-i, buf.data());
+        for (size_type j=i; j < civ.size(); ++j) {
+            ASSERT_EQ((uint64_t)civ[j], buf[j-i]);
+        }
+    }
+}
+
+TEST_F(IntVectorTest, BitCompress)
+{
+    std::mt19937_64 rng(23);
+    for (uint8_t width=1; width <= 64; width += 3) {
+        sdsl::int_vector<> iv(3001, 0, 64);
+        for (size_type j=0; j < iv.size(); ++j) {
+            iv[j] = rng() & sdsl::bits::lo_set[width];
+        }
+        sdsl::int_vector<> expected = iv;
+        sdsl::util::bit_compress(iv);
+        ASSERT_TRUE(iv.width() <= width);
+        ASSERT_EQ(expected.size(), iv.size());
+        for (size_type j=0; j < iv.size(); ++j) {
+            ASSERT_EQ((uint64_t)expected[j], (uint64_t)iv[j]);
+        }
+    }
+}
+
+TEST_F(IntVectorTest, LoadMapped)
+{
+    std::mt19937_64 rng(29);
+    sdsl::int_vector<> iv(100000, 0, 13);
+    sdsl::bit_vector bv(12345);
+    for (size_type i=0; i<iv.size(); ++i)
+        iv[i] = rng();
+    for (size_type i=0; i<bv.size(); ++i)
+        bv[i] = rng()&1;
+    sdsl::int_vector<64> iv64(1000);
+    for (size_type i=0; i<iv64.size(); ++i)
+        iv64[i] = rng();
+    std::string file_name = "tmp/int_vector_mapped";
+    {
+        sdsl::osfstream out(file_name, std::ios::binary | std::ios::trunc | std::ios::out);
+        iv64.serialize(out);
+        iv.serialize(out);
+        bv.serialize(out);
+    }
+    sdsl::int_vector<64> iv64_2;
+    sdsl::int_vector<> iv2;
+    sdsl::bit_vector bv2;
+    uint64_t heap = sdsl::mm::memory_usage();
+    {
+        // the vectors stay valid after the stream is closed; the headers
+        // are padded, so all payloads are aligned and mapped, not copied
+        sdsl::mmap_ifstream in(file_name);
+        ASSERT_TRUE(in.is_open());
+        iv64_2.load(in);
+        iv2.load(in);
+        bv2.load(in);
+        ASSERT_TRUE((bool)in);
+    }
+    ASSERT_EQ(heap, sdsl::mm::memory_usage());
+    ASSERT_TRUE(iv64 == iv64_2);
+    ASSERT_TRUE(iv == iv2);
+    ASSERT_TRUE(bv == bv2);
+    // changes are private to the process
+    iv64_2[0] = iv64_2[0]+1;
+    iv2[0] = iv2[0]+1;
+    bv2.flip();
+    sdsl::int_vector<64> iv3;
+    ASSERT_TRUE(sdsl::load_from_mapped_file(iv3, file_name));
+    ASSERT_TRUE(iv64 == iv3);
+    // resizing copies the data out of the mapping
+    iv3.resize(iv3.size()+1000);
+    iv3[iv3.size()-1] = 5;
+    for (size_type i=0; i<iv64.size(); ++i)
+        ASSERT_EQ(iv64[i], iv3[i]);
+    sdsl::int_vector<64> iv4 = iv64_2;
+    ASSERT_TRUE(iv4 == iv64_2);
+    sdsl::remove(file_name);
+}
+
+TEST_F(IntVectorTest, ArenaAllocator)
+{
+    std::mt19937_64 rng(31);
+    sdsl::arena_allocator arena(1ULL<<22);
+    sdsl::int_vector<> iv1(1000, 0, 17);
+    {
+        sdsl::mm::allocator_scope scope(&arena);
+        sdsl::int_vector<> iv2(1000, 0, 17);
+        sdsl::bit_vector bv(5000, 1);
+        ASSERT_TRUE(arena.contains(iv2.data()));
+        ASSERT_TRUE(arena.contains(bv.data()));
+        ASSERT_FALSE(arena.contains(iv1.data()));
+        for (size_type i=0; i<iv2.size(); ++i)
+            iv1[i] = iv2[i] = rng();
+        // the last block is resized in place, the others are moved
+        uint64_t used = arena.used();
+        bv.resize(10000);
+        ASSERT_LT(used, arena.used());
+        iv2.resize(2000);
+        ASSERT_TRUE(arena.contains(iv2.data()));
+        for (size_type i=0; i<iv1.size(); ++i)
+            ASSERT_EQ(iv1[i], iv2[i]);
+        // blocks which do not fit are allocated on the heap
+        sdsl::int_vector<64> large(1ULL<<20);
+        ASSERT_FALSE(arena.contains(large.data()));
+        large[large.size()-1] = 3;
+        // threads of parallel_for use the allocator of the caller
+        std::vector<bool> in_arena(4, false);
+        sdsl::util::parallel_for(4, [&](uint32_t t) {
+            sdsl::int_vector<> iv(1000, t, 17);
+            in_arena[t] = arena.contains(iv.data());
+        });
+        for (size_t t=0; t<in_arena.size(); ++t)
+            ASSERT_TRUE(in_arena[t]) << " t=" << t;
+    }
+    // vectors keep their allocator
+    sdsl::int_vector<> iv3(1000, 0, 17);
+    ASSERT_FALSE(arena.contains(iv3.data()));
+    ASSERT_EQ(sdsl::mm::default_allocator(), sdsl::mm::allocator());
+}
+
+TEST_F(IntVectorTest, HugepageAllocator)
+{
+    const uint64_t page = sdsl::hugepage_allocator::HUGEPAGE_SIZE;
+    for (auto mode : {sdsl::hugepage_allocator::transparent, sdsl::hugepage_allocator::hugetlb}) {
+        std::mt19937_64 rng(17);
+        sdsl::hugepage_allocator hp(mode);
+        sdsl::mm::default_allocator(&hp);
+        sdsl::int_vector<> small(1000, 0, 17);
+        sdsl::int_vector<> large(1ULL<<20, 0, 33);
+        ASSERT_EQ(0ULL, ((uint64_t)large.data()) % page);
+        ASSERT_NE(0ULL, hp.mapped_bytes());
+        // hugetlbfs pages are only used if the pool is not empty
+        ASSERT_LE(hp.hugetlb_bytes(), hp.mapped_bytes());
+        for (size_type i=0; i<large.size(); ++i)
+            large[i] = rng();
+        // small blocks which grow are moved into a mapping
+        small.resize(1ULL<<21);
+        ASSERT_EQ(0ULL, ((uint64_t)small.data()) % page);
+        // the mapping is trimmed when the block shrinks
+        uint64_t mapped = hp.mapped_bytes();
+        large.resize(1000);
+        ASSERT_LT(hp.mapped_bytes(), mapped);
+        rng.seed(17);
+        for (size_type i=0; i<large.size(); ++i)
+            ASSERT_EQ(rng() & sdsl::bits::lo_set[33], large[i]);
+        sdsl::mm::default_allocator(nullptr);
+        // vectors keep their allocator
+        small.resize(1);
+        large = sdsl::int_vector<>();
+        small = sdsl::int_vector<>();
+        ASSERT_EQ(0ULL, hp.mapped_bytes());
+    }
+}
+
+TEST_F(IntVectorTest, MemoryAccounting)
+{
+    // with and without registration of the vectors for map_hp
+    for (bool reg : {false, true}) {
+        sdsl::mm::register_for_hp(reg);
+        uint64_t base = sdsl::mm::memory_usage();
+        std::vector<sdsl::int_vector<>> moved(4);
+        std::vector<std::thread> threads;
+        for (size_type t=0; t<moved.size(); ++t) {
+            threads.emplace_back([t, &moved]() {
+                std::mt19937_64 rng(t);
+                for (size_type i=0; i<1000; ++i) {
+                    sdsl::int_vector<> iv(rng()%5000, 0, 1+rng()%64);
+                    iv.resize(rng()%5000);
+                    sdsl::bit_vector bv(rng()%5000);
+                }
+                moved[t] = sdsl::int_vector<>(10000*(t+1), 0, 64);
+            });
+        }
+        for (auto& th : threads)
+            th.join();
+        // the vectors created by the finished threads are freed by this thread
+        uint64_t live = 0;
+        for (auto& v : moved)
+            live += ((v.bit_size()+63)>>6)<<3;
+        ASSERT_EQ(base+live, sdsl::mm::memory_usage());
+        moved.clear();
+        ASSERT_EQ(base, sdsl::mm::memory_usage());
+    }
+    sdsl::mm::register_for_hp(false);
+}
+
 TEST_F(IntVectorTest, AssignAndModifyElement)
 {
     // unspecialized vector for each possible width
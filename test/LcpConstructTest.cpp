@@ -95,6 +95,31 @@ TEST_F(LcpConstructTest, construct_lcp)
     }
 }
 
+TEST_F(LcpConstructTest, construct_lcp_parallel)
+{
+    this->test_config.threads = 4;
+    tMSFP parallel_function;
+    parallel_function["PHI"] = &construct_lcp_PHI<8>;
+    parallel_function["semi_extern_PHI"] = &construct_lcp_semi_extern_PHI;
+    for (tMSFP::const_iterator it = parallel_function.begin(), end = parallel_function.end(); it != end; ++it) {
+        string info = "construct_lcp_" + (it->first) + " with 4 threads on test file " + test_file;
+        (it->second)(this->test_config);
+        int_vector<> lcp_check, lcp;
+        ASSERT_TRUE(load_from_file(lcp_check, cache_file_name(CHECK_KEY, this->test_config)))
+                << info << " could not load reference lcp array";
+        ASSERT_TRUE(load_from_file(lcp, cache_file_name(constants::KEY_LCP, this->test_config)))
+                << info << " could not load created lcp array";
+        ASSERT_EQ(lcp_check.size(), lcp.size())
+                << info << " lcp array size differ";
+        for (uint64_t j=0; j<lcp.size(); ++j) {
+            ASSERT_EQ(lcp_check[j], lcp[j])
+                    << info << " value differ:" << " lcp_check[" << j << "]="
+                    << lcp_check[j] << "!=" << lcp[j] << "=lcp["<< j << "]";
+        }
+        sdsl::remove(cache_file_name(constants::KEY_LCP, this->test_config));
+    }
+}
+
 }  // namespace
 
 int main(int argc, char** argv)
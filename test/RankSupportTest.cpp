@@ -2,6 +2,8 @@
 #include "sdsl/rank_support.hpp"
 #include "gtest/gtest.h"
 #include <string>
+#include <vector>
+#include <random>
 
 using namespace sdsl;
 using namespace std;
@@ -19,6 +21,8 @@ using testing::Types;
 typedef Types<rank_support_il<1, 256>,
         rank_support_il<1, 512>,
         rank_support_il<1, 1024>,
+        rank_support_cl<1, 512>,
+        rank_support_hyb<>,
         rank_support_rrr<>,
         rank_support_v<>,
         rank_support_v5<>,
@@ -53,6 +57,132 @@ TYPED_TEST(RankSupportTest, RankMethod)
     EXPECT_EQ(rank, rs.rank(bvec.size()));
 }
 
+template<class T>
+class RankSupportBatchTest : public ::testing::Test { };
+
+typedef Types<rank_support_v<>,
+        rank_support_v<0>,
+        rank_support_v5<>,
+        rank_support_rrr<>,
+        rank_support_rrr<0>,
+        rank_support_rrr<1, 63>,
+        rank_support_sd<>
+        > BatchImplementations;
+
+TYPED_TEST_CASE(RankSupportBatchTest, BatchImplementations);
+
+//! Test the batch rank method
+TYPED_TEST(RankSupportBatchTest, BatchRankMethod)
+{
+    bit_vector bvec;
+    ASSERT_TRUE(load_from_file(bvec, test_file));
+    typename TypeParam::bit_vector_type bv(bvec);
+    TypeParam rs(&bv);
+    std::vector<uint64_t> pos(bvec.size()+1), res(bvec.size()+1);
+    std::mt19937_64 rng(13);
+    for (uint64_t j=0; j < pos.size(); ++j) {
+        pos[j] = rng() % pos.size();
+    }
+    rs.rank(pos.data(), pos.size(), res.data());
+    for (uint64_t j=0; j < pos.size(); ++j) {
+        ASSERT_EQ(rs.rank(pos[j]), res[j]);
+    }
+}
+
+template<class T>
+class RankSupportSuccessorTest : public ::testing::Test { };
+
+typedef Types<rank_support_v<>,
+        rank_support_rrr<>,
+        rank_support_rrr<1, 63>,
+        rank_support_rrr<1, 256>,
+        rank_support_sd<>
+        > SuccessorImplementations;
+
+TYPED_TEST_CASE(RankSupportSuccessorTest, SuccessorImplementations);
+
+//! Test the successor and predecessor methods
+TYPED_TEST(RankSupportSuccessorTest, SuccessorPredecessorMethod)
+{
+    bit_vector bvec;
+    ASSERT_TRUE(load_from_file(bvec, test_file));
+    typename TypeParam::bit_vector_type bv(bvec);
+    TypeParam rs(&bv);
+    uint64_t succ = bvec.size();
+    for (uint64_t j=bvec.size(); j > 0; --j) {
+        if (bvec[j-1])
+            succ = j-1;
+        ASSERT_EQ(succ, rs.successor(j-1));
+    }
+    EXPECT_EQ(bvec.size(), rs.successor(bvec.size()));
+    uint64_t pred = bvec.size();
+    for (uint64_t j=0; j < bvec.size(); ++j) {
+        if (bvec[j])
+            pred = j;
+        ASSERT_EQ(pred, rs.predecessor(j));
+    }
+}
+
+//! Test successor and predecessor of sd_vector across long runs of empty buckets
+TEST(RankSupportSdTest, SuccessorLongGaps)
+{
+    // dense clusters separated by gaps of many empty buckets
+    bit_vector bvec(1ULL<<22, 0);
+    for (uint64_t c : {(uint64_t)0, (uint64_t)1<<12, (uint64_t)1<<20, (uint64_t)3<<20, bvec.size()-200}) {
+        for (uint64_t j=c; j < c+200; j += 3)
+            bvec[j] = 1;
+    }
+    sd_vector<> sd(bvec);
+    sd_vector<rrr_vector<63>> sd_rrr(bvec);
+    std::vector<uint64_t> succ(bvec.size()), pred(bvec.size());
+    for (uint64_t j=bvec.size(), s=bvec.size(); j > 0; --j) {
+        if (bvec[j-1])
+            s = j-1;
+        succ[j-1] = s;
+    }
+    for (uint64_t j=0, p=bvec.size(); j < bvec.size(); ++j) {
+        if (bvec[j])
+            p = j;
+        pred[j] = p;
+    }
+    std::mt19937_64 rng(7);
+    for (uint64_t k=0; k < 100000; ++k) {
+        uint64_t j = rng() % bvec.size();
+        ASSERT_EQ(succ[j], sd.successor(j)) << " j=" << j;
+        ASSERT_EQ(succ[j], sd_rrr.successor(j)) << " j=" << j;
+        ASSERT_EQ(pred[j], sd.predecessor(j)) << " j=" << j;
+        ASSERT_EQ(pred[j], sd_rrr.predecessor(j)) << " j=" << j;
+    }
+}
+
+//! Test the update of rank_support_v by combine
+TEST(RankSupportCombineTest, Combine)
+{
+    bit_vector bvec;
+    ASSERT_TRUE(load_from_file(bvec, test_file));
+    bit_vector other(bvec.size());
+    for (uint64_t j=0; j < other.size(); ++j) {
+        other[j] = (j*7+3)%5 < 2;
+    }
+    for (uint8_t op = bits::op_and; op <= bits::op_andnot; ++op) {
+        bit_vector bv(bvec);
+        rank_support_v<> rs(&bv);
+        rs.combine(bv, other, (bits::bit_op)op);
+        bit_vector expected(bvec);
+        switch (op) {
+            case bits::op_and: expected &= other; break;
+            case bits::op_or:  expected |= other; break;
+            case bits::op_xor: expected ^= other; break;
+            default:           expected.andnot(other);
+        }
+        ASSERT_TRUE(expected == bv);
+        rank_support_v<> rs_expected(&expected);
+        for (uint64_t j=0; j <= bv.size(); ++j) {
+            ASSERT_EQ(rs_expected(j), rs(j));
+        }
+    }
+}
+
 }// end namespace
 
 int main(int argc, char** argv)
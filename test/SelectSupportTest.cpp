@@ -2,6 +2,8 @@
 #include "sdsl/select_support.hpp"
 #include "gtest/gtest.h"
 #include <string>
+#include <vector>
+#include <random>
 
 using namespace sdsl;
 using namespace std;
@@ -29,7 +31,11 @@ typedef Types<select_support_mcl<>,
         select_support_sd<>,
         select_support_il<1, 256>,
         select_support_il<1, 512>,
-        select_support_il<1, 1024>
+        select_support_il<1, 1024>,
+        select_support_cl<1, 64>,
+        select_support_cl<1, 512>,
+        select_support_hyb<>,
+        select_support_hyb<1, 4>
         > Implementations;
 
 TYPED_TEST_CASE(SelectSupportTest, Implementations);
@@ -49,6 +55,98 @@ TYPED_TEST(SelectSupportTest, SelectMethod)
     }
 }
 
+template<class T>
+class SelectSupportBatchTest : public ::testing::Test { };
+
+typedef Types<select_support_mcl<>,
+        select_support_rrr<1, 15>,
+        select_support_rrr<1, 63>,
+        select_support_sd<>
+        > BatchImplementations;
+
+TYPED_TEST_CASE(SelectSupportBatchTest, BatchImplementations);
+
+//! Test the batch select method
+TYPED_TEST(SelectSupportBatchTest, BatchSelectMethod)
+{
+    bit_vector bvec;
+    ASSERT_TRUE(load_from_file(bvec, test_file));
+    typename TypeParam::bit_vector_type bv(bvec);
+    TypeParam ss(&bv);
+    uint64_t ones = util::cnt_one_bits(bvec);
+    if (ones == 0)
+        return;
+    std::vector<uint64_t> pos(ones), res(ones);
+    std::mt19937_64 rng(17);
+    for (uint64_t j=0; j < ones; ++j) {
+        pos[j] = 1 + rng() % ones;
+    }
+    ss.select(pos.data(), pos.size(), res.data());
+    for (uint64_t j=0; j < ones; ++j) {
+        ASSERT_EQ(ss.select(pos[j]), res[j]);
+    }
+}
+
+template<class T>
+class SelectSupport0BatchTest : public ::testing::Test { };
+
+typedef Types<select_support_mcl<0>,
+        select_support_rrr<0, 15>,
+        select_support_rrr<0, 63>
+        > Batch0Implementations;
+
+TYPED_TEST_CASE(SelectSupport0BatchTest, Batch0Implementations);
+
+//! Test the batch select method for zeros
+TYPED_TEST(SelectSupport0BatchTest, BatchSelectMethod)
+{
+    bit_vector bvec;
+    ASSERT_TRUE(load_from_file(bvec, test_file));
+    typename TypeParam::bit_vector_type bv(bvec);
+    TypeParam ss(&bv);
+    uint64_t zeros = bvec.size() - util::cnt_one_bits(bvec);
+    if (zeros == 0)
+        return;
+    std::vector<uint64_t> pos(zeros), res(zeros);
+    std::mt19937_64 rng(17);
+    for (uint64_t j=0; j < zeros; ++j) {
+        pos[j] = 1 + rng() % zeros;
+    }
+    ss.select(pos.data(), pos.size(), res.data());
+    for (uint64_t j=0, select=0; j < bvec.size(); ++j) {
+        if (!bvec[j]) {
+            ++select;
+            ASSERT_EQ(j, ss.select(select));
+        }
+    }
+    for (uint64_t j=0; j < zeros; ++j) {
+        ASSERT_EQ(ss.select(pos[j]), res[j]);
+    }
+}
+
+//! Test the parallel initialization of select_support_mcl
+TEST(SelectSupportMclTest, InitParallel)
+{
+    bit_vector bvec;
+    ASSERT_TRUE(load_from_file(bvec, test_file));
+    // the parallel initialization is only used for larger vectors
+    bit_vector bv(bvec.size()*(200000/(bvec.size()+1)+1));
+    for (uint64_t j=0; j < bv.size(); ++j) {
+        bv[j] = bvec.size() ? bvec[j%bvec.size()] : 0;
+    }
+    select_support_mcl<1> ss1;
+    select_support_mcl<0> ss0;
+    util::init_support(ss1, &bv, 4);
+    util::init_support(ss0, &bv, 4);
+    for (uint64_t j=0, ones=0, zeros=0; j < bv.size(); ++j) {
+        if (bv[j]) {
+            ASSERT_EQ(j, ss1.select(++ones));
+        } else {
+            ASSERT_EQ(j, ss0.select(++zeros));
+        }
+    }
+}
+
 }// end namespace
 
 int main(int argc, char** argv)
@@ -72,6 +72,8 @@ wt<unsigned char*, rrr_vector<63>>,
 wt<unsigned char*, bit_vector_il<>>,
 wt<unsigned char*, bit_vector>,
 wt_huff<bit_vector_il<>>,
+wt_huff<bit_vector_cl<>>,
+wt_huff<hyb_vector<>>,
 wt_huff<bit_vector, rank_support_v<>>,
 wt_huff<bit_vector, rank_support_v5<>>,
 wt_huff<rrr_vector<63>>,
@@ -344,6 +346,21 @@ TYPED_TEST(WtByteTest, CreatePartiallyTest)
     ::test_rank(wt, text, n);
 }
 
+TYPED_TEST(WtByteTest, CreateParallelTest)
+{
+    TypeParam wt1, wt2;
+    ASSERT_EQ(true, load_from_file(wt1, temp_file));
+    int_vector_buffer<8> text_buf(test_file, std::ios::in, 1024*1024, 8, true);
+    construct_wt(wt2, text_buf, text_buf.size(), 4);
+    int_vector<8> text;
+    ASSERT_EQ(true, load_vector_from_file(text, test_file, 1));
+    ASSERT_EQ(wt1.sigma, wt2.sigma);
+    for (size_type j=0; j<text.size(); ++j) {
+        ASSERT_EQ(wt1[j], wt2[j]);
+    }
+    ::test_rank(wt2, text, text.size());
+}
+
 TYPED_TEST(WtByteTest, DeleteTest)
 {
     sdsl::remove(temp_file);
@@ -29,6 +29,8 @@ wt_huff<bit_vector, rank_support_v<>, select_support_mcl<1>, select_support_mcl<
         ,wt_int<rrr_vector<15> >
         ,wt_int<>
         ,wt_int<rrr_vector<63> >
+        ,wt_int<bit_vector_cl<> >
+        ,wt_int<hyb_vector<> >
         > Implementations;
 
 TYPED_TEST_CASE(WtIntTest, Implementations);
@@ -82,6 +84,52 @@ TYPED_TEST(WtIntTest, LoadAndAccess)
     }
 }
 
+//! Test the multithreaded construction
+TYPED_TEST(WtIntTest, ConstructParallel)
+{
+    TypeParam wt1, wt2;
+    ASSERT_TRUE(load_from_file(wt1, temp_file));
+    int_vector_buffer<> iv_buf(test_file);
+    construct_wt(wt2, iv_buf, iv_buf.size(), 4);
+    ASSERT_EQ(wt1.size(), wt2.size());
+    ASSERT_EQ(wt1.sigma, wt2.sigma);
+    for (size_type j=0; j < wt1.size(); ++j) {
+        ASSERT_EQ(wt1[j], wt2[j])<<j;
+        ASSERT_EQ(wt1.rank(j+1, wt1[j]), wt2.rank(j+1, wt2[j]))<<j;
+    }
+}
+
+//! Test accessing the wavelet tree loaded from a memory mapped file
+TYPED_TEST(WtIntTest, LoadMappedAndAccess)
+{
+    int_vector<> iv;
+    load_from_file(iv, test_file);
+    TypeParam wt;
+    ASSERT_TRUE(load_from_mapped_file(wt, temp_file));
+    ASSERT_EQ(iv.size(), wt.size());
+    for (size_type j=0; j < iv.size(); ++j) {
+        ASSERT_EQ(iv[j], wt[j])<<j;
+        ASSERT_EQ(wt.rank(j, iv[j]) + 1, wt.rank(j+1, iv[j]));
+    }
+}
+
+TYPED_TEST(WtIntTest, LoadIntoArena)
+{
+    int_vector<> iv;
+    load_from_file(iv, test_file);
+    arena_allocator arena(1ULL<<24, true);
+    {
+        mm::allocator_scope scope(&arena);
+        TypeParam wt;
+        ASSERT_TRUE(load_from_file(wt, temp_file));
+        ASSERT_EQ(iv.size(), wt.size());
+        for (size_type j=0; j < iv.size(); ++j) {
+            ASSERT_EQ(iv[j], wt[j])<<j;
+            ASSERT_EQ(wt.rank(j, iv[j]) + 1, wt.rank(j+1, iv[j]));
+        }
+    }
+}
+
 //! Test the load method and rank method
 TYPED_TEST(WtIntTest, LoadAndRank)
 {